@@ -0,0 +1,47 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+// Compile-time benchmark: the build time of this translation unit is that of
+// modular inverses on integer sequences, the Montgomery constants of
+// compile-time moduli of 4, 6 and 8 limbs and full-length inverses modulo
+// them. The operands are given by their limbs, not by _Z literals, whose
+// parsing would dominate.
+
+import std;
+import lam.ctbignum;
+
+template<typename T, T... Modulus, T... X>
+constexpr bool check_inverses(std::integer_sequence<T, Modulus...> m, std::integer_sequence<T, X...> x)
+{
+  using lam::cbn::big_int;
+  constexpr big_int<sizeof...(Modulus), T> modulus{Modulus...};
+  constexpr auto montgomery = lam::cbn::mod_inv(m, std::integer_sequence<T, 0, 1>{}); // m^-1 mod 2^64
+  constexpr auto inverse = lam::cbn::detail::to_length<modulus.size()>(lam::cbn::mod_inv(x, m));
+  return static_cast<T>(montgomery[0] * modulus[0]) == 1 &&
+         lam::cbn::div(lam::cbn::mul(inverse, big_int<sizeof...(X), T>{X...}), modulus).remainder == big_int<1, T>{1};
+}
+
+template<std::uint64_t... Limbs>
+using limbs = std::integer_sequence<std::uint64_t, Limbs...>;
+
+// the primes 2^256 - 189, 2^384 - 317 and 2^512 - 569, and the leading bits
+// of pi below them
+static_assert(check_inverses(
+  limbs<0xffffffffffffff43, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff>{},
+  limbs<0x04177d4c76273644, 0x52049c1114cf98e8, 0x898cc51701b839a2, 0x121fb54442d18469>{}));
+static_assert(check_inverses(limbs<0xfffffffffffffec3, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff,
+                                   0xffffffffffffffff, 0xffffffffffffffff>{},
+                             limbs<0xdf2a33679a748636, 0xa29410f31c6809bb, 0x04177d4c76273644, 0x52049c1114cf98e8,
+                                   0x898cc51701b839a2, 0x121fb54442d18469>{}));
+static_assert(check_inverses(limbs<0xfffffffffffffdc7, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff,
+                                   0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff>{},
+                             limbs<0x9fc26adadaa3848b, 0x605614dbe4be286e, 0xdf2a33679a748636, 0xa29410f31c6809bb,
+                                   0x04177d4c76273644, 0x52049c1114cf98e8, 0x898cc51701b839a2, 0x121fb54442d18469>{}));
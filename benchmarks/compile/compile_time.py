@@ -0,0 +1,252 @@
+#
+# This file is part of
+#
+# CTBignum
+#
+# C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+#
+#
+# This file is distributed under the Apache License, Version 2.0. See the LICENSE
+# file for details.
+
+# Compile-time cost report of the library's compile-time features.
+#
+#   compile_time.py generate <dir> <feature>... --bits <bits>...
+#       writes <dir>/<feature>-<bits>.cpp for every feature and bit length,
+#       and <dir>/baseline.cpp, which only imports the library
+#   compile_time.py measure <json> <compiler id> [--timeout <s>] -- <compiler command>
+#       runs the compiler command (as the compiler launcher of CMake), with
+#       -ftime-report (GCC) or -ftime-trace (Clang), and writes its wall time,
+#       peak memory and time per phase to <json>; a compiler still running
+#       after <s> seconds (default 600) is killed
+#   compile_time.py report <json> <measurement>...
+#       joins the measurements into one report, with the time and memory of
+#       every feature over those of the baseline
+
+import json
+import math
+import os
+import random
+import re
+import signal
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+HEADER = '''//
+// Generated by compile_time.py: {description}
+
+import std;
+import lam.ctbignum;
+
+'''
+
+# the body of each feature, for the odd modulus P and the residue X coprime
+# to it, of L limbs, and the exponent E
+FEATURES = {
+    'literal': ('a decimal _Z literal of {bits} bits',
+                'using namespace lam::cbn::literals;\n'
+                'constexpr auto x = lam::cbn::to_big_int({P_decimal}_Z);\n'),
+    'zq_element': ('ZqElement arithmetic modulo {bits} bits',
+                   'using GF = lam::cbn::ZqElement<std::uint64_t, {P}>;\n'
+                   'constexpr GF x{{std::integer_sequence<std::uint64_t, {X}>{{}}}};\n'
+                   'constexpr auto y = x * x + x - GF(1);\n'),
+    'm_prime': ('precompute_m_prime for a divisor of {bits} bits',
+                'constexpr auto m =\n'
+                '  lam::cbn::detail::precompute_m_prime<{L2}>(std::integer_sequence<std::uint64_t, {P}>{{}});\n'),
+    'mod_inv': ('mod_inv on integer sequences of {bits} bits',
+                'constexpr auto y = lam::cbn::mod_inv(std::integer_sequence<std::uint64_t, {X}>{{}},\n'
+                '                                     std::integer_sequence<std::uint64_t, {P}>{{}});\n'),
+    'mod_exp': ('constexpr mod_exp modulo {bits} bits, to the exponent 65537',
+                'constexpr auto y = lam::cbn::mod_exp(lam::cbn::big_int<{L}>{{{X}}}, lam::cbn::big_int<1>{{{E}}},\n'
+                '                                     std::integer_sequence<std::uint64_t, {P}>{{}});\n'),
+}
+
+
+def limbs(x, n):
+    return ', '.join('0x%016x' % ((x >> (64 * i)) & (2**64 - 1)) for i in range(n))
+
+
+def write_if_changed(path, content):
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == content:
+                return
+    with open(path, 'w') as f:
+        f.write(content)
+
+
+def generate(directory, features, bits_list):
+    os.makedirs(directory, exist_ok=True)
+    write_if_changed(os.path.join(directory, 'baseline.cpp'), HEADER.format(description='the baseline'))
+    for bits in bits_list:
+        # the same operands of a bit length for every feature and run
+        rng = random.Random(bits)
+        p = rng.getrandbits(bits) | (1 << (bits - 1)) | 1
+        x = rng.randrange(2, p)
+        while math.gcd(x, p) != 1:
+            x = rng.randrange(2, p)
+        n = bits // 64
+        values = {'bits': bits, 'L': n, 'L2': 2 * n, 'P': limbs(p, n), 'X': limbs(x, n), 'P_decimal': p,
+                  'E': 65537}
+        for feature in features:
+            description, body = FEATURES[feature]
+            content = HEADER.format(description=description.format(**values)) + body.format(**values)
+            write_if_changed(os.path.join(directory, '%s-%d.cpp' % (feature, bits)), content)
+
+
+def parse_size(s):
+    units = {'k': 2**10, 'M': 2**20, 'G': 2**30}
+    return int(float(s[:-1]) * units[s[-1]]) if s[-1] in units else int(s)
+
+
+# the wall time (s) and GGC memory (bytes) of every timed phase of GCC's
+# -ftime-report, and the rest of stderr
+def parse_time_report(stderr):
+    phases, rest = {}, []
+    pattern = re.compile(r'^\s*\|?(.+?)\s*:\s*[\d.]+\s*\(\s*\d+%\)\s*[\d.]+\s*\(\s*\d+%\)\s*([\d.]+)\s*\(\s*\d+%\)'
+                         r'\s*(\d+[kMG]?)\s*\(\s*\d+%\)')
+    in_report = False
+    for line in stderr.splitlines():
+        m = pattern.match(line)
+        if line.startswith('Time variable'):
+            in_report = True
+        elif m:
+            phases[m.group(1)] = {'wall_seconds': float(m.group(2)), 'ggc_bytes': parse_size(m.group(3))}
+        elif in_report and line.strip().startswith('TOTAL'):
+            in_report = False
+        elif not in_report and line.strip():
+            rest.append(line)
+    return phases, '\n'.join(rest)
+
+
+# the total time (s) of every kind of event in Clang's -ftime-trace
+def parse_time_trace(path):
+    with open(path) as f:
+        events = json.load(f)['traceEvents']
+    return {e['name'][len('Total '):]: {'wall_seconds': e['dur'] / 1e6}
+            for e in events if e.get('name', '').startswith('Total ')}
+
+
+def measure(output, compiler_id, command, timeout=600.0):
+    # the dependency scan of modules (GCC) is not measured
+    if '-E' in command or '-c' not in command:
+        sys.exit(subprocess.call(command))
+
+    gnu = compiler_id == 'GNU'
+    command = command + (['-ftime-report'] if gnu else ['-ftime-trace'])
+    with tempfile.TemporaryFile(mode='w+') as stderr:
+        start = time.perf_counter()
+        # in a process group of its own, so that a timeout also kills the compiler proper (e.g. cc1plus)
+        process = subprocess.Popen(command, stderr=stderr, start_new_session=True)
+        timed_out = threading.Event()
+
+        def kill():
+            timed_out.set()
+            try:
+                os.killpg(process.pid, signal.SIGKILL)
+            except ProcessLookupError:
+                pass
+
+        timer = threading.Timer(timeout, kill)
+        timer.start()
+        try:
+            _, status, usage = os.wait4(process.pid, 0) # the usage of the compiler and its descendants
+        except KeyboardInterrupt:
+            os.killpg(process.pid, signal.SIGKILL)
+            raise
+        finally:
+            timer.cancel()
+        wall = time.perf_counter() - start
+        stderr.seek(0)
+        messages = stderr.read()
+
+    code = os.waitstatus_to_exitcode(status)
+    phases = {}
+    if gnu:
+        phases, messages = parse_time_report(messages)
+    else:
+        object_file = command[command.index('-o') + 1]
+        trace = os.path.splitext(object_file)[0] + '.json'
+        if code == 0 and os.path.exists(trace):
+            phases = parse_time_trace(trace)
+    if timed_out.is_set():
+        messages = 'killed after %g s' % timeout
+    elif code != 0:
+        # a unit that fails (e.g. by the limits of constant evaluation, or of
+        # memory) is reported as such, and the others still run
+        messages = '\n'.join(line[:400] for line in messages.splitlines() if 'error' in line)
+    sys.stderr.write(messages + ('\n' if messages else ''))
+
+    source = next(arg for arg in reversed(command) if arg.endswith('.cpp'))
+    status = 'timeout' if timed_out.is_set() else 'ok' if code == 0 else 'failed'
+    result = {'source': os.path.basename(source), 'compiler': compiler_id, 'status': status,
+              'exit_code': code, 'wall_seconds': round(wall, 3), 'user_seconds': round(usage.ru_utime, 3),
+              'system_seconds': round(usage.ru_stime, 3), 'peak_rss_bytes': usage.ru_maxrss * 1024, 'phases': phases}
+    with open(output, 'w') as f:
+        json.dump(result, f, indent=2)
+
+
+def report(output, measurements):
+    results = []
+    for path in measurements:
+        if not os.path.exists(path): # the compiler was killed
+            results.append({'source': os.path.basename(path)[:-len('.json')] + '.cpp', 'status': 'missing'})
+            continue
+        with open(path) as f:
+            results.append(json.load(f))
+    baseline = next((r for r in results if r['source'] == 'baseline.cpp'), None)
+
+    features = {}
+    for r in results:
+        name = os.path.splitext(r['source'])[0]
+        if r is baseline or '-' not in name:
+            continue
+        feature, bits = name.rsplit('-', 1)
+        entry = {k: r[k] for k in ('status', 'wall_seconds', 'user_seconds', 'system_seconds', 'peak_rss_bytes',
+                                   'phases') if k in r}
+        if baseline and r['status'] == 'ok' and baseline['status'] == 'ok':
+            entry['wall_seconds_over_baseline'] = round(r['wall_seconds'] - baseline['wall_seconds'], 3)
+            entry['peak_rss_bytes_over_baseline'] = r['peak_rss_bytes'] - baseline['peak_rss_bytes']
+        features.setdefault(feature, {})[bits] = entry
+    for feature in features:
+        features[feature] = dict(sorted(features[feature].items(), key=lambda item: int(item[0])))
+
+    compilers = [r['compiler'] for r in results if 'compiler' in r]
+    content = {'compiler': compilers[0] if compilers else None,
+               'baseline': {k: baseline[k] for k in ('status', 'wall_seconds', 'peak_rss_bytes') if k in baseline}
+                           if baseline else None,
+               'features': features}
+    with open(output, 'w') as f:
+        json.dump(content, f, indent=2)
+
+    # a summary table: wall time (s) and peak memory (MB) per feature and bit length
+    def cell(bits, e):
+        if e['status'] != 'ok':
+            return '  %5s: %17s' % (bits, e['status'])
+        return '  %5s: %7.2fs %6d MB' % (bits, e['wall_seconds'], e['peak_rss_bytes'] >> 20)
+
+    for feature, entries in sorted(features.items()):
+        print('%-12s' % feature + ''.join(cell(bits, e) for bits, e in entries.items()))
+    print('report written to ' + output)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        print('Usage: compile_time.py generate|measure|report ...')
+        sys.exit(1)
+    mode, args = sys.argv[1], sys.argv[2:]
+    if mode == 'generate':
+        i = args.index('--bits')
+        generate(args[0], args[1:i], [int(b) for b in args[i + 1:]])
+    elif mode == 'measure':
+        i = args.index('--')
+        options = args[2:i]
+        timeout = float(options[options.index('--timeout') + 1]) if '--timeout' in options else 600.0
+        measure(args[0], args[1], args[i + 1:], timeout)
+    elif mode == 'report':
+        report(args[0], args[1:])
+    else:
+        sys.exit('unknown mode ' + mode)
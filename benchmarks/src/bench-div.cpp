@@ -0,0 +1,180 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+template<std::size_t N>
+static std::vector<lam::cbn::big_int<N>> random_integers(std::size_t n, unsigned seed)
+{
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<lam::cbn::big_int<N>> v(n);
+  for (auto& x : v)
+    for (auto& limb : x)
+      limb = distribution(generator);
+  return v;
+}
+
+// 256-bit numerators by a 130-bit divisor: Knuth's algorithm D, the divisor
+// fixed at compile time, and the runtime invariant_divider
+constexpr auto divisor = 1361129467683753853853498429727072845823_Z;
+
+static void div_runtime(benchmark::State& state)
+{
+  const auto n = random_integers<4>(1024, 1);
+  const auto d = lam::cbn::detail::to_length<4>(lam::cbn::to_big_int(divisor));
+  std::vector<lam::cbn::big_int<4>> q(n.size());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n.size(); ++i)
+      q[i] = lam::cbn::div(n[i], d).quotient;
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+// the algorithm of the constant evaluation (bitwise normalization, hardware
+// division per quotient limb), at runtime
+static void div_hardware(benchmark::State& state)
+{
+  const auto n = random_integers<4>(1024, 1);
+  const auto d = lam::cbn::detail::to_length<4>(lam::cbn::to_big_int(divisor));
+  std::vector<lam::cbn::big_int<4>> q(n.size());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n.size(); ++i)
+      q[i] = lam::cbn::detail::div_hw(n[i], d).quotient;
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+// 1024-bit by 512-bit, and by a single limb
+template<bool Reciprocal>
+static void div_long(benchmark::State& state)
+{
+  const auto n = random_integers<16>(256, 1);
+  const auto d = random_integers<8>(1, 2)[0];
+  std::vector<lam::cbn::big_int<16>> q(n.size());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n.size(); ++i)
+      q[i] = Reciprocal ? lam::cbn::div(n[i], d).quotient : lam::cbn::detail::div_hw(n[i], d).quotient;
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+template<bool Reciprocal>
+static void short_div(benchmark::State& state)
+{
+  const auto n = random_integers<16>(256, 1);
+  const std::uint64_t d = 0x2f0f9b9ee3c01;
+  std::vector<lam::cbn::big_int<16>> q(n.size());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n.size(); ++i)
+      q[i] = Reciprocal ? lam::cbn::short_div(n[i], d).quotient : lam::cbn::detail::short_div_hw(n[i], d).quotient;
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+static void div_compile_time(benchmark::State& state)
+{
+  const auto n = random_integers<4>(1024, 1);
+  std::vector<lam::cbn::big_int<4>> q(n.size());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n.size(); ++i)
+      q[i] = lam::cbn::quotient(n[i], divisor);
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+static void div_invariant_divider(benchmark::State& state)
+{
+  const auto n = random_integers<4>(1024, 1);
+  const lam::cbn::invariant_divider<4> divider(lam::cbn::detail::to_length<4>(lam::cbn::to_big_int(divisor)));
+  std::vector<lam::cbn::big_int<4>> q(n.size());
+
+  for (auto _ : state)
+  {
+    divider.quotient(n, q);
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+// exact divisions of 1024-bit multiples of a 512-bit divisor and of 3: div,
+// divexact with the inverse at runtime and at compile time, divexact_by_limb
+template<int Method>
+static void div_exact(benchmark::State& state)
+{
+  const auto d = random_integers<8>(1, 2)[0];
+  std::vector<lam::cbn::big_int<16>> n;
+  for (const auto& x : random_integers<8>(256, 1))
+    n.push_back(Method < 2 ? lam::cbn::mul(x, d) : lam::cbn::detail::to_length<16>(lam::cbn::mul(x, lam::cbn::big_int<1>{3})));
+  std::vector<lam::cbn::big_int<16>> q(n.size());
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n.size(); ++i)
+    {
+      if constexpr (Method == 0)
+        q[i] = lam::cbn::div(n[i], d).quotient;
+      else if constexpr (Method == 1)
+        q[i] = lam::cbn::divexact(n[i], d);
+      else if constexpr (Method == 2)
+        q[i] = lam::cbn::short_div(n[i], std::uint64_t{3}).quotient;
+      else if constexpr (Method == 3)
+        q[i] = lam::cbn::divexact(n[i], 3_Z);
+      else
+        q[i] = lam::cbn::divexact_by_limb(n[i], std::uint64_t{3});
+    }
+    benchmark::DoNotOptimize(q.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n.size());
+}
+
+BENCHMARK(div_runtime);
+BENCHMARK(div_hardware);
+BENCHMARK(div_compile_time);
+BENCHMARK(div_invariant_divider);
+BENCHMARK_TEMPLATE(div_long, true);
+BENCHMARK_TEMPLATE(div_long, false);
+BENCHMARK_TEMPLATE(short_div, true);
+BENCHMARK_TEMPLATE(short_div, false);
+BENCHMARK_TEMPLATE(div_exact, 0);
+BENCHMARK_TEMPLATE(div_exact, 1);
+BENCHMARK_TEMPLATE(div_exact, 2);
+BENCHMARK_TEMPLATE(div_exact, 3);
+BENCHMARK_TEMPLATE(div_exact, 4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,103 @@
+//
+// Division scaling benchmark for ctbignum
+//
+
+#include <gmp.h>
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn;
+
+// M-limb dividends and N-limb divisors with the top bit set
+template<size_t M, size_t N>
+static std::vector<uint64_t> random_operands()
+{
+  std::vector<uint64_t> data((M + N) * 1000);
+  std::default_random_engine generator;
+  std::uniform_int_distribution<uint64_t> distribution(0);
+  for (auto& limb : data)
+    limb = distribution(generator);
+  for (size_t i = 0; i < data.size(); i += M + N)
+    data[i + M + N - 1] |= uint64_t{1} << 63;
+  return data;
+}
+
+// GMP Comparison
+template<size_t M, size_t N>
+static void div_gmp(benchmark::State& state)
+{
+  const auto data = random_operands<M, N>();
+  size_t i = 0;
+  // Assumption: mp_limb_t is uint64_t compatible on this platform
+  auto base_ptr = reinterpret_cast<const mp_limb_t*>(data.data());
+  mp_limb_t q[M - N + 1], r[N];
+
+  for (auto _ : state)
+  {
+    mpn_tdiv_qr(q, r, 0, base_ptr + i, M, base_ptr + i + M, N);
+    benchmark::DoNotOptimize(q);
+    benchmark::DoNotOptimize(r);
+
+    i += M + N;
+    if (i == data.size())
+      i = 0;
+  }
+}
+
+// ctbignum, and the schoolbook division it replaces above the threshold
+template<size_t M, size_t N, bool Recursive>
+static void div_cbn(benchmark::State& state)
+{
+  const auto data = random_operands<M, N>();
+  size_t i = 0;
+  auto base_ptr = data.data();
+
+  for (auto _ : state)
+  {
+    auto u = reinterpret_cast<const big_int<M>*>(base_ptr + i);
+    auto v = reinterpret_cast<const big_int<N>*>(base_ptr + i + M);
+    if constexpr (Recursive)
+    {
+      auto j = div(*u, *v);
+      benchmark::DoNotOptimize(j);
+    }
+    else
+    {
+      auto j = detail::div_hw(*u, *v);
+      benchmark::DoNotOptimize(j);
+    }
+
+    i += M + N;
+    if (i == data.size())
+      i = 0;
+  }
+}
+
+// 2048 / 1024 bits
+BENCHMARK_TEMPLATE(div_cbn, 32, 16, true);
+BENCHMARK_TEMPLATE(div_cbn, 32, 16, false);
+BENCHMARK_TEMPLATE(div_gmp, 32, 16);
+
+// 4096 / 2048 bits
+BENCHMARK_TEMPLATE(div_cbn, 64, 32, true);
+BENCHMARK_TEMPLATE(div_cbn, 64, 32, false);
+BENCHMARK_TEMPLATE(div_gmp, 64, 32);
+
+// 8192 / 4096 bits
+BENCHMARK_TEMPLATE(div_cbn, 128, 64, true);
+BENCHMARK_TEMPLATE(div_cbn, 128, 64, false);
+BENCHMARK_TEMPLATE(div_gmp, 128, 64);
+
+// 8192 / 2048 bits
+BENCHMARK_TEMPLATE(div_cbn, 128, 32, true);
+BENCHMARK_TEMPLATE(div_cbn, 128, 32, false);
+BENCHMARK_TEMPLATE(div_gmp, 128, 32);
+
+// 16384 / 8192 bits
+BENCHMARK_TEMPLATE(div_cbn, 256, 128, true);
+BENCHMARK_TEMPLATE(div_cbn, 256, 128, false);
+BENCHMARK_TEMPLATE(div_gmp, 256, 128);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using Kyber = lam::cbn::packed_zq<std::int16_t, 3329>;
+using Dilithium = lam::cbn::packed_zq<std::int32_t, 8380417>;
+
+constexpr std::size_t degree = 256;
+
+template<typename Packed>
+static std::vector<typename Packed::lane_type> random_lanes(std::size_t n, unsigned seed)
+{
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<int> distribution(0, Packed::q - 1);
+  std::vector<typename Packed::lane_type> v(n);
+  for (auto& x : v)
+    x = static_cast<typename Packed::lane_type>(distribution(generator));
+  return v;
+}
+
+// A * s for a rows x cols matrix of degree-256 polynomials in the NTT domain
+// (Kyber-768: 3 x 3, Dilithium3: 6 x 5)
+template<typename Packed>
+static void matrix_vector_packed(benchmark::State& state)
+{
+  const auto rows = static_cast<std::size_t>(state.range(0));
+  const auto cols = static_cast<std::size_t>(state.range(1));
+  auto matrix = random_lanes<Packed>(rows * cols * degree, 1);
+  auto vector = random_lanes<Packed>(cols * degree, 2);
+  std::vector<typename Packed::lane_type> out(rows * degree);
+
+  for (auto _ : state)
+  {
+    Packed::matrix_vector_montgomery(out, matrix, vector, degree);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * rows * cols * degree);
+}
+
+// the same product with one ZqElement per coefficient
+template<typename Packed>
+static void matrix_vector_zq(benchmark::State& state)
+{
+  using GF = lam::cbn::ZqElement<std::uint32_t, static_cast<std::uint32_t>(Packed::q)>;
+  const auto rows = static_cast<std::size_t>(state.range(0));
+  const auto cols = static_cast<std::size_t>(state.range(1));
+  auto to_field = [](const auto& lanes) {
+    std::vector<GF> v;
+    for (auto x : lanes)
+      v.push_back(GF{static_cast<std::uint32_t>(x)});
+    return v;
+  };
+  auto matrix = to_field(random_lanes<Packed>(rows * cols * degree, 1));
+  auto vector = to_field(random_lanes<Packed>(cols * degree, 2));
+  std::vector<GF> out(rows * degree);
+
+  for (auto _ : state)
+  {
+    for (std::size_t r = 0; r < rows; ++r)
+      for (std::size_t i = 0; i < degree; ++i)
+      {
+        GF acc{};
+        for (std::size_t c = 0; c < cols; ++c)
+          acc += matrix[(r * cols + c) * degree + i] * vector[c * degree + i];
+        out[r * degree + i] = acc;
+      }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * rows * cols * degree);
+}
+
+// compression of a Kyber-768 ciphertext vector (d = 10) and back
+static void compress_kyber(benchmark::State& state)
+{
+  auto x = random_lanes<Kyber>(3 * degree, 3);
+  std::vector<std::uint16_t> y(x.size());
+
+  for (auto _ : state)
+  {
+    Kyber::compress<10>(y, x);
+    Kyber::decompress<10>(x, y);
+    benchmark::DoNotOptimize(x.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+BENCHMARK_TEMPLATE(matrix_vector_packed, Kyber)->Args({3, 3});
+BENCHMARK_TEMPLATE(matrix_vector_zq, Kyber)->Args({3, 3});
+BENCHMARK_TEMPLATE(matrix_vector_packed, Dilithium)->Args({6, 5});
+BENCHMARK_TEMPLATE(matrix_vector_zq, Dilithium)->Args({6, 5});
+BENCHMARK(compress_kyber);
+
+BENCHMARK_MAIN();
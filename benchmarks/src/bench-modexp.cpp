@@ -75,7 +75,144 @@ static void modexp_cbn(benchmark::State& state)
   }
 }
 
+// independent exponentiations with one modulus and full-size exponents:
+// a loop over the scalar mod_exp, and mod_exp_batch interleaving Lanes of them
+template<size_t Len, typename T>
+static std::vector<lam::cbn::big_int<Len, T>> random_residues(std::size_t n, const lam::cbn::big_int<Len, T>& m,
+                                                              unsigned seed)
+{
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<uint64_t> distribution(0);
+  std::vector<lam::cbn::big_int<Len, T>> v(n);
+  for (auto& x : v)
+  {
+    for (auto& limb : x)
+      limb = static_cast<T>(distribution(generator));
+    x[Len - 1] %= m[Len - 1]; // below m
+  }
+  return v;
+}
+
+template<size_t Len, typename T>
+static lam::cbn::big_int<Len, T> odd_modulus()
+{
+  lam::cbn::big_int<Len, T> m;
+  for (auto& limb : m)
+    limb = static_cast<T>(0x9e3779b97f4a7c15);
+  m[0] |= 1;
+  return m;
+}
+
+// Lanes = 1: the scalar loop
+template<size_t Len, typename T, size_t Lanes>
+static void modexp_batch(benchmark::State& state)
+{
+  using namespace lam::cbn;
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto m = odd_modulus<Len, T>();
+  const montgomery_context<Len, T> ctx(m);
+  const auto bases = random_residues(n, m, 1), exps = random_residues(n, m, 2);
+  std::vector<big_int<Len, T>> out(n);
+
+  for (auto _ : state)
+  {
+    if constexpr (Lanes == 1)
+      for (std::size_t i = 0; i < n; ++i)
+        out[i] = mod_exp(bases[i], exps[i], ctx);
+    else
+      mod_exp_batch<Lanes>(out, bases, std::span{exps}, ctx);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// a fixed base with full-size exponents: the precomputed table against mod_exp
+template<size_t Len, size_t W>
+static void modexp_fixed_base(benchmark::State& state)
+{
+  using namespace lam::cbn;
+  const auto m = odd_modulus<Len, uint64_t>();
+  const montgomery_context<Len> ctx(m);
+  const auto g = random_residues(1, m, 1)[0];
+  const auto exps = random_residues(64, m, 2);
+  const auto power = [&] {
+    if constexpr (W == 0)
+      return [&](const big_int<Len>& e) { return mod_exp(g, e, ctx); };
+    else // the table takes up to 1.4 MB
+      return [table = std::make_unique<fixed_base_exp<Len, uint64_t, Len * 64, W>>(g, ctx)](const big_int<Len>& e) {
+        return (*table)(e);
+      };
+  }();
+
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    auto r = power(exps[i]);
+    benchmark::DoNotOptimize(r);
+    i = (i + 1) % exps.size();
+  }
+}
+
+// prod_i g_i^e_i for k = range(0) terms: multi_exp (with a thread_pool of
+// range(1) threads), and k calls of mod_exp with the products
+static void multi_exp_products(benchmark::State& state)
+{
+  using namespace lam::cbn;
+  const auto k = static_cast<std::size_t>(state.range(0));
+  const auto m = odd_modulus<4, uint64_t>();
+  const montgomery_context<4> ctx(m);
+  const auto bases = random_residues(k, m, 1), exps = random_residues(k, m, 2);
+  thread_pool pool(static_cast<std::size_t>(std::max<std::int64_t>(state.range(1), 1)));
+
+  for (auto _ : state)
+  {
+    big_int<4> r;
+    if (state.range(1) == 0)
+    {
+      r = ctx.one;
+      for (std::size_t i = 0; i < k; ++i)
+        r = ctx.mul(r, mod_exp(bases[i], exps[i], ctx));
+    }
+    else
+      r = multi_exp(bases, std::span{exps}, ctx, pool);
+    benchmark::DoNotOptimize(r);
+  }
+  state.SetItemsProcessed(state.iterations() * k);
+}
+
 BENCHMARK(modexp_ntl);
 BENCHMARK_TEMPLATE(modexp_cbn, 4);
 
+BENCHMARK_TEMPLATE(modexp_batch, 4, uint64_t, 1)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 4, uint64_t, 2)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 4, uint64_t, 4)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 4, uint64_t, 8)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 16, uint64_t, 1)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 16, uint64_t, 2)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 16, uint64_t, 4)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 16, uint64_t, 8)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 8, uint32_t, 1)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 8, uint32_t, 2)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 8, uint32_t, 4)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 8, uint32_t, 8)->Arg(64);
+BENCHMARK_TEMPLATE(modexp_batch, 32, uint32_t, 1)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 32, uint32_t, 2)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 32, uint32_t, 4)->Arg(16);
+BENCHMARK_TEMPLATE(modexp_batch, 32, uint32_t, 8)->Arg(16);
+
+// W = 0: mod_exp
+BENCHMARK_TEMPLATE(modexp_fixed_base, 4, 0);
+BENCHMARK_TEMPLATE(modexp_fixed_base, 4, 4);
+BENCHMARK_TEMPLATE(modexp_fixed_base, 4, 6);
+BENCHMARK_TEMPLATE(modexp_fixed_base, 16, 0);
+BENCHMARK_TEMPLATE(modexp_fixed_base, 16, 4);
+BENCHMARK_TEMPLATE(modexp_fixed_base, 16, 6);
+
+// range(1) = 0: the loop over mod_exp
+BENCHMARK(multi_exp_products)->Args({4, 0})->Args({4, 1})->Args({4, 4});
+BENCHMARK(multi_exp_products)->Args({64, 0})->Args({64, 1})->Args({64, 4});
+BENCHMARK(multi_exp_products)->Args({1024, 0})->Args({1024, 1})->Args({1024, 4});
+BENCHMARK(multi_exp_products)->Args({16384, 0})->Args({16384, 1})->Args({16384, 4});
+
 BENCHMARK_MAIN();
@@ -9,6 +9,7 @@
 // This file is distributed under the Apache License, Version 2.0. See the LICENSE
 // file for details.
 
+#include <gmp.h>
 #include <benchmark/benchmark.h>
 
 import std;
@@ -97,6 +98,77 @@ void modinv_cbn(benchmark::State& state, lam::cbn::big_int<N, T> const& prime)
   }
 }
 
+// random operands of Len limbs with the top bit set, the second one even
+template<std::size_t Len>
+static std::vector<lam::cbn::big_int<Len>> random_operands(std::size_t n)
+{
+  std::mt19937_64 generator(Len);
+  std::vector<lam::cbn::big_int<Len>> v(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    for (auto& limb : v[i])
+      limb = generator();
+    v[i][Len - 1] |= std::uint64_t{1} << 63;
+    if (i % 2 != 0)
+      v[i][0] &= ~std::uint64_t{1};
+  }
+  return v;
+}
+
+// the runtime extended GCD (Lehmer), and the inverse modulo an even number
+template<std::size_t Len, bool Inverse>
+static void ext_gcd(benchmark::State& state)
+{
+  auto v = random_operands<Len>(1024);
+  if constexpr (Inverse)
+  { // only pairs with an inverse: v[i] redrawn until coprime to the even v[i + 1]
+    std::mt19937_64 generator(Len + 1);
+    for (std::size_t i = 0; i < v.size(); i += 2)
+      for (v[i][0] |= 1; lam::cbn::gcd(v[i], v[i + 1]) != lam::cbn::big_int<Len>{1}; v[i][0] |= 1)
+      {
+        for (auto& limb : v[i])
+          limb = generator();
+        v[i][Len - 1] |= std::uint64_t{1} << 63;
+      }
+  }
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    const auto& a = v[i % v.size()];
+    const auto& b = v[(i + 1) % v.size()];
+    i += 2;
+    if constexpr (Inverse)
+      benchmark::DoNotOptimize(lam::cbn::mod_inv(a, b));
+    else
+      benchmark::DoNotOptimize(lam::cbn::ext_gcd(a, b));
+  }
+}
+
+// GMP Comparison: mpz_gcdext
+template<std::size_t Len>
+static void ext_gcd_gmp(benchmark::State& state)
+{
+  const auto v = random_operands<Len>(1024);
+  std::vector<mpz_t> z(v.size());
+  for (std::size_t i = 0; i < z.size(); ++i)
+  {
+    mpz_init(z[i]);
+    mpz_import(z[i], Len, -1, sizeof(std::uint64_t), 0, 0, v[i].data());
+  }
+  mpz_t g, s, t;
+  mpz_inits(g, s, t, nullptr);
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    mpz_gcdext(g, s, t, z[i % z.size()], z[(i + 1) % z.size()]);
+    benchmark::DoNotOptimize(g);
+    i += 2;
+  }
+  mpz_clears(g, s, t, nullptr);
+  for (auto& x : z)
+    mpz_clear(x);
+}
+
 // Registers a benchmark named "BM_takes_args/int_string_test" that passes
 // the specified values to `extra_args`.
 BENCHMARK_CAPTURE(
@@ -106,4 +178,13 @@ BENCHMARK_CAPTURE(
   modinv_cbn, cbn_modular_inverse,
   lam::cbn::to_big_int(115792089237316195423570985008687907853269984665640564039457584007908834671663_Z));
 
+BENCHMARK_TEMPLATE(ext_gcd, 4, false);
+BENCHMARK_TEMPLATE(ext_gcd_gmp, 4);
+BENCHMARK_TEMPLATE(ext_gcd, 4, true);
+BENCHMARK_TEMPLATE(ext_gcd, 16, false);
+BENCHMARK_TEMPLATE(ext_gcd_gmp, 16);
+BENCHMARK_TEMPLATE(ext_gcd, 16, true);
+BENCHMARK_TEMPLATE(ext_gcd, 32, false);
+BENCHMARK_TEMPLATE(ext_gcd_gmp, 32);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+using KyberField = lam::cbn::ZqElement<std::uint32_t, 3329>;
+using Field50 = decltype(lam::cbn::Zq(1125899906842597_Z)); // 2^50 - 27
+
+template<typename Zq>
+static std::vector<Zq> random_vector(std::size_t n, unsigned seed)
+{
+  using T = typename Zq::value_type;
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<Zq> v(n);
+  for (auto& x : v)
+    x = Zq{lam::cbn::big_int<1, T>{static_cast<T>(distribution(generator))}};
+  return v;
+}
+
+// span kernel (AVX2/FMA when compiled with LAM_CTBIGNUM_NativeArch)
+template<typename Zq>
+static void mulmod_fma(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    lam::cbn::mulmod(std::span{c}, a, b);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// element-wise ZqElement::operator*
+template<typename Zq>
+static void mulmod_operator(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      c[i] = a[i] * b[i];
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// the length-one barrett_reduction specialization (x[0] % Modulus);
+// the product of two Kyber residues fits in a single 32-bit limb
+static void mulmod_barrett_kyber(benchmark::State& state)
+{
+  using namespace lam::cbn;
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<KyberField>(n, 1);
+  auto b = random_vector<KyberField>(n, 2);
+  std::vector<KyberField> c(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      auto prod = big_int<1, std::uint32_t>{a[i].data[0] * b[i].data[0]};
+      c[i] = KyberField{barrett_reduction(prod, std::integer_sequence<std::uint32_t, 3329>{})};
+    }
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(mulmod_fma, KyberField)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(mulmod_operator, KyberField)->Arg(256)->Arg(4096);
+BENCHMARK(mulmod_barrett_kyber)->Arg(256)->Arg(4096);
+
+BENCHMARK_TEMPLATE(mulmod_fma, Field50)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(mulmod_operator, Field50)->Arg(256)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,136 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+using Field998 = lam::cbn::ZqElement<std::uint32_t, 998244353>;
+using Goldilocks = decltype(lam::cbn::Zq(18446744069414584321_Z)); // 2^64 - 2^32 + 1
+using BLS12_381_Fr = decltype(lam::cbn::Zq(
+  52435875175126190479447740508185965837690552500527637822603658699938581184513_Z)); // four limbs
+
+template<typename Zq>
+static std::vector<Zq> random_vector(std::size_t n, unsigned seed)
+{
+  using T = typename Zq::value_type;
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<Zq> v(n);
+  for (auto& x : v)
+  {
+    lam::cbn::big_int<sizeof(Zq) / sizeof(T), T> limbs;
+    for (auto& limb : limbs)
+      limb = static_cast<T>(distribution(generator));
+    x = Zq{limbs};
+  }
+  return v;
+}
+
+// forward transform of length n with a precomputed plan
+template<typename Zq>
+static void ntt_forward(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const lam::cbn::ntt_plan<Zq> plan(std::countr_zero(n));
+  auto a = random_vector<Zq>(n, 1);
+
+  for (auto _ : state)
+  {
+    plan.forward(a);
+    benchmark::DoNotOptimize(a.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// four-step transform of length 2^range(0) on range(1) threads
+template<typename Zq>
+static void ntt_four_step(benchmark::State& state)
+{
+  const auto log_n = static_cast<std::size_t>(state.range(0));
+  const lam::cbn::four_step_ntt_plan<Zq> plan(log_n);
+  lam::cbn::thread_pool pool(static_cast<std::size_t>(state.range(1)));
+  auto a = random_vector<Zq>(plan.size(), 1);
+
+  for (auto _ : state)
+  {
+    plan.forward(a, pool);
+    benchmark::DoNotOptimize(a.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * plan.size());
+}
+
+// log sizes 16, 18, ..., 22 on 1, 2, 4, ... up to all hardware threads
+static void thread_scaling(benchmark::internal::Benchmark* b)
+{
+  const auto cores = static_cast<long>(std::max(1u, std::thread::hardware_concurrency()));
+  for (long log_n = 16; log_n <= 22; log_n += 2)
+  {
+    for (long threads = 1; threads < cores; threads *= 2)
+      b->Args({log_n, threads});
+    b->Args({log_n, cores});
+  }
+}
+
+// product of two polynomials with n coefficients each (plan construction included)
+template<typename Zq>
+static void polymul_ntt(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+
+  for (auto _ : state)
+  {
+    auto c = lam::cbn::ntt_multiply(a, b);
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template<typename Zq>
+static void polymul_schoolbook(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+
+  for (auto _ : state)
+  {
+    std::vector<Zq> c(2 * n - 1);
+    for (std::size_t i = 0; i < n; ++i)
+      for (std::size_t j = 0; j < n; ++j)
+        c[i + j] += a[i] * b[j];
+    benchmark::DoNotOptimize(c.data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_TEMPLATE(ntt_forward, Field998)->RangeMultiplier(4)->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(ntt_forward, Goldilocks)->RangeMultiplier(4)->Range(256, 1 << 20);
+BENCHMARK_TEMPLATE(ntt_forward, BLS12_381_Fr)->RangeMultiplier(4)->Range(1 << 16, 1 << 22)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(ntt_four_step, BLS12_381_Fr)->Apply(thread_scaling)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(ntt_four_step, Goldilocks)->Apply(thread_scaling)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(polymul_ntt, Field998)->RangeMultiplier(4)->Range(256, 1 << 20)->Complexity(benchmark::oNLogN);
+BENCHMARK_TEMPLATE(polymul_ntt, Goldilocks)->RangeMultiplier(4)->Range(256, 1 << 20)->Complexity(benchmark::oNLogN);
+
+// quadratic: sizes beyond 2^14 take minutes per iteration
+BENCHMARK_TEMPLATE(polymul_schoolbook, Field998)->RangeMultiplier(4)->Range(256, 1 << 14)->Complexity(benchmark::oNSquared);
+BENCHMARK_TEMPLATE(polymul_schoolbook, Goldilocks)->RangeMultiplier(4)->Range(256, 1 << 14)->Complexity(benchmark::oNSquared);
+
+BENCHMARK_MAIN();
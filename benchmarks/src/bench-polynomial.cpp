@@ -0,0 +1,131 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+using Field998 = lam::cbn::ZqElement<std::uint32_t, 998244353>;   // NTT-friendly
+using Field1e9 = lam::cbn::ZqElement<std::uint32_t, 1000000007>;  // Karatsuba only
+using Goldilocks = decltype(lam::cbn::Zq(18446744069414584321_Z)); // 2^64 - 2^32 + 1
+
+template<typename Zq>
+static std::vector<Zq> random_vector(std::size_t n, unsigned seed)
+{
+  using T = typename Zq::value_type;
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<Zq> v(n);
+  for (auto& x : v)
+  {
+    lam::cbn::big_int<sizeof(Zq) / sizeof(T), T> limbs;
+    for (auto& limb : limbs)
+      limb = static_cast<T>(distribution(generator));
+    x = Zq{limbs};
+  }
+  return v;
+}
+
+// product of two polynomials with n coefficients each
+template<typename Zq>
+static void polynomial_mul(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const lam::cbn::polynomial<Zq> a{random_vector<Zq>(n, 1)}, b{random_vector<Zq>(n, 2)};
+
+  for (auto _ : state)
+  {
+    auto c = a * b;
+    benchmark::DoNotOptimize(c.coefficients().data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// 2n coefficients divided by n coefficients
+template<typename Zq>
+static void polynomial_div(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const lam::cbn::polynomial<Zq> a{random_vector<Zq>(2 * n, 1)}, b{random_vector<Zq>(n, 2)};
+
+  for (auto _ : state)
+  {
+    auto r = div(a, b);
+    benchmark::DoNotOptimize(r.remainder.coefficients().data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// degree n - 1 at n points: Horner at each point, and the subproduct tree
+template<typename Zq>
+static void evaluate_horner(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const lam::cbn::polynomial<Zq> f{random_vector<Zq>(n, 1)};
+  const auto x = random_vector<Zq>(n, 2);
+  std::vector<Zq> values(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      values[i] = f(x[i]);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template<typename Zq>
+static void evaluate_multipoint(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const lam::cbn::polynomial<Zq> f{random_vector<Zq>(n, 1)};
+  const auto x = random_vector<Zq>(n, 2);
+
+  for (auto _ : state)
+  {
+    auto values = f.evaluate(x);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+template<typename Zq>
+static void interpolate(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<Zq> x(n); // distinct points
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] = Zq(static_cast<long>(i) + 1);
+  const auto y = random_vector<Zq>(n, 2);
+
+  for (auto _ : state)
+  {
+    auto f = lam::cbn::polynomial<Zq>::interpolate(x, y);
+    benchmark::DoNotOptimize(f.coefficients().data());
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_TEMPLATE(polynomial_mul, Field998)->RangeMultiplier(2)->Range(16, 1 << 16)->Complexity();
+BENCHMARK_TEMPLATE(polynomial_mul, Field1e9)->RangeMultiplier(2)->Range(16, 1 << 14)->Complexity();
+BENCHMARK_TEMPLATE(polynomial_mul, Goldilocks)->RangeMultiplier(2)->Range(16, 1 << 16)->Complexity();
+
+BENCHMARK_TEMPLATE(polynomial_div, Field998)->RangeMultiplier(2)->Range(16, 1 << 14)->Complexity();
+BENCHMARK_TEMPLATE(polynomial_div, Goldilocks)->RangeMultiplier(2)->Range(16, 1 << 14)->Complexity();
+
+BENCHMARK_TEMPLATE(evaluate_horner, Field998)->RangeMultiplier(4)->Range(64, 1 << 14)->Complexity(benchmark::oNSquared);
+BENCHMARK_TEMPLATE(evaluate_multipoint, Field998)->RangeMultiplier(4)->Range(64, 1 << 14)->Complexity();
+BENCHMARK_TEMPLATE(interpolate, Field998)->RangeMultiplier(4)->Range(64, 1 << 14)->Complexity();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <gmp.h>
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+// random odd candidates of Len limbs with the top bit set, and the first
+// prime of each such sequence
+template<std::size_t Len>
+static std::vector<lam::cbn::big_int<Len>> random_candidates(std::size_t n, bool primes)
+{
+  std::default_random_engine generator(Len);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<lam::cbn::big_int<Len>> v(n);
+  for (auto& x : v)
+  {
+    do
+    {
+      for (auto& limb : x)
+        limb = distribution(generator);
+      x[0] |= 1;
+      x[Len - 1] |= std::uint64_t{1} << 63;
+    } while (primes && !lam::cbn::is_probable_prime(x));
+  }
+  return v;
+}
+
+// candidates (most rejected by trial division), and primes (the full test)
+template<std::size_t Len, bool Primes>
+static void probable_prime(benchmark::State& state)
+{
+  const auto candidates = random_candidates<Len>(Primes ? 4 : 1024, Primes);
+  std::size_t found = 0;
+
+  for (auto _ : state)
+    for (const auto& x : candidates)
+      found += lam::cbn::is_probable_prime(x);
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations() * candidates.size());
+}
+
+// GMP Comparison: Baillie-PSW, no further Miller-Rabin rounds
+template<std::size_t Len, bool Primes>
+static void probable_prime_gmp(benchmark::State& state)
+{
+  const auto candidates = random_candidates<Len>(Primes ? 4 : 1024, Primes);
+  std::vector<mpz_t> z(candidates.size());
+  for (std::size_t i = 0; i < z.size(); ++i)
+  {
+    mpz_init(z[i]);
+    mpz_import(z[i], Len, -1, sizeof(std::uint64_t), 0, 0, candidates[i].data());
+  }
+  std::size_t found = 0;
+
+  for (auto _ : state)
+    for (auto& x : z)
+      found += mpz_probab_prime_p(x, 24) != 0;
+  benchmark::DoNotOptimize(found);
+  state.SetItemsProcessed(state.iterations() * z.size());
+
+  for (auto& x : z)
+    mpz_clear(x);
+}
+
+// wall-clock time per random prime (or safe prime) of Len limbs against the
+// number of threads
+template<std::size_t Len, bool Safe>
+static void generate(benchmark::State& state)
+{
+  std::mt19937_64 generator(Len);
+  lam::cbn::thread_pool pool(state.range(0));
+  const lam::cbn::prime_options options{.pool = &pool};
+
+  for (auto _ : state)
+  {
+    auto p = Safe ? lam::cbn::generate_safe_prime<Len>(generator, 64 * Len, options)
+                  : lam::cbn::generate_prime<Len>(generator, 64 * Len, options);
+    benchmark::DoNotOptimize(p);
+  }
+}
+
+// GMP Comparison: the next prime after a random start, on one thread
+template<std::size_t Len>
+static void generate_gmp(benchmark::State& state)
+{
+  gmp_randstate_t random;
+  gmp_randinit_mt(random);
+  gmp_randseed_ui(random, Len);
+  mpz_t x;
+  mpz_init(x);
+
+  for (auto _ : state)
+  {
+    mpz_urandomb(x, random, 64 * Len - 1);
+    mpz_setbit(x, 64 * Len - 1);
+    mpz_nextprime(x, x);
+    benchmark::DoNotOptimize(x);
+  }
+
+  mpz_clear(x);
+  gmp_randclear(random);
+}
+
+// 512 bits
+BENCHMARK_TEMPLATE(probable_prime, 8, false);
+BENCHMARK_TEMPLATE(probable_prime_gmp, 8, false);
+BENCHMARK_TEMPLATE(probable_prime, 8, true);
+BENCHMARK_TEMPLATE(probable_prime_gmp, 8, true);
+
+// 1024 bits
+BENCHMARK_TEMPLATE(probable_prime, 16, false);
+BENCHMARK_TEMPLATE(probable_prime_gmp, 16, false);
+BENCHMARK_TEMPLATE(probable_prime, 16, true);
+BENCHMARK_TEMPLATE(probable_prime_gmp, 16, true);
+
+// prime generation: 1024 and 2048 bits, safe primes of 512 bits
+BENCHMARK_TEMPLATE(generate, 16, false)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(generate_gmp, 16)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(generate, 32, false)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(generate_gmp, 32)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(generate, 8, true)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+// four primes below 2^50, and the four-limb field of their product M (200 bits)
+using RNS = lam::cbn::rns_vector<std::uint64_t, 1125899906842597, 1125899906842589, 1125899906842573, 1125899906842553>;
+using Wide = decltype(lam::cbn::Zq(1606938044258727661966504211099649658671864355051562425661077_Z));
+
+static std::vector<lam::cbn::big_int<4>> random_integers(std::size_t n, unsigned seed)
+{
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<lam::cbn::big_int<4>> v(n);
+  for (auto& x : v)
+  {
+    for (auto& limb : x)
+      limb = distribution(generator);
+    x[3] >>= 1; // below M
+  }
+  return v;
+}
+
+static RNS random_rns(std::size_t n, unsigned seed)
+{
+  RNS v(n);
+  auto x = random_integers(n, seed);
+  for (std::size_t i = 0; i < n; ++i)
+    v.set(i, RNS::value_type{x[i]});
+  return v;
+}
+
+// element-wise products modulo M: residue channels, and one multi-limb field
+static void mul_rns(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_rns(n, 1);
+  const auto b = random_rns(n, 2);
+
+  for (auto _ : state)
+  {
+    a *= b;
+    benchmark::DoNotOptimize(a.channel<0>().data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void mul_wide(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  std::vector<Wide> a, b;
+  for (auto x : random_integers(n, 1))
+    a.push_back(Wide{x});
+  for (auto x : random_integers(n, 2))
+    b.push_back(Wide{x});
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      a[i] *= b[i];
+    benchmark::DoNotOptimize(a.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void add_rns(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_rns(n, 1);
+  const auto b = random_rns(n, 2);
+
+  for (auto _ : state)
+  {
+    a += b;
+    benchmark::DoNotOptimize(a.channel<0>().data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Garner's algorithm, one element at a time
+static void reconstruct(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto a = random_rns(n, 1);
+  std::vector<lam::cbn::big_int<4>> out(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      out[i] = a[i].reconstruct();
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// extension to two further primes, over whole channels and one element at a time
+static void base_extend_vector(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto a = random_rns(n, 1);
+
+  for (auto _ : state)
+  {
+    auto r = a.base_extend<1125899906842511, 1125899906842507>();
+    benchmark::DoNotOptimize(r.channel<0>().data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void base_extend_elementwise(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto a = random_rns(n, 1);
+  std::vector<lam::cbn::rns_int<std::uint64_t, 1125899906842511, 1125899906842507>> out(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      out[i] = a[i].base_extend<1125899906842511, 1125899906842507>();
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(mul_rns)->Arg(4096);
+BENCHMARK(mul_wide)->Arg(4096);
+BENCHMARK(add_rns)->Arg(4096);
+BENCHMARK(reconstruct)->Arg(4096);
+BENCHMARK(base_extend_vector)->Arg(4096);
+BENCHMARK(base_extend_elementwise)->Arg(4096);
+
+BENCHMARK_MAIN();
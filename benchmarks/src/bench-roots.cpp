@@ -0,0 +1,137 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+// secp256k1 (p = 3 mod 4), curve25519 (S = 2) and the BLS12-381 scalar field (S = 32)
+using secp256k1 = decltype(lam::cbn::Zq(115792089237316195423570985008687907853269984665640564039457584007908834671663_Z));
+using curve25519 = decltype(lam::cbn::Zq(57896044618658097711785492504343953926634992332820282019728792003956564819949_Z));
+using bls12_381_r = decltype(lam::cbn::Zq(52435875175126190479447740508185965837690552500527637822603658699938581184513_Z));
+
+// random elements (squares, cubes) of the field
+template<typename GF>
+static std::vector<GF> random_powers(int k)
+{
+  std::mt19937_64 generator(1);
+  std::vector<GF> v(64);
+  for (auto& x : v)
+  {
+    const GF y{lam::cbn::big_int<4>{generator(), generator(), generator(), generator() >> 2}};
+    x = k == 1 ? y : k == 2 ? y * y : y * y * y;
+  }
+  return v;
+}
+
+template<typename GF>
+static void sqrt(benchmark::State& state)
+{
+  const auto squares = random_powers<GF>(2);
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    auto root = lam::cbn::sqrt(squares[i++ % squares.size()]);
+    benchmark::DoNotOptimize(root);
+  }
+}
+
+template<typename GF>
+static void cbrt(benchmark::State& state)
+{
+  const auto cubes = random_powers<GF>(3);
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    auto root = lam::cbn::cbrt(cubes[i++ % cubes.size()]);
+    benchmark::DoNotOptimize(root);
+  }
+}
+
+template<typename GF>
+static void sqrt_ct(benchmark::State& state)
+{
+  const auto squares = random_powers<GF>(2);
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    auto root = lam::cbn::sqrt_ct(squares[i++ % squares.size()]);
+    benchmark::DoNotOptimize(root);
+  }
+}
+
+// sqrt(u / v) without an inversion, and with one (variable time)
+template<typename GF, bool Inversion>
+static void sqrt_ratio(benchmark::State& state)
+{
+  const auto squares = random_powers<GF>(2);
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    const auto u = squares[i % squares.size()], v = squares[(i + 1) % squares.size()];
+    ++i;
+    if constexpr (Inversion)
+    {
+      auto root = lam::cbn::sqrt_ct(u / v);
+      benchmark::DoNotOptimize(root);
+    }
+    else
+    {
+      auto root = lam::cbn::sqrt_ratio(u, v);
+      benchmark::DoNotOptimize(root);
+    }
+  }
+}
+
+// the Legendre symbol by the binary algorithm (variable and constant time),
+// and by Euler's criterion n^((p - 1) / 2)
+template<typename GF, int Method>
+static void legendre(benchmark::State& state)
+{
+  const auto values = random_powers<GF>(1);
+  const auto p = lam::cbn::to_big_int(lam::cbn::extract_modulus(GF{}));
+  const auto euler_exp = lam::cbn::shift_right(lam::cbn::subtract_ignore_carry(p, decltype(p){1}), 1);
+  std::size_t i = 0;
+  for (auto _ : state)
+  {
+    const auto& x = values[i++ % values.size()];
+    if constexpr (Method == 0)
+      benchmark::DoNotOptimize(lam::cbn::legendre(x));
+    else if constexpr (Method == 1)
+      benchmark::DoNotOptimize(lam::cbn::legendre_ct(x));
+    else
+      benchmark::DoNotOptimize(lam::cbn::mod_exp(x.data, euler_exp, lam::cbn::extract_modulus(GF{})));
+  }
+}
+
+BENCHMARK_TEMPLATE(legendre, secp256k1, 0);
+BENCHMARK_TEMPLATE(legendre, secp256k1, 1);
+BENCHMARK_TEMPLATE(legendre, secp256k1, 2);
+BENCHMARK_TEMPLATE(legendre, bls12_381_r, 0);
+BENCHMARK_TEMPLATE(legendre, bls12_381_r, 1);
+BENCHMARK_TEMPLATE(legendre, bls12_381_r, 2);
+BENCHMARK_TEMPLATE(sqrt, secp256k1);
+BENCHMARK_TEMPLATE(sqrt, curve25519);
+BENCHMARK_TEMPLATE(sqrt, bls12_381_r);
+BENCHMARK_TEMPLATE(sqrt_ct, secp256k1);
+BENCHMARK_TEMPLATE(sqrt_ct, curve25519);
+BENCHMARK_TEMPLATE(sqrt_ct, bls12_381_r);
+BENCHMARK_TEMPLATE(sqrt_ratio, curve25519, false);
+BENCHMARK_TEMPLATE(sqrt_ratio, curve25519, true);
+BENCHMARK_TEMPLATE(sqrt_ratio, bls12_381_r, false);
+BENCHMARK_TEMPLATE(sqrt_ratio, bls12_381_r, true);
+BENCHMARK_TEMPLATE(cbrt, secp256k1);
+BENCHMARK_TEMPLATE(cbrt, bls12_381_r);
+
+BENCHMARK_MAIN();
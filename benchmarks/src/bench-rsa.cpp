@@ -0,0 +1,101 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+// an RSA-2048 key: two 1024-bit primes and the private exponent for e = 65537
+constexpr std::string_view p2048 =
+  "14635338634281775710586469368984220643685091058466298028444753434693076992142941983203374280069655326226488386"
+  "48514994806458867504458291832414263242504459851644220766361158475298555161610458037329257258016616790558209407"
+  "81439001069915582427739424446385396638156096672107328889770691700558009309178801871176059";
+constexpr std::string_view q2048 =
+  "16100361730947116168542090191026166703502886556968032909468079447160444320234554952409021577988823405295707766"
+  "02325689116466744050729677498197069295122481315750635593228396339769219957134811668717836000091184590062767031"
+  "08580044521077408028011905183832198375258076602958621420078020646477950479936278995730979";
+constexpr std::string_view d2048 =
+  "23337990619342848906827547191901016333770341933787878784413127364759549238942851548134968110354995375178296696"
+  "25220960699146980529038981869973203371153415186777638989451451821171433900821245699983580581434768045426060684"
+  "69974167125032331474117640431283936600296647403656232468098700450891629227014709546918916418332549971388099298"
+  "50133964941875269016382218788748602342458904224420637870156362885761171097894194623153563320074087306369208261"
+  "37368953516557255185966633121330725894738486593239850167461169304869451131237120269155819881563732645594850806"
+  "890364087540057358914562869276891065147647253985466708158874593405";
+
+constexpr std::size_t N = 32;
+
+template<std::size_t L>
+static lam::cbn::big_int<L> parse(std::string_view s)
+{ return *lam::cbn::big_int_from_string<L>(s); }
+
+template<bool ConstantTime>
+static auto make_key()
+{ return lam::cbn::rsa_private_key<N, std::uint64_t, ConstantTime>(parse<N / 2>(p2048), parse<N / 2>(q2048), parse<N>(d2048)); }
+
+static lam::cbn::big_int<N> message()
+{
+  std::default_random_engine generator(1);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  lam::cbn::big_int<N> x;
+  for (auto& limb : x)
+    limb = distribution(generator);
+  x[N - 1] >>= 2; // below n
+  return x;
+}
+
+// the full-size runtime mod_exp
+static void sign_mod_exp(benchmark::State& state)
+{
+  const auto n = make_key<true>().modulus();
+  const auto d = parse<N>(d2048);
+  const auto x = message();
+
+  for (auto _ : state)
+  {
+    auto s = lam::cbn::mod_exp(x, d, n);
+    benchmark::DoNotOptimize(s);
+  }
+}
+
+template<bool ConstantTime>
+static void sign_crt(benchmark::State& state)
+{
+  const auto key = make_key<ConstantTime>();
+  const auto x = message();
+
+  for (auto _ : state)
+  {
+    auto s = key.apply(x);
+    benchmark::DoNotOptimize(s);
+  }
+}
+
+// the two half-size exponentiations on two threads
+static void sign_crt_two_threads(benchmark::State& state)
+{
+  const auto key = make_key<true>();
+  const auto x = message();
+  lam::cbn::thread_pool pool(2);
+
+  for (auto _ : state)
+  {
+    auto s = key.apply(x, pool);
+    benchmark::DoNotOptimize(s);
+  }
+}
+
+BENCHMARK(sign_mod_exp)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(sign_crt, false)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(sign_crt, true)->Unit(benchmark::kMillisecond);
+BENCHMARK(sign_crt_two_threads)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
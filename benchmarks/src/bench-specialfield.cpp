@@ -0,0 +1,188 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+#include <benchmark/benchmark.h>
+
+import std;
+import lam.ctbignum;
+
+using namespace lam::cbn::literals;
+
+// special forms, and generic primes of the same size
+using Goldilocks = decltype(lam::cbn::Zq(18446744069414584321_Z)); // 2^64 - 2^32 + 1
+using Field64 = decltype(lam::cbn::Zq(18446744073709551557_Z));    // 2^64 - 59
+using M31 = lam::cbn::ZqElement<std::uint32_t, 2147483647>;        // 2^31 - 1
+using Field31 = lam::cbn::ZqElement<std::uint32_t, 2147483629>;    // 2^31 - 19
+using BabyBear = lam::cbn::ZqElement<std::uint32_t, 2013265921>;   // 15 * 2^27 + 1
+
+template<typename Zq>
+static std::vector<Zq> random_vector(std::size_t n, unsigned seed)
+{
+  using T = typename Zq::value_type;
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<std::uint64_t> distribution(1);
+  std::vector<Zq> v(n);
+  for (auto& x : v)
+    x = Zq{lam::cbn::big_int<1, T>{static_cast<T>(distribution(generator))}};
+  for (auto& x : v)
+    if (x == Zq{})
+      x = Zq{1};
+  return v;
+}
+
+// a chain of dependent ZqElement::operator* (latency of the scalar reduction)
+template<typename Zq>
+static void mul_chain(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+
+  for (auto _ : state)
+  {
+    Zq acc{1};
+    for (const auto& x : a)
+      acc *= x;
+    benchmark::DoNotOptimize(acc);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// element-wise ZqElement::operator*
+template<typename Zq>
+static void mul_operator(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      c[i] = a[i] * b[i];
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// span kernels (AVX2 when compiled with LAM_CTBIGNUM_NativeArch)
+template<typename Zq>
+static void mul_packed(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    lam::cbn::mulmod(std::span{c}, a, b);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Zq>
+static void add_operator(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      c[i] = a[i] + b[i];
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Zq>
+static void add_packed(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  auto b = random_vector<Zq>(n, 2);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    lam::cbn::addmod(std::span{c}, a, b);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+// one inversion per element, and batch_inverse
+template<typename Zq>
+static void inverse_each(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      c[i] = Zq{1} / a[i];
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template<typename Zq>
+static void inverse_batch(benchmark::State& state)
+{
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto a = random_vector<Zq>(n, 1);
+  std::vector<Zq> c(n);
+
+  for (auto _ : state)
+  {
+    lam::cbn::batch_inverse(std::span{c}, a);
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK_TEMPLATE(mul_chain, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_chain, Field64)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_chain, M31)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_chain, Field31)->Arg(4096);
+
+BENCHMARK_TEMPLATE(mul_operator, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_packed, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_operator, Field64)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_operator, M31)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_operator, Field31)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_packed, M31)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_operator, BabyBear)->Arg(4096);
+BENCHMARK_TEMPLATE(mul_packed, BabyBear)->Arg(4096);
+
+BENCHMARK_TEMPLATE(add_operator, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(add_packed, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(add_operator, M31)->Arg(4096);
+BENCHMARK_TEMPLATE(add_packed, M31)->Arg(4096);
+
+BENCHMARK_TEMPLATE(inverse_each, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(inverse_batch, Goldilocks)->Arg(4096);
+BENCHMARK_TEMPLATE(inverse_each, BabyBear)->Arg(4096);
+BENCHMARK_TEMPLATE(inverse_batch, BabyBear)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -42,9 +42,9 @@ constexpr auto add_same(big_int<N, T> a, big_int<N, T> b)
 
   for (auto i = 0U; i < N; ++i)
   {
-    auto aa = a[i];
-    auto sum = aa + b[i];
-    auto res = sum + carry;
+    T aa = a[i];
+    T sum = aa + b[i];
+    T res = sum + carry;
     carry = (sum < aa) | (res < sum);
     r[i] = res;
   }
@@ -61,9 +61,9 @@ constexpr auto subtract_same(big_int<N, T> a, big_int<N, T> b)
 
   for (auto i = 0U; i < N; ++i)
   {
-    auto aa = a[i];
-    auto diff = aa - b[i];
-    auto res = diff - carry;
+    T aa = a[i];
+    T diff = aa - b[i];
+    T res = diff - carry;
     carry = (diff > aa) | (res > diff);
     r[i] = res;
   }
@@ -98,9 +98,9 @@ constexpr auto subtract_ignore_carry(big_int<N, T> a, big_int<N, T> b)
 
   for (auto i = 0U; i < N; ++i)
   {
-    auto aa = a[i];
-    auto diff = aa - b[i];
-    auto res = diff - carry;
+    T aa = a[i];
+    T diff = aa - b[i];
+    T res = diff - carry;
     carry = (diff > aa) | (res > diff);
     r[i] = res;
   }
@@ -116,9 +116,9 @@ constexpr auto mod_add(big_int<N, T> a, big_int<N, T> b, big_int<N, T> modulus)
 
   for (auto i = 0U; i < N; ++i)
   {
-    auto aa = a[i];
-    auto sum = aa + b[i];
-    auto res = sum + carry;
+    T aa = a[i];
+    T sum = aa + b[i];
+    T res = sum + carry;
     carry = (sum < aa) | (res < sum);
     r[i] = res;
   }
@@ -137,9 +137,9 @@ constexpr auto mod_sub(big_int<N, T> a, big_int<N, T> b, big_int<N, T> modulus)
 
   for (auto i = 0U; i < N; ++i)
   {
-    auto aa = a[i];
-    auto diff = aa - b[i];
-    auto res = diff - carry;
+    T aa = a[i];
+    T diff = aa - b[i];
+    T res = diff - carry;
     carry = (diff > aa) | (res > diff);
     r[i] = res;
   }
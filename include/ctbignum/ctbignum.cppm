@@ -25,6 +25,7 @@ export import :utility;
 export import :addition;
 export import :mult;
 export import :bitshift;
+export import :reciprocal;
 export import :division;
 
 // Comparisons
@@ -33,6 +34,7 @@ export import :relational;
 // Modular arithmetic
 export import :gcd;
 export import :mod_inv;
+export import :word_field;
 export import :barrett;
 export import :invariant_div;
 export import :montgomery;
@@ -40,6 +42,24 @@ export import :mod_exp;
 
 // Field type
 export import :field;
+export import :precomputed_multiplier;
+
+// Transforms
+export import :ntt;
+export import :thread_pool;
+export import :four_step_ntt;
+
+// Polynomials
+export import :polynomial;
+
+// Residue number system
+export import :rns;
+
+// Public-key primitives
+export import :primality;
+export import :multi_exp;
+export import :rsa;
+export import :prime_generation;
 
 // I/O and literals
 export import :io;
@@ -47,3 +67,8 @@ export import :literals;
 
 // Roots (modular square root)
 export import :roots;
+
+// Vectorized kernels
+export import :simd_field;
+export import :fma_mulmod;
+export import :lattice;
@@ -20,6 +20,7 @@ import :addition;
 import :mult;
 import :bitshift;
 import :type_traits;
+import :reciprocal;
 
 namespace lam::cbn
 {
@@ -31,8 +32,12 @@ struct DivisionResult
   R remainder;
 };
 
-export template<std::size_t M, typename T>
-constexpr DivisionResult<big_int<M, T>, big_int<1, T>> short_div(big_int<M, T> u, T v)
+namespace detail
+{
+
+// u / v for a single limb v, by hardware divisions (constant evaluation)
+template<std::size_t M, typename T>
+constexpr DivisionResult<big_int<M, T>, big_int<1, T>> short_div_hw(const big_int<M, T>& u, T v)
 {
   using TT = typename dbl_bitlen<T>::type;
   TT r{0};
@@ -46,23 +51,166 @@ constexpr DivisionResult<big_int<M, T>, big_int<1, T>> short_div(big_int<M, T> u
   return {q, {static_cast<T>(r)}};
 }
 
-// Knuth's "Algorithm D" for multiprecision division as described in TAOCP
-// Volume 2: Seminumerical Algorithms
-// combined with short division
+// u / v for a single limb v, normalized by its leading zeros, with one
+// 2-by-1 reciprocal for all quotient limbs
+template<std::size_t M, typename T>
+constexpr DivisionResult<big_int<M, T>, big_int<1, T>> short_div_reciprocal(const big_int<M, T>& u, T v)
+{
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  const auto s = std::countl_zero(v);
+  const T d = static_cast<T>(v << s);
+  const T inv = reciprocal_word(d);
 
-//
-// input:
-// u  big_int<M>,      M>=N
-// v  big_int<N>
-//
-// computes:
-// quotient = floor[ u/v ]
-// rem = u % v
-//
-// returns:
-// std::pair<big_int<N+M>, big_int<N>>(quotient, rem)
-export template<std::size_t M, std::size_t N, typename T>
-constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u, big_int<N, T> v)
+  // the limbs of u 2^s on the fly
+  auto shifted = [&](std::size_t i) -> T {
+    const T low = i > 0 && s > 0 ? static_cast<T>(u[i - 1] >> (digits - s)) : T{0};
+    return i < M ? static_cast<T>((u[i] << s) | low) : low;
+  };
+
+  big_int<M, T> q{};
+  T r = shifted(M); // < 2^s <= d
+  for (std::size_t i = M; i-- > 0;)
+    std::tie(q[i], r) = udiv_2by1(r, shifted(i), d, inv);
+  return {q, {static_cast<T>(r >> s)}};
+}
+
+// u[0..n] -= q v[0..n-1] in place; returns true on a borrow out of u[n]
+template<typename T>
+constexpr bool submul(T* u, const T* v, std::size_t n, T q)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  T carry = 0, borrow = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const TT p = static_cast<TT>(v[i]) * q + carry;
+    carry = static_cast<T>(p >> std::numeric_limits<T>::digits);
+    const T lo = static_cast<T>(p), t = static_cast<T>(u[i] - lo);
+    const T b = (u[i] < lo) | (t < borrow);
+    u[i] = static_cast<T>(t - borrow);
+    borrow = b;
+  }
+  const TT top = static_cast<TT>(u[n]) - carry - borrow;
+  u[n] = static_cast<T>(top);
+  return (top >> std::numeric_limits<T>::digits) != 0;
+}
+
+// u[0..n] += v[0..n-1] in place, ignoring the carry out of u[n]
+template<typename T>
+constexpr void addback(T* u, const T* v, std::size_t n)
+{
+  T carry = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const T t = static_cast<T>(u[i] + carry);
+    const T c = t < carry;
+    u[i] = static_cast<T>(t + v[i]);
+    carry = c | (u[i] < v[i]);
+  }
+  u[n] = static_cast<T>(u[n] + carry);
+}
+
+// {u, qn + n} / {v, n} for normalized v and {u + qn, n} < v, quotient limbs
+// from the 3-by-2 division of the top of the remainder by the reciprocal
+// inv of the top two limbs of v, with the multiply-subtract in place; the
+// estimate is at most one too large, corrected by an add-back. The
+// quotient goes to q[0..qn), the remainder to {u, n}.
+template<typename T>
+constexpr void div_schoolbook(T* q, T* u, std::size_t qn, const T* v, std::size_t n, T inv)
+{
+  const T d1 = v[n - 1], d0 = v[n - 2];
+  for (std::size_t j = qn; j-- > 0;)
+  {
+    const T u2 = u[j + n], u1 = u[j + n - 1], u0 = u[j + n - 2];
+    T qhat = std::numeric_limits<T>::max();
+    if (u2 != d1 || u1 != d0) // <u2, u1> <= <d1, d0>
+      qhat = udiv_3by2(u2, u1, u0, d1, d0, inv).first;
+    if (submul(u + j, v, n, qhat))
+    {
+      addback(u + j, v, n);
+      --qhat;
+    }
+    q[j] = qhat;
+  }
+}
+
+// below this many divisor limbs, div_burnikel_ziegler divides by the schoolbook method
+inline constexpr std::size_t burnikel_ziegler_threshold = 48;
+
+// {u, 2n} / {v, n} for normalized v by the recursive method of Burnikel and
+// Ziegler ("Fast recursive division", 1998): the upper and lower halves of
+// the quotient each take a division of half the size and a product of the
+// partial quotient with the rest of v (mul_limbs), followed by at most a few
+// add-backs. The quotient is q[0..n) plus the returned top limb (0 or 1)
+// times B^n, the remainder is left in {u, n}; tp holds
+// n + mul_karatsuba_scratch(n) limbs.
+template<typename T>
+constexpr T div_burnikel_ziegler(T* q, T* u, const T* v, std::size_t n, T inv, T* tp)
+{
+  if (n < burnikel_ziegler_threshold)
+  {
+    T qh = 1; // {u + n, n} >= v, decided by the most significant differing limb
+    for (std::size_t i = n; i-- > 0;)
+      if (u[n + i] != v[i])
+      {
+        qh = u[n + i] > v[i];
+        break;
+      }
+    if (qh)
+      sub_n(u + n, u + n, v, n);
+    div_schoolbook(q, u, n, v, n, inv);
+    return qh;
+  }
+
+  const std::size_t lo = n / 2, hi = n - lo;
+
+  // the upper hi quotient limbs from the top 2 hi limbs of u and hi limbs of v
+  T qh = div_burnikel_ziegler(q + lo, u + 2 * lo, v + lo, hi, inv, tp);
+  mul_limbs(tp, q + lo, hi, v, lo, tp + n);
+  T cy = sub_n(u + lo, u + lo, tp, n);
+  if (qh)
+    cy += sub_n(u + n, u + n, v, lo);
+  while (cy)
+  {
+    qh -= sub_1(q + lo, hi, T{1});
+    cy -= add_n(u + lo, u + lo, v, n);
+  }
+
+  // the lower lo quotient limbs
+  const T ql = div_burnikel_ziegler(q, u + hi, v + hi, lo, inv, tp);
+  mul_limbs(tp, v, hi, q, lo, tp + n);
+  cy = sub_n(u, u, tp, n);
+  if (ql)
+    cy += sub_n(u + lo, u + lo, v, hi);
+  while (cy)
+  {
+    sub_1(q, lo, T{1});
+    cy -= add_n(u, u, v, n);
+  }
+  return qh;
+}
+
+} // namespace detail
+
+export template<std::size_t M, typename T>
+constexpr DivisionResult<big_int<M, T>, big_int<1, T>> short_div(big_int<M, T> u, T v)
+{
+  if consteval
+  {
+    return detail::short_div_hw(u, v);
+  }
+  else
+  {
+    return detail::short_div_reciprocal(u, v);
+  }
+}
+
+namespace detail
+{
+
+// the algorithm with bitwise normalization and hardware divisions by the top
+// limb (constant evaluation)
+template<std::size_t M, std::size_t N, typename T>
+constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div_hw(big_int<M, T> u, big_int<N, T> v)
 {
   using TT = typename dbl_bitlen<T>::type;
   std::size_t tight_N = N;
@@ -90,7 +238,7 @@ constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u, big_
   while (v[tight_N - 1] < (static_cast<T>(1) << (std::numeric_limits<T>::digits - 1)))
   {
     ++k;
-    v = detail::first<N>(shift_left(v, 1));
+    v = first<N>(shift_left(v, 1));
   }
   auto us = shift_left(u, k);
 
@@ -111,11 +259,11 @@ constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u, big_
         break;
     }
     auto true_value =
-      subtract(detail::take<N + 1>(us, j, j + tight_N + 1), mul(v, big_int<1, T>{{static_cast<T>(qhat)}}));
+      subtract(take<N + 1>(us, j, j + tight_N + 1), mul(v, big_int<1, T>{{static_cast<T>(qhat)}}));
     if (true_value[tight_N])
     {
-      auto corrected = add_ignore_carry(true_value, detail::unary_encoding<N + 2, T>(tight_N + 1));
-      auto new_us_part = add_ignore_carry(corrected, detail::pad<2>(v));
+      auto corrected = add_ignore_carry(true_value, unary_encoding<N + 2, T>(tight_N + 1));
+      auto new_us_part = add_ignore_carry(corrected, pad<2>(v));
       for (std::size_t i = 0; i <= tight_N; ++i)
         us[j + i] = new_us_part[i];
       --qhat;
@@ -127,7 +275,83 @@ constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u, big_
     }
     q[j] = qhat;
   }
-  return {q, shift_right(detail::first<N>(us), k)};
+  return {q, shift_right(first<N>(us), k)};
+}
+
+// the same normalized by the leading zeros of v, with the quotient limbs by
+// div_schoolbook, or in blocks of n limbs by div_burnikel_ziegler for long
+// divisors
+template<std::size_t M, std::size_t N, typename T>
+constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div_reciprocal(const big_int<M, T>& u, const big_int<N, T>& v)
+{
+  std::size_t n = N;
+  while (n > 0 && v[n - 1] == 0)
+    --n;
+
+  if (n == 0)
+    return {}; // division by zero
+  if (n == 1)
+  {
+    auto [q, r] = short_div_reciprocal(u, v[0]);
+    return {q, to_length<N>(r)};
+  }
+
+  const auto s = std::countl_zero(v[n - 1]);
+  const auto vn = first<N>(shift_left(v, s));
+  auto us = shift_left(u, s);
+  const T inv = reciprocal_3by2(vn[n - 1], vn[n - 2]);
+
+  big_int<M, T> q{};
+  if (M + 1 > n)
+  {
+    const std::size_t qn = M + 1 - n;
+    if constexpr (N >= burnikel_ziegler_threshold)
+    {
+      if (n >= burnikel_ziegler_threshold && qn >= n)
+      {
+        // the top qn mod n quotient limbs, then blocks of n; the top limbs
+        // of the partial remainder stay below v throughout
+        const std::size_t blocks = qn / n, top = qn % n;
+        div_schoolbook(&q[blocks * n], &us[blocks * n], top, &vn[0], n, inv);
+        std::array<T, N + mul_karatsuba_scratch(N)> tp{};
+        for (std::size_t b = blocks; b-- > 0;)
+          div_burnikel_ziegler(&q[b * n], &us[b * n], &vn[0], n, inv, tp.data());
+        return {q, shift_right(first<N>(us), s)};
+      }
+    }
+    div_schoolbook(&q[0], &us[0], qn, &vn[0], n, inv);
+  }
+  return {q, shift_right(first<N>(us), s)};
+}
+
+} // namespace detail
+
+// Knuth's "Algorithm D" for multiprecision division as described in TAOCP
+// Volume 2: Seminumerical Algorithms
+// combined with short division
+
+//
+// input:
+// u  big_int<M>,      M>=N
+// v  big_int<N>
+//
+// computes:
+// quotient = floor[ u/v ]
+// rem = u % v
+//
+// returns:
+// std::pair<big_int<N+M>, big_int<N>>(quotient, rem)
+export template<std::size_t M, std::size_t N, typename T>
+constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u, big_int<N, T> v)
+{
+  if consteval
+  {
+    return detail::div_hw(u, v);
+  }
+  else
+  {
+    return detail::div_reciprocal(u, v);
+  }
 }
 
 export template<typename T, std::size_t N1, std::size_t N2>
@@ -21,6 +21,10 @@ import :mult;
 import :invariant_div;
 import :mod_inv;
 import :decimal_literals;
+import :type_traits;
+import :word_field;
+import :montgomery;
+import :division;
 
 namespace lam::cbn
 {
@@ -94,6 +98,20 @@ export template<typename T, T... Modulus>
 constexpr auto extract_modulus(ZqElement<T, Modulus...> a)
 { return std::integer_sequence<T, Modulus...>{}; }
 
+namespace detail
+{
+// moduli of three or more limbs that admit Montgomery multiplication (odd, double-width type available)
+template<typename T, T... Modulus>
+constexpr bool montgomery_field = !word_field<T, Modulus...>::enabled && !std::is_void_v<typename dbl_bitlen<T>::type> &&
+                                  ((std::array<T, sizeof...(Modulus)>{Modulus...}[0] & 1) == 1);
+
+// R^2 mod p, where R = beta^N
+template<typename T, T... Modulus>
+constexpr auto montgomery_r2 =
+  div(unary_encoding<2 * sizeof...(Modulus), 2 * sizeof...(Modulus) + 1, T>(), big_int<sizeof...(Modulus), T>{Modulus...})
+    .remainder;
+} // namespace detail
+
 export template<typename T, T... M>
 constexpr auto& operator+=(ZqElement<T, M...>& a, ZqElement<T, M...> b)
 {
@@ -132,7 +150,16 @@ constexpr auto operator-(ZqElement<T, M...> a)
 export template<typename T, T... M>
 constexpr auto& operator*=(ZqElement<T, M...>& a, ZqElement<T, M...> b)
 {
-  a = ZqElement<T, M...>{mod(mul(a.data, b.data), std::integer_sequence<T, M...>()), skip_reduction{}};
+  if constexpr (detail::word_field<T, M...>::enabled) // one- or two-limb modulus
+    a = ZqElement<T, M...>{detail::word_field<T, M...>::mul(a.data, b.data), skip_reduction{}};
+  else if constexpr (detail::montgomery_field<T, M...>)
+  { // a * b = (a * b * R^-1) * R^2 * R^-1: two Montgomery multiplications instead of a long division
+    auto ab = montgomery_mul(a.data, b.data, std::integer_sequence<T, M...>());
+    a = ZqElement<T, M...>{montgomery_mul(ab, detail::montgomery_r2<T, M...>, std::integer_sequence<T, M...>()),
+                           skip_reduction{}};
+  }
+  else
+    a = ZqElement<T, M...>{mod(mul(a.data, b.data), std::integer_sequence<T, M...>()), skip_reduction{}};
   return a;
 }
 
@@ -146,10 +173,8 @@ constexpr auto operator*(ZqElement<T, M...> a, ZqElement<T, M...> b)
 export template<typename T, T... M>
 constexpr auto& operator/=(ZqElement<T, M...>& a, ZqElement<T, M...> b)
 {
-  a = ZqElement<T, M...>{
-    mod(mul(a.data, mod_inv(b.data, big_int<sizeof...(M), T>{M...})), std::integer_sequence<T, M...>()),
-    skip_reduction{}};
-  return a;
+  auto b_inv = mod_inv(b.data, big_int<sizeof...(M), T>{M...});
+  return a *= ZqElement<T, M...>{b_inv, skip_reduction{}};
 }
 
 export template<typename T, T... M>
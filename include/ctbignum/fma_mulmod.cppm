@@ -0,0 +1,166 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+module;
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+export module lam.ctbignum:fma_mulmod;
+
+import std;
+
+import :bigint;
+import :field;
+import :simd_field;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// Constants for the double-precision modular product, modulus p < 2^50
+template<typename T, T Modulus>
+struct fma_mulmod_constants
+{
+  static_assert(static_cast<std::uint64_t>(Modulus) < (std::uint64_t{1} << 50),
+                "fma mulmod requires a single-limb modulus below 2^50");
+  static constexpr double p = static_cast<double>(Modulus);
+  static constexpr double u = 1.0 / p;
+};
+
+// Modular product of a, b in [0, p) in double precision.
+//
+// The FMA error-free transformation splits the product exactly as
+//   a * b = h + l,  h = fl(a * b),  l = fma(a, b, -h)
+// and c = floor(h / p) (computed as h * (1/p)) is off by at most one, so that
+// fma(-c, p, h) + l lies in (-p, 2p) and one correction step in each
+// direction yields the canonical residue.
+// See J. van der Hoeven, G. Lecerf, G. Quintin,
+// "Modular SIMD arithmetic in Mathemagix", ACM TOMS 43(1), 2016
+inline double fma_mulmod(double a, double b, double p, double u)
+{
+  double h = a * b;
+  double l = std::fma(a, b, -h);
+  double c = std::floor(h * u);
+  double g = std::fma(-c, p, h) + l;
+  g = (g >= p) ? g - p : g;
+  g = (g < 0.0) ? g + p : g;
+  return g;
+}
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+// exact conversions between integers in [0, 2^52) and doubles
+inline __m256d u64_to_pd(__m256i x)
+{
+  const __m256d magic = _mm256_set1_pd(0x1p52);
+  return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, _mm256_castpd_si256(magic))), magic);
+}
+
+inline __m256i pd_to_u64(__m256d x)
+{
+  const __m256d magic = _mm256_set1_pd(0x1p52);
+  return _mm256_xor_si256(_mm256_castpd_si256(_mm256_add_pd(x, magic)), _mm256_castpd_si256(magic));
+}
+
+// four lanes of fma_mulmod
+inline __m256d fma_mulmod(__m256d a, __m256d b, __m256d p, __m256d u)
+{
+  __m256d h = _mm256_mul_pd(a, b);
+  __m256d l = _mm256_fmsub_pd(a, b, h);
+  __m256d c = _mm256_floor_pd(_mm256_mul_pd(h, u));
+  __m256d g = _mm256_add_pd(_mm256_fnmadd_pd(c, p, h), l);
+  g = _mm256_sub_pd(g, _mm256_and_pd(_mm256_cmp_pd(g, p, _CMP_GE_OQ), p));
+  g = _mm256_add_pd(g, _mm256_and_pd(_mm256_cmp_pd(g, _mm256_setzero_pd(), _CMP_LT_OQ), p));
+  return g;
+}
+
+template<typename T>
+inline __m256d load4_pd(const T* src)
+{
+  if constexpr (std::numeric_limits<T>::digits == 64)
+    return u64_to_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+  else
+    return u64_to_pd(_mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+}
+
+template<typename T>
+inline void store4_pd(T* dst, __m256d x)
+{
+  __m256i v = pd_to_u64(x);
+  if constexpr (std::numeric_limits<T>::digits == 64)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), v);
+  else
+  { // gather the low halves of the four 64-bit lanes
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(v));
+  }
+}
+
+#endif
+
+// mulmod by fma_mulmod, for moduli below 2^50
+template<typename T, T Modulus>
+void fma_mulmod_span(std::span<ZqElement<T, Modulus>> out, std::span<const ZqElement<T, Modulus>> a,
+                     std::span<const ZqElement<T, Modulus>> b)
+{
+  using constants = fma_mulmod_constants<T, Modulus>;
+
+  const std::size_t n = out.size();
+  std::size_t i = 0;
+
+#if defined(__AVX2__) && defined(__FMA__)
+  if constexpr (std::numeric_limits<T>::digits == 32 || std::numeric_limits<T>::digits == 64)
+  {
+    auto pa = reinterpret_cast<const T*>(a.data());
+    auto pb = reinterpret_cast<const T*>(b.data());
+    auto pr = reinterpret_cast<T*>(out.data());
+    const __m256d p = _mm256_set1_pd(constants::p);
+    const __m256d u = _mm256_set1_pd(constants::u);
+    for (; i + 4 <= n; i += 4)
+      store4_pd(pr + i, fma_mulmod(load4_pd(pa + i), load4_pd(pb + i), p, u));
+  }
+#endif
+
+  for (; i < n; ++i)
+  {
+    double r =
+      fma_mulmod(static_cast<double>(a[i].data[0]), static_cast<double>(b[i].data[0]), constants::p, constants::u);
+    out[i] = ZqElement<T, Modulus>{big_int<1, T>{static_cast<T>(r)}, skip_reduction{}};
+  }
+}
+
+} // namespace detail
+
+// Element-wise modular multiplication out[i] = a[i] * b[i] over spans of
+// single-limb ZqElements whose modulus is below 2^50, or is the Goldilocks
+// prime 2^64 - 2^32 + 1.
+//
+// The Goldilocks prime, and odd moduli below 2^31 with 32-bit limbs, have
+// integer kernels with AVX2 (see addmod). Otherwise, with AVX2 and FMA
+// available, four products are computed per iteration in double precision
+// (see detail::fma_mulmod); the remaining elements, and all elements on other
+// targets, take the scalar path.
+// a and b must hold at least out.size() elements; out may alias a or b.
+export template<typename T, T Modulus>
+void mulmod(std::span<ZqElement<T, Modulus>> out, std::span<const std::type_identity_t<ZqElement<T, Modulus>>> a,
+            std::span<const std::type_identity_t<ZqElement<T, Modulus>>> b)
+{
+  static_assert(sizeof(ZqElement<T, Modulus>) == sizeof(T));
+  if constexpr (detail::simd_field<T, Modulus>)
+    detail::simd_mulmod<T, Modulus>(out, a, b);
+  else
+    detail::fma_mulmod_span<T, Modulus>(out, a, b);
+}
+
+} // namespace lam::cbn
@@ -0,0 +1,164 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:four_step_ntt;
+
+import std;
+
+import :field;
+import :precomputed_multiplier;
+import :ntt;
+import :thread_pool;
+
+namespace lam::cbn
+{
+
+// Four-step (Bailey) transform of length n = n1 * n2 for vectors that exceed
+// the cache: the input is viewed as a row-major n1 x n2 matrix and
+//   1. the n2 columns are transformed (length n1), in tiles of adjacent
+//      columns that are transposed into a contiguous buffer and back,
+//   2. entry (r, c) is multiplied by w^(c * bitrev(r)), and
+//   3. the n1 rows are transformed (length n2),
+// where w is the n-th root of unity of ntt_plan. Since the row and column
+// transforms leave their outputs in bit-reversed order, entry (r, c) ends up
+// holding evaluation number bitrev(n2 * r + c): the result is identical to
+// that of ntt_plan<Zq>(log n).forward(), and inverse() undoes either.
+//
+// Steps 2 and 3 are fused per row, and both passes are spread over the
+// threads of a thread_pool.
+export template<typename Zq>
+struct four_step_ntt_plan;
+
+export template<typename T, T... Modulus>
+struct four_step_ntt_plan<ZqElement<T, Modulus...>>
+{
+  using element_type = ZqElement<T, Modulus...>;
+  using multiplier_type = precomputed_multiplier<element_type>;
+
+  std::size_t log_rows;    // n1 = 2^log_rows
+  std::size_t log_columns; // n2 = 2^log_columns
+  std::size_t tile_columns;
+  ntt_plan<element_type> column_plan;
+  ntt_plan<element_type> row_plan;
+  std::vector<multiplier_type> row_twiddles;         // w^bitrev(r)
+  std::vector<multiplier_type> inverse_row_twiddles; // w^-bitrev(r)
+
+  // tile width: the columns that share a 256-byte stretch of each row
+  explicit four_step_ntt_plan(std::size_t log_n,
+                              std::size_t tile = std::max<std::size_t>(1, 256 / sizeof(element_type)))
+    : log_rows(log_n / 2), log_columns(log_n - log_n / 2),
+      tile_columns(std::min(std::bit_floor(std::max<std::size_t>(tile, 1)), std::size_t{1} << log_columns)),
+      column_plan(log_rows), row_plan(log_columns)
+  {
+    if (log_n > ntt_plan<element_type>::max_log_size)
+      throw std::runtime_error("transform length does not divide p - 1");
+
+    const auto w = detail::ntt_constants<T, Modulus...>::root_of_unity(log_n);
+    const auto w_inv = element_type{1} / w;
+    std::vector<element_type> powers(rows()), inverse_powers(rows());
+    element_type x{1}, y{1};
+    for (std::size_t i = 0; i < rows(); ++i, x *= w, y *= w_inv)
+    {
+      powers[i] = x;
+      inverse_powers[i] = y;
+    }
+    for (std::size_t r = 0; r < rows(); ++r)
+    {
+      row_twiddles.emplace_back(powers[detail::bit_reverse(r, log_rows)]);
+      inverse_row_twiddles.emplace_back(inverse_powers[detail::bit_reverse(r, log_rows)]);
+    }
+  }
+
+  std::size_t rows() const { return std::size_t{1} << log_rows; }
+  std::size_t columns() const { return std::size_t{1} << log_columns; }
+  std::size_t size() const { return rows() * columns(); }
+
+  void forward(std::span<element_type> a) const
+  {
+    thread_pool single(1);
+    forward(a, single);
+  }
+
+  void inverse(std::span<element_type> a) const
+  {
+    thread_pool single(1);
+    inverse(a, single);
+  }
+
+  void forward(std::span<element_type> a, thread_pool& pool) const
+  {
+    check_length(a);
+    column_pass(a, pool, [this](std::span<element_type> column) { column_plan.forward(column); });
+    row_pass(a, pool, [this](std::span<element_type> row, std::size_t r) {
+      twiddle(row, row_twiddles[r]);
+      row_plan.forward(row);
+    });
+  }
+
+  void inverse(std::span<element_type> a, thread_pool& pool) const
+  {
+    check_length(a);
+    row_pass(a, pool, [this](std::span<element_type> row, std::size_t r) {
+      row_plan.inverse(row);
+      twiddle(row, inverse_row_twiddles[r]);
+    });
+    column_pass(a, pool, [this](std::span<element_type> column) { column_plan.inverse(column); });
+  }
+
+private:
+  void check_length(std::span<element_type> a) const
+  {
+    if (a.size() != size())
+      throw std::runtime_error("input length does not match the transform length");
+  }
+
+  // row[c] *= v^c for the fixed row factor v
+  static void twiddle(std::span<element_type> row, const multiplier_type& v)
+  {
+    element_type x{1};
+    for (auto& e : row)
+    {
+      e *= x;
+      x *= v;
+    }
+  }
+
+  template<typename Transform>
+  void column_pass(std::span<element_type> a, thread_pool& pool, Transform transform) const
+  {
+    const std::size_t n1 = rows(), n2 = columns(), width = tile_columns;
+    pool.parallel_for(n2 / width, [&](std::size_t tile) {
+      std::vector<element_type> buffer(n1 * width); // column-major copy of the tile
+      const std::size_t c0 = tile * width;
+      for (std::size_t r = 0; r < n1; ++r)
+        for (std::size_t c = 0; c < width; ++c)
+          buffer[c * n1 + r] = a[r * n2 + c0 + c];
+      for (std::size_t c = 0; c < width; ++c)
+        transform(std::span{buffer}.subspan(c * n1, n1));
+      for (std::size_t r = 0; r < n1; ++r)
+        for (std::size_t c = 0; c < width; ++c)
+          a[r * n2 + c0 + c] = buffer[c * n1 + r];
+    });
+  }
+
+  template<typename Transform>
+  void row_pass(std::span<element_type> a, thread_pool& pool, Transform transform) const
+  {
+    const std::size_t n1 = rows(), n2 = columns();
+    const std::size_t tasks = std::min(n1, 4 * pool.size()); // a few tasks per thread for balance
+    pool.parallel_for(tasks, [&](std::size_t task) {
+      for (std::size_t r = task * n1 / tasks; r < (task + 1) * n1 / tasks; ++r)
+        transform(a.subspan(r * n2, n2), r);
+    });
+  }
+};
+
+} // namespace lam::cbn
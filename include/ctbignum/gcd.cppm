@@ -18,6 +18,9 @@ import :slicing;
 import :division;
 import :mult;
 import :addition;
+import :bitshift;
+import :relational;
+import :type_traits;
 import :utility;
 
 namespace lam::cbn
@@ -25,157 +28,442 @@ namespace lam::cbn
 namespace detail
 {
 
-export template<typename T, T... A, T... B, T... Is, std::size_t N = sizeof...(Is)>
-constexpr auto ext_gcd_impl(std::integer_sequence<T, A...>, std::integer_sequence<T, B...>,
-                            std::integer_sequence<T, Is...>)
+// the bits [pos, pos + 32) of x, reading every limb
+template<std::size_t N, typename T>
+constexpr std::uint64_t bits32(const big_int<N, T>& x, std::size_t pos)
 {
-  using detail::first;
-  using detail::join;
-  using detail::pad;
-  using detail::skip;
-  using detail::take;
-
-  constexpr auto a = big_int<N, T>{A...};
-  constexpr auto b = big_int<N, T>{B...};
-  constexpr auto dummy = big_int<N, T>{};
-
-  constexpr bool a_equals_zero =
-    std::is_same<std::integer_sequence<T, A...>, std::integer_sequence<T, dummy[Is]...>>::value;
-  if constexpr (a_equals_zero)
-    return join(b, join(big_int<N, T>{0}, big_int<N, T>{1}));
+  constexpr std::size_t digits = std::numeric_limits<T>::digits;
+  std::uint64_t r = 0;
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    const std::uint64_t v = x[i], start = i * digits;
+    const std::uint64_t up = start - pos, down = pos - start;
+    const std::uint64_t up_mask = -static_cast<std::uint64_t>((start >= pos) & (up < 32));
+    const std::uint64_t down_mask = -static_cast<std::uint64_t>((start < pos) & (down < digits));
+    r |= ((v << (up & 63)) & up_mask) | ((v >> (down & 63)) & down_mask);
+  }
+  return r & 0xffffffff;
+}
 
-  else
+// the bit length of x, reading every limb
+template<std::size_t N, typename T>
+constexpr std::size_t bit_length_ct(const big_int<N, T>& x)
+{
+  constexpr std::size_t digits = std::numeric_limits<T>::digits;
+  std::size_t n = 0;
+  for (std::size_t i = 0; i < N; ++i)
   {
-    constexpr auto qr = div(b, a);
-    constexpr auto rem = qr.remainder;
-    constexpr auto arg1 = pad<N - rem.size()>(rem);
+    const std::size_t mask = -static_cast<std::size_t>(x[i] != 0);
+    n = (n & ~mask) | ((i * digits + digits - std::countl_zero(x[i])) & mask);
+  }
+  return n;
+}
 
-    constexpr auto triple = ext_gcd_impl(std::integer_sequence<T, arg1[Is]...>(), std::integer_sequence<T, a[Is]...>(),
-                                         std::integer_sequence<T, Is...>());
+// |f a + g b| / 2^Shift for the exact quotient, and all ones if it is negative;
+// |f|, |g| <= 2^Shift take K limbs, so that narrow limbs work too
+template<std::size_t Shift, std::size_t N, typename T>
+constexpr std::pair<big_int<N, T>, T> linear_combination(const big_int<N, T>& a, const big_int<N, T>& b,
+                                                         std::int64_t f, std::int64_t g)
+{
+  constexpr std::size_t digits = std::numeric_limits<T>::digits;
+  constexpr std::size_t K = (Shift + 1 + digits - 1) / digits, L = N + K + 1;
+  auto term = [](const big_int<N, T>& x, std::int64_t c) {
+    const T negative = -static_cast<T>(c < 0);
+    const auto magnitude = static_cast<std::uint64_t>((c ^ -static_cast<std::int64_t>(c < 0)) + (c < 0));
+    big_int<K, T> m{};
+    for (std::size_t i = 0; i < K; ++i)
+      m[i] = static_cast<T>(magnitude >> (i * digits % 64));
+    auto y = to_length<L>(mul(x, m));
+    for (auto& limb : y)
+      limb ^= negative;
+    return add_ignore_carry(y, big_int<L, T>{static_cast<T>(negative & 1)}); // two's complement
+  };
+  auto sum = add_ignore_carry(term(a, f), term(b, g));
+  const T negative = -static_cast<T>(sum[L - 1] >> (digits - 1));
+  for (auto& limb : sum)
+    limb ^= negative;
+  sum = add_ignore_carry(sum, big_int<L, T>{static_cast<T>(negative & 1)});
+  // shift_right takes less than a limb: whole limbs first
+  return {first<N>(shift_right(skip<Shift / digits>(sum), Shift % digits)), negative};
+}
 
-    constexpr auto x = first<N>(triple);
-    constexpr auto y = take<N, 2 * N>(triple);
-    constexpr auto z = skip<2 * N>(triple);
-    constexpr auto qy = partial_mul<N>(qr.quotient, y);
+// The Jacobi symbol (a / b) for odd b by the binary GCD with Pornin's
+// approximations: batches of 30 steps (a odd: swap a and b if a < b, then
+// a -= b; halve a) run on 64-bit words of the top and low 32 bits of a and b,
+// and the accumulated matrix then updates a and b in one pass. The symbol
+// follows from the low bits, which are exact: (2 / b) per halving, and
+// reciprocity per swap. An update that turns a negative multiplies by
+// (-1 / b); b enters only as |b|. With ConstantTime, the number of batches
+// is fixed by the length and every limb is read.
+template<bool ConstantTime, std::size_t N, typename T>
+constexpr int jacobi_binary(big_int<N, T> a, big_int<N, T> b)
+{
+  constexpr std::size_t steps = 30;
+  constexpr std::size_t batches = (2 * N * std::numeric_limits<T>::digits + steps - 1) / steps + 1;
+  if ((b[0] & 1) == 0)
+    throw std::runtime_error("jacobi: the denominator must be odd");
 
-    return join(join(x, subtract_ignore_carry(z, qy)), y);
+  std::uint64_t symbol = 0; // in bit 0: -1
+  for (std::size_t batch = 0; ConstantTime ? batch < batches : !(a == big_int<N, T>{}); ++batch)
+  {
+    big_int<N, T> either;
+    for (std::size_t i = 0; i < N; ++i)
+      either[i] = a[i] | b[i];
+    const auto n = bit_length_ct(either);
+    const std::uint64_t exact = -static_cast<std::uint64_t>(n <= 64); // the low word holds a and b
+    const auto top = n > 64 ? n - 32 : 32;
+    auto approximate = [&](const big_int<N, T>& x) {
+      const auto low = bits32(x, 0);
+      return ((low | bits32(x, 32) << 32) & exact) | ((low | bits32(x, top) << 32) & ~exact);
+    };
+
+    std::uint64_t xa = approximate(a), xb = approximate(b);
+    std::int64_t f0 = 1, g0 = 0, f1 = 0, g1 = 1; // 2^steps (a, b) = (f0 a + g0 b, f1 a + g1 b)
+    for (std::size_t i = 0; i < steps; ++i)
+    {
+      const std::uint64_t odd = -(xa & 1);
+      const std::uint64_t swap = odd & -static_cast<std::uint64_t>(xa < xb);
+      symbol ^= swap & (xa & xb) >> 1;
+      const auto t = swap & (xa ^ xb);
+      xa ^= t;
+      xb ^= t;
+      const auto tf = static_cast<std::int64_t>(swap) & (f0 ^ f1), tg = static_cast<std::int64_t>(swap) & (g0 ^ g1);
+      f0 ^= tf;
+      f1 ^= tf;
+      g0 ^= tg;
+      g1 ^= tg;
+      xa -= odd & xb;
+      f0 -= static_cast<std::int64_t>(odd) & f1;
+      g0 -= static_cast<std::int64_t>(odd) & g1;
+      xa >>= 1;
+      f1 *= 2;
+      g1 *= 2;
+      symbol ^= (xb + 2) >> 2;
+    }
+
+    const auto [a2, negative_a] = linear_combination<steps>(a, b, f0, g0);
+    const auto [b2, negative_b] = linear_combination<steps>(a, b, f1, g1);
+    a = a2;
+    b = b2;
+    symbol ^= negative_a & (b[0] >> 1); // (-1 / b)
   }
+
+  big_int<N, T> one_difference = b;
+  one_difference[0] ^= 1;
+  const bool coprime = one_difference == big_int<N, T>{};
+  return coprime ? 1 - 2 * static_cast<int>(symbol & 1) : 0;
 }
+
 } // namespace detail
 
-export template<typename T, T... A, T... B>
-constexpr auto ext_gcd(std::integer_sequence<T, A...>, std::integer_sequence<T, B...>)
+// The Jacobi symbol (a / b) of a and the odd b: 1 or -1 if they are coprime
+// (for prime b, the Legendre symbol: whether a is a square mod b), else 0.
+// By the binary GCD in batches of 30 steps on 64-bit approximations, several
+// times cheaper than an exponentiation. Throws std::runtime_error for even b.
+export template<std::size_t N1, std::size_t N2, typename T>
+constexpr int jacobi(const big_int<N1, T>& a, const big_int<N2, T>& b)
 {
-  constexpr std::size_t N = std::max(sizeof...(A), sizeof...(B));
-  return detail::ext_gcd_impl(std::integer_sequence<T, A...>{}, std::integer_sequence<T, B...>{},
-                              std::make_integer_sequence<T, N>{});
+  constexpr auto N = std::max(N1, N2);
+  return detail::jacobi_binary<false>(detail::to_length<N>(a), detail::to_length<N>(b));
 }
 
-export template<typename T, T... X, T... Modulus>
-constexpr auto mod_inv(std::integer_sequence<T, X...>, std::integer_sequence<T, Modulus...>)
+// the same in constant time with respect to a and b, for their lengths
+export template<std::size_t N1, std::size_t N2, typename T>
+constexpr int jacobi_ct(const big_int<N1, T>& a, const big_int<N2, T>& b)
 {
+  constexpr auto N = std::max(N1, N2);
+  return detail::jacobi_binary<true>(detail::to_length<N>(a), detail::to_length<N>(b));
+}
 
-  constexpr auto triple = ext_gcd(std::integer_sequence<T, X...>{}, std::integer_sequence<T, Modulus...>{});
-  constexpr auto N = std::max(sizeof...(X), sizeof...(Modulus));
+// The result of ext_gcd for runtime big_ints: a x + b y = gcd, the Bezout
+// coefficients in two's complement with |x| <= b / (2 gcd), |y| <= a / (2 gcd)
+export template<std::size_t N, typename T>
+struct ExtGcdResult
+{
+  big_int<N, T> gcd;
+  big_int<N, T> x;
+  big_int<N, T> y;
+};
 
-  if (triple[0] != 1)
-    throw std::runtime_error("modular inverse does not exist");
-  else
+namespace detail
+{
+
+// Lehmer's leading digits: digits - 3 bits, so that the sum of a digit and a
+// cofactor (below 2^(digits - 3) as well) stays below 2^(digits - 2), and the
+// cofactors of a matrix fit in a limb
+template<typename T>
+inline constexpr std::size_t lehmer_bits = std::numeric_limits<T>::digits - 3;
+
+// the bits [pos, pos + lehmer_bits) of x
+template<std::size_t N, typename T>
+constexpr T lehmer_digit(const big_int<N, T>& x, std::size_t pos)
+{
+  constexpr std::size_t digits = std::numeric_limits<T>::digits;
+  const auto i = pos / digits, s = pos % digits;
+  auto v = static_cast<T>(x[i] >> s);
+  if (s != 0 && i + 1 < N)
+    v |= static_cast<T>(x[i + 1] << (digits - s));
+  return static_cast<T>(v & ((T{1} << lehmer_bits<T>) - 1));
+}
+
+// the matrix ((x0, y0), (x1, y1)) of the Euclidean steps on (a, b) that
+// their leading digits determine, and the number of steps
+struct lehmer_matrix
+{
+  std::int64_t x0, y0, x1, y1;
+  std::size_t steps;
+};
+
+// Lehmer's inner loop (Knuth, Algorithm 4.5.2L) on the leading digits
+// ah >= bh of a and b at the same position: a quotient is that of a and b
+// if it is the same for both bounds (ah + x) / (bh + y) of their ratio, which
+// stay non-negative. The entries alternate in sign, so that x0 >= 0 after an
+// even number of steps, and stay below 2^lehmer_bits. If the digits are a
+// and b, the quotients are exact.
+template<typename T>
+constexpr lehmer_matrix lehmer_steps(T ah, T bh, bool exact)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto bound = TT{1} << lehmer_bits<T>;
+  constexpr auto sign_bit = static_cast<T>(T{1} << (std::numeric_limits<T>::digits - 1));
+  auto magnitude = [](std::int64_t v) { return static_cast<T>(v < 0 ? -v : v); };
+  // the quotient and remainder of n / d: most quotients are small
+  auto divide = [](T n, T d) {
+    if ((n >> 2) < d)
+    { // q < 4, without branches
+      const T ge1 = n >= d, ge2 = n >= 2 * d, ge3 = n >= 3 * d;
+      const auto r = static_cast<T>(n - (d & -ge1) - (d & -ge2) - (d & -ge3));
+      return std::pair{static_cast<T>(ge1 + ge2 + ge3), r};
+    }
+    const auto q = static_cast<T>(n / d);
+    return std::pair{q, static_cast<T>(n - q * d)};
+  };
+
+  lehmer_matrix m{1, 0, 0, 1, 0};
+  // the matrix of one more step with the quotient q, unless an entry would
+  // reach the bound
+  auto push = [&](T q) {
+    const auto x = magnitude(m.x0) + static_cast<TT>(q) * magnitude(m.x1);
+    const auto y = magnitude(m.y0) + static_cast<TT>(q) * magnitude(m.y1);
+    if (x >= bound || y >= bound)
+      return false;
+    const auto sign = m.steps % 2 == 0 ? 1 : -1; // of the new x1
+    m = {m.x1, m.y1, sign * static_cast<std::int64_t>(x), -sign * static_cast<std::int64_t>(y), m.steps + 1};
+    return true;
+  };
+
+  while (true)
   {
-    using namespace detail;
-    constexpr auto mod_inverse = take<N, 2 * N>(triple);
-    constexpr auto L = tight_length(mod_inverse);
-    return first<L>(mod_inverse);
+    if (exact)
+    {
+      if (bh == 0)
+        break;
+      const auto [q, r] = divide(ah, bh);
+      if (!push(q))
+        break;
+      ah = std::exchange(bh, r);
+      continue;
+    }
+
+    const auto d = static_cast<T>(bh + static_cast<T>(m.x1)), d2 = static_cast<T>(bh + static_cast<T>(m.y1));
+    if (d == 0 || d2 == 0)
+      break;
+    const auto [q, r] = divide(static_cast<T>(ah + static_cast<T>(m.x0)), d);
+    const auto previous = m;
+    if (!push(q))
+      break;
+    // r = (ah - q bh) + x1 with the new x1; the remainder for the other bound
+    // is (ah - q bh) + y1, modulo 2^digits
+    const auto r2 = static_cast<T>(r - static_cast<T>(m.x1) + static_cast<T>(m.y1));
+    if ((r2 & sign_bit) != 0 || r2 >= d2)
+    {
+      m = previous;
+      break;
+    }
+    ah = std::exchange(bh, static_cast<T>(r - static_cast<T>(m.x1)));
   }
+  return m;
 }
-} // namespace lam::cbn
-
-/*
-export template <export template <typename, size_t> class Array = std::array, typename T,
-          T... A, T... B, T... Is>
-constexpr auto ext_gcd_(std::integer_sequence<T, A...>,
-                       std::integer_sequence<T, B...>) {
-  //constexpr std::size_t N = std::max(sizeof...(A), sizeof...(B));
-  //return detail::ext_gcd_impl(std::integer_sequence<T, A...>{},
-  //                            std::integer_sequence<T, B...>{},
-  //                            std::make_integer_sequence<T, N>{});
 
-//export template <std::size_t L, typename T, std::size_t N>
-//constexpr auto ext_gcd_(big_int<N, T> a, big_int<N, T> b) {
+// one limb at a time of the non-negative p u - n v for the limb-sized
+// factors p and n
+template<typename T>
+struct lehmer_row
+{
+  using TT = typename dbl_bitlen<T>::type;
+  T p, n;
+  TT carry_p = 0, carry_n = 0;
+  T borrow = 0;
 
-  using cbn::detail::join;
-  const std::size_t N = sizeof...(A);
+  constexpr T next(T u, T v)
+  {
+    const TT s = static_cast<TT>(p) * u + carry_p, t = static_cast<TT>(n) * v + carry_n;
+    carry_p = s >> std::numeric_limits<T>::digits;
+    carry_n = t >> std::numeric_limits<T>::digits;
+    const auto low_s = static_cast<T>(s), low_t = static_cast<T>(t);
+    const auto d = static_cast<T>(low_s - low_t);
+    const auto r = static_cast<T>(d - borrow);
+    borrow = static_cast<T>((low_s < low_t) | (d < borrow));
+    return r;
+  }
+};
 
-  auto a = big_int<N, T>{A...};
-  auto b = big_int<N, T>{B...};
+// (a, b) <- (x0 a + y0 b, x1 a + y1 b) in place, both non-negative, on
+// the low `length` limbs, which hold a and b
+template<std::size_t N, typename T>
+constexpr void lehmer_apply(big_int<N, T>& a, big_int<N, T>& b, const lehmer_matrix& m, std::size_t length)
+{
+  auto magnitude = [](std::int64_t v) { return static_cast<T>(v < 0 ? -v : v); };
+  const bool odd = m.steps % 2 != 0;
+  lehmer_row<T> row0{magnitude(odd ? m.y0 : m.x0), magnitude(odd ? m.x0 : m.y0)};
+  lehmer_row<T> row1{magnitude(odd ? m.x1 : m.y1), magnitude(odd ? m.y1 : m.x1)};
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    const T u = a[i], v = b[i];
+    a[i] = odd ? row0.next(v, u) : row0.next(u, v);
+    b[i] = odd ? row1.next(u, v) : row1.next(v, u);
+  }
+}
 
-  big_int<N, T> x0{1};
-  big_int<N, T> x1{};
-  big_int<N, T> y0{};
-  big_int<N, T> y1{1};
-  big_int<N, T> zero{};
+// the cofactor magnitudes (c0, c1) <- (|x0| c0 + |y0| c1, |x1| c0 + |y1| c1)
+// in place on the low `length` limbs: the cofactors alternate in sign as the
+// entries do
+template<std::size_t N, typename T>
+constexpr void lehmer_apply_cofactors(big_int<N, T>& c0, big_int<N, T>& c1, const lehmer_matrix& m,
+                                      std::size_t length)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  auto magnitude = [](std::int64_t v) { return static_cast<TT>(v < 0 ? -v : v); };
+  TT carry0 = 0, carry1 = 0;
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    const TT s = magnitude(m.x0) * c0[i] + carry0, t = magnitude(m.y0) * c1[i];
+    const TT u = magnitude(m.x1) * c0[i] + carry1, v = magnitude(m.y1) * c1[i];
+    // the sums of the low halves first, as s + t may not fit
+    const TT low0 = static_cast<TT>(static_cast<T>(s)) + static_cast<T>(t);
+    const TT low1 = static_cast<TT>(static_cast<T>(u)) + static_cast<T>(v);
+    c0[i] = static_cast<T>(low0);
+    c1[i] = static_cast<T>(low1);
+    carry0 = (s >> digits) + (t >> digits) + (low0 >> digits);
+    carry1 = (u >> digits) + (v >> digits) + (low1 >> digits);
+  }
+}
 
+// Euclid's algorithm on runtime big_ints, accelerated by Lehmer's method: a
+// matrix of the quotients that the leading digits determine updates a and b
+// in one pass, and a full division takes the place of a
+// step the digits do not determine. With Cofactor, also the magnitude of
+// the cofactor x of the remainder a = a_0 x (mod b_0), and whether it is
+// negative.
+template<bool Cofactor, std::size_t N, typename T>
+constexpr auto lehmer_gcd(big_int<N, T> a, big_int<N, T> b)
+{
+  const big_int<N, T> zero{};
+  big_int<N, T> c0{1}, c1{}; // |x| of a and b
+  std::size_t cofactor_length = 1;
+  bool negative = false;
+
+  auto division_step = [&] {
+    const auto qr = div(a, b);
+    a = std::exchange(b, qr.remainder);
+    if constexpr (Cofactor)
+      c0 = std::exchange(c1, add_ignore_carry(c0, partial_mul<N>(qr.quotient, c1)));
+    cofactor_length = N;
+    negative = !negative;
+  };
+
+  if (a < b)
+    division_step(); // a swap
   while (b != zero)
   {
-
-    constexpr auto L = detail::tight_length(b);
-    constexpr auto qr = cbn::meta_div<L>(a, b);
-
-    a = b;
-    b = qr.remainder;
-    constexpr auto tmp = x1;
-    x1 = cbn::subtract_ignore_carry(x0, cbn::partial_mul<N>(qr.quotient, x1));
-    x0 = tmp;
-
-    constexpr auto tmp2 = y1;
-    y1 = cbn::subtract_ignore_carry(y0, cbn::partial_mul<N>(qr.quotient, y1));
-    y0 = tmp2;
+    const auto bits = bit_length(a);
+    const auto pos = bits > lehmer_bits<T> ? bits - lehmer_bits<T> : 0;
+    const auto m = lehmer_steps<T>(lehmer_digit(a, pos), lehmer_digit(b, pos), pos == 0);
+    if (m.steps == 0)
+    {
+      division_step();
+      continue;
+    }
+    lehmer_apply(a, b, m, (bits + std::numeric_limits<T>::digits - 1) / std::numeric_limits<T>::digits);
+    if constexpr (Cofactor)
+    { // a matrix adds less than a limb
+      cofactor_length = std::min(N, cofactor_length + 1);
+      lehmer_apply_cofactors(c0, c1, m, cofactor_length);
+    }
+    negative ^= m.steps % 2 != 0;
   }
 
-  return join(a, join(x0, y0));
+  if constexpr (Cofactor)
+    return std::tuple{a, c0, negative};
+  else
+    return a;
 }
-*/
 
-/*
-export
-template <typename T, std::size_t N>
-constexpr auto ext_gcd(big_int<N, T> a, big_int<N, T> b) {
+// -x in two's complement
+template<std::size_t N, typename T>
+constexpr big_int<N, T> negate(const big_int<N, T>& x)
+{ return subtract_ignore_carry(big_int<N, T>{}, x); }
 
-  using detail::pad;
+} // namespace detail
+
+// The greatest common divisor of runtime big_ints, by Lehmer's algorithm
+export template<std::size_t N, typename T>
+constexpr big_int<N, T> gcd(const big_int<N, T>& a, const big_int<N, T>& b)
+{ return detail::lehmer_gcd<false>(a, b); }
+
+// The extended Euclidean algorithm on runtime big_ints, accelerated by
+// Lehmer's method with limb-sized cofactor matrices: in place on the
+// fixed-width remainders and the magnitude of the cofactor of a, whose signs
+// alternate; y = (gcd - a x) / b by one division at the end. The result is
+// that of the plain extended Euclidean algorithm.
+export template<std::size_t N, typename T>
+constexpr ExtGcdResult<N, T> ext_gcd(const big_int<N, T>& a, const big_int<N, T>& b)
+{
   using detail::first;
-  using detail::take;
-  using detail::skip;
-  using detail::join;
-
-  // todo make padding so that outputs have same length in both branches
-  if (a == big_int<N, T>{}) {
-    return join(b, join(big_int<N, T>{0}, big_int<N, T>{1}));
-  } else {
-    constexpr auto qr = div(b, a);
-    constexpr auto rem = qr.remainder;
-    constexpr auto triple = ext_gcd(pad<N - rem.size()>(rem), a);
-
-    constexpr auto x = first<N>(triple);
-    constexpr auto y = take<N, 2 * N>(triple);
-    constexpr auto z = skip<2 * N>(triple);
-
-    constexpr auto qy = mul(qr.quotient, y);
-    return join(join(x, subtract_ignore_carry(z, pad<N - qy.size()>(qy))), y);
-  }
+  using detail::negate;
+  const auto [g, x, negative] = detail::lehmer_gcd<true>(a, b);
+  if (b == big_int<N, T>{})
+    return {g, x, big_int<N, T>{}};
+
+  // |y| = (a |x| -/+ g) / b, with the sign opposite to that of x
+  const auto ax = mul(a, x), g2 = detail::to_length<2 * N>(g);
+  const auto y = first<N>(div(negative ? add_ignore_carry(ax, g2) : subtract_ignore_carry(ax, g2), b).quotient);
+  return {g, negative ? negate(x) : x, negative ? y : negate(y)};
 }
 
-export template <typename T, std::size_t N,
-          T... Modulus>
-constexpr auto mod_inv(big_int<N, T> a, std::integer_sequence<T, Modulus...>) {
+// The extended GCD of compile-time integers, by the iterative ext_gcd on
+// their values (one constant evaluation instead of a template instantiation
+// per Euclidean step): the big_int join of the gcd and the coefficients x
+// and y of a x + b y = gcd, each of the longer length in two's complement.
+// Euclid's algorithm runs on (b, a), which gives x = 1, y = 0 for a = b.
+export template<typename T, T... A, T... B>
+constexpr auto ext_gcd(std::integer_sequence<T, A...>, std::integer_sequence<T, B...>)
+{
+  constexpr std::size_t N = std::max(sizeof...(A), sizeof...(B));
+  constexpr auto r = ext_gcd(big_int<N, T>{B...}, big_int<N, T>{A...});
+  return detail::join(r.gcd, detail::join(r.y, r.x));
+}
 
-  auto modulus = sprout::make_array(Modulus...);
-  auto triple = ext_gcd(a, modulus);
+// The inverse of X modulo Modulus, at its tight length; fails to compile if
+// it does not exist
+export template<typename T, T... X, T... Modulus>
+constexpr auto mod_inv(std::integer_sequence<T, X...>, std::integer_sequence<T, Modulus...>)
+{
+  constexpr std::size_t N = std::max(sizeof...(X), sizeof...(Modulus));
+  constexpr auto r = ext_gcd(big_int<N, T>{Modulus...}, big_int<N, T>{X...}); // r.y X = 1 (mod Modulus)
 
-  if (triple[0] != 1) {
+  if (r.gcd != big_int<N, T>{1})
     throw std::runtime_error("modular inverse does not exist");
-  } else {
-    auto y = detail::take<N, 2 * N>(triple);
-    return y; //barrett_reduction<Modulus...>(y);
+  else
+  {
+    using namespace detail;
+    // the Bezout coefficient lies in [-m/2, m/2], in two's complement: add m if it is negative
+    constexpr bool negative = r.y[N - 1] >> (std::numeric_limits<T>::digits - 1);
+    constexpr auto mod_inverse = negative ? add_ignore_carry(r.y, big_int<N, T>{Modulus...}) : r.y;
+    constexpr auto L = tight_length(mod_inverse);
+    return first<L>(mod_inverse);
   }
 }
-*/
+
+} // namespace lam::cbn
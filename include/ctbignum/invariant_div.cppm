@@ -26,19 +26,23 @@ namespace lam::cbn
 namespace detail
 {
 
-export template<std::size_t N, typename T = std::uint64_t, T... Divisor, std::size_t... Is>
-constexpr auto precompute_m_prime_nontight(std::integer_sequence<T, Divisor...>, std::index_sequence<Is...>)
+// m' = floor(2^(wN) (2^ell - d) / d) + 1 for ell = bit_length(d - 1), the
+// multiplier for dividing N-limb integers by d > 1
+template<std::size_t N, std::size_t D, typename T>
+constexpr big_int<N, T> m_prime(big_int<D, T> d)
 {
-  constexpr auto D = sizeof...(Divisor);
-  constexpr big_int<D, T> d{Divisor...};
-  constexpr auto ell = bit_length(d - big_int<1, T>{1}); // TODO: should this indeed be d-1 ???
+  const auto ell = bit_length(d - big_int<1, T>{1}); // ceil(log2 d), as Granlund-Montgomery require
   constexpr auto w = std::numeric_limits<T>::digits;
-  constexpr auto limb_shifts = ell / w;
-  constexpr auto bit_shifts = ell % w;
-  constexpr auto pow2ell = place_at<std::max(D, limb_shifts + 1), T>(static_cast<T>(1) << bit_shifts, limb_shifts);
+  const auto pow2ell = place_at<std::max(D, N) + 1, T>(static_cast<T>(1) << (ell % w), ell / w);
   constexpr auto pow2N = unary_encoding<N, N + 1, T>();
-  constexpr auto divrem = div(mul(pow2N, subtract(pow2ell, d)), d);
-  constexpr auto mp = to_length<N>(add(divrem.quotient, big_int<1, T>{static_cast<T>(1)}));
+  const auto divrem = div(mul(pow2N, subtract(pow2ell, d)), d);
+  return to_length<N>(add(divrem.quotient, big_int<1, T>{static_cast<T>(1)}));
+}
+
+export template<std::size_t N, typename T = std::uint64_t, T... Divisor, std::size_t... Is>
+constexpr auto precompute_m_prime_nontight(std::integer_sequence<T, Divisor...>, std::index_sequence<Is...>)
+{
+  constexpr auto mp = m_prime<N>(big_int<sizeof...(Divisor), T>{Divisor...});
   return std::integer_sequence<T, mp[Is]...>{};
 }
 
@@ -106,4 +110,94 @@ constexpr DivisionResult<big_int<N, T>, big_int<sizeof...(Modulus), T>> div(big_
   return {quot, rem};
 }
 
+// Division of N-limb integers by a runtime divisor d, with the multiplier
+// m' of quotient() computed once on construction: each quotient then costs a
+// multiplication by m' and shifts, and each remainder one more
+// multiplication by d, instead of a hardware division per quotient limb.
+export template<std::size_t N, typename T = std::uint64_t>
+class invariant_divider
+{
+public:
+  // throws std::runtime_error if d is zero
+  constexpr explicit invariant_divider(big_int<N, T> d) : d_(d)
+  {
+    if (d == big_int<N, T>{})
+      throw std::runtime_error("invariant_divider: division by zero");
+    if (d != big_int<N, T>{1})
+    {
+      m_prime_ = detail::m_prime<N>(d);
+      const auto shift = detail::bit_length(d - big_int<1, T>{1}) - 1;
+      limb_shift_ = shift / std::numeric_limits<T>::digits;
+      bit_shift_ = shift % std::numeric_limits<T>::digits;
+    }
+  }
+
+  constexpr const big_int<N, T>& divisor() const { return d_; }
+
+  constexpr big_int<N, T> quotient(big_int<N, T> n) const
+  {
+    if (m_prime_ == big_int<N, T>{}) // d = 1
+      return n;
+    const auto t1 = detail::skip<N>(mul(m_prime_, n));
+    const auto sum = add(t1, shift_right(subtract_ignore_carry(n, t1), 1)); // n >= t1
+
+    // sum >> (ell - 1)
+    big_int<N, T> q{};
+    for (std::size_t i = 0; i + limb_shift_ < N + 1 && i < N; ++i)
+    {
+      q[i] = sum[i + limb_shift_] >> bit_shift_;
+      if (bit_shift_ != 0 && i + limb_shift_ + 1 < N + 1)
+        q[i] |= sum[i + limb_shift_ + 1] << (std::numeric_limits<T>::digits - bit_shift_);
+    }
+    return q;
+  }
+
+  constexpr big_int<N, T> remainder(big_int<N, T> n) const { return divmod(n).remainder; }
+
+  constexpr DivisionResult<big_int<N, T>, big_int<N, T>> divmod(big_int<N, T> n) const
+  {
+    const auto q = quotient(n);
+    return {q, subtract_ignore_carry(n, partial_mul<N>(d_, q))};
+  }
+
+  // element-wise over spans of numerators; throws std::runtime_error if the
+  // sizes differ
+  void quotient(std::span<const big_int<N, T>> n, std::span<big_int<N, T>> q) const
+  {
+    check_sizes(n.size(), q.size());
+    for (std::size_t i = 0; i < n.size(); ++i)
+      q[i] = quotient(n[i]);
+  }
+
+  void remainder(std::span<const big_int<N, T>> n, std::span<big_int<N, T>> r) const
+  {
+    check_sizes(n.size(), r.size());
+    for (std::size_t i = 0; i < n.size(); ++i)
+      r[i] = remainder(n[i]);
+  }
+
+  void divmod(std::span<const big_int<N, T>> n, std::span<big_int<N, T>> q, std::span<big_int<N, T>> r) const
+  {
+    check_sizes(n.size(), q.size());
+    check_sizes(n.size(), r.size());
+    for (std::size_t i = 0; i < n.size(); ++i)
+    {
+      const auto result = divmod(n[i]);
+      q[i] = result.quotient;
+      r[i] = result.remainder;
+    }
+  }
+
+private:
+  static void check_sizes(std::size_t a, std::size_t b)
+  {
+    if (a != b)
+      throw std::runtime_error("invariant_divider: size mismatch");
+  }
+
+  big_int<N, T> d_;
+  big_int<N, T> m_prime_{};
+  std::size_t limb_shift_ = 0, bit_shift_ = 0;
+};
+
 } // namespace lam::cbn
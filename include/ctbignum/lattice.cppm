@@ -0,0 +1,356 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+module;
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+export module lam.ctbignum:lattice;
+
+import std;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+template<typename Lane>
+struct packed_lane_traits;
+
+template<>
+struct packed_lane_traits<std::int16_t>
+{
+  using wide_type = std::int32_t;
+  using unsigned_type = std::uint16_t;
+  using unsigned_wide_type = std::uint32_t;
+};
+
+template<>
+struct packed_lane_traits<std::int32_t>
+{
+  using wide_type = std::int64_t;
+  using unsigned_type = std::uint32_t;
+  using unsigned_wide_type = std::uint64_t;
+};
+
+} // namespace detail
+
+// Arithmetic modulo a small odd q on packed signed lanes, as used by the
+// lattice schemes Kyber (q = 3329, std::int16_t lanes) and Dilithium
+// (q = 8380417, std::int32_t lanes).
+//
+// Polynomials are plain arrays of lanes holding signed representatives;
+// vectors and matrices of polynomials are stored contiguously, one polynomial
+// after the other (a k x l matrix row by row). Products use signed Montgomery
+// reduction with R = 2^16 resp. 2^32, so that mul(a, b) = a * b / R: keep one
+// operand of every product in Montgomery form (to_montgomery) to obtain plain
+// products. With AVX2, 16 resp. 8 lanes are processed per instruction; the
+// remaining lanes, and all lanes on other targets, take the scalar path, which
+// computes exactly the same values.
+//
+// q must stay below 2^14 resp. 2^30 so that several products can be summed
+// before a reduction.
+export template<typename Lane, Lane Q>
+struct packed_zq
+{
+  static_assert(std::same_as<Lane, std::int16_t> || std::same_as<Lane, std::int32_t>,
+                "packed_zq lanes are std::int16_t or std::int32_t");
+  static_assert(Q > 2 && Q % 2 == 1 && Q <= std::numeric_limits<Lane>::max() / 2,
+                "packed_zq requires an odd modulus below a quarter of the lane range");
+
+  using lane_type = Lane;
+  using wide_type = typename detail::packed_lane_traits<Lane>::wide_type;
+  using unsigned_type = typename detail::packed_lane_traits<Lane>::unsigned_type;
+
+  static constexpr int bits = std::numeric_limits<unsigned_type>::digits;
+  static constexpr Lane q = Q;
+
+  // q^-1 mod 2^bits, by Newton iteration
+  static constexpr Lane qinv = [] {
+    std::uint32_t x = static_cast<std::uint32_t>(Q);
+    for (int i = 0; i < 5; ++i)
+      x *= 2 - static_cast<std::uint32_t>(Q) * x;
+    return static_cast<Lane>(x);
+  }();
+
+  static constexpr Lane montgomery_one = static_cast<Lane>((wide_type{1} << (bits - 1)) % Q * 2 % Q); // R mod q
+  static constexpr Lane montgomery_r2 = static_cast<Lane>(wide_type{montgomery_one} * montgomery_one % Q);
+
+  // Barrett: floor(a / q) is floor(a * barrett_multiplier / 2^barrett_shift)
+  // or one less (a >= 0) resp. one more (a < 0) for every lane value a
+  static constexpr int barrett_shift = bits - 2 + std::bit_width(static_cast<unsigned_type>(Q));
+  static constexpr Lane barrett_multiplier = static_cast<Lane>((std::uint64_t{1} << barrett_shift) / Q);
+
+  // number of products in (-q, q) that can be added to a value in [0, q)
+  static constexpr std::size_t lazy_terms = std::numeric_limits<Lane>::max() / Q - 1;
+
+  // a / R mod q in (-q, q), for |a| < q * 2^(bits - 1)
+  static constexpr Lane montgomery_reduce(wide_type a)
+  {
+    const auto t = static_cast<Lane>(static_cast<std::uint32_t>(a) * static_cast<std::uint32_t>(qinv));
+    return static_cast<Lane>((a - static_cast<wide_type>(t) * Q) >> bits);
+  }
+
+  // a * b / R mod q in (-q, q), for |a| < q (b arbitrary)
+  static constexpr Lane mul(Lane a, Lane b) { return montgomery_reduce(static_cast<wide_type>(a) * b); }
+
+  // canonical representative in [0, q)
+  static constexpr Lane reduce(Lane a)
+  {
+    const auto t = static_cast<Lane>((static_cast<wide_type>(a) * barrett_multiplier) >> barrett_shift);
+    auto r = static_cast<Lane>(a - static_cast<wide_type>(t) * Q); // in [-q, 2q)
+    r = static_cast<Lane>(r >= Q ? r - Q : r);
+    return static_cast<Lane>(r < 0 ? r + Q : r);
+  }
+
+  static constexpr Lane to_montgomery(Lane a) { return mul(reduce(a), montgomery_r2); }
+
+  // Kyber's Compress_q(x, d) = round(2^d / q * x) mod 2^d and
+  // Decompress_q(y, d) = round(q / 2^d * y), for x in [0, q) and y in [0, 2^d)
+  template<int D>
+  static constexpr unsigned_type compress(Lane x)
+  {
+    static_assert(D > 0 && D < bits - 1);
+    using U = typename detail::packed_lane_traits<Lane>::unsigned_wide_type;
+    return static_cast<unsigned_type>((((static_cast<U>(x) << D) + Q / 2) / Q) & ((U{1} << D) - 1));
+  }
+
+  template<int D>
+  static constexpr Lane decompress(unsigned_type y)
+  {
+    static_assert(D > 0 && D < bits - 1);
+    using U = typename detail::packed_lane_traits<Lane>::unsigned_wide_type;
+    return static_cast<Lane>((static_cast<U>(y) * Q + (U{1} << (D - 1))) >> D);
+  }
+
+  // a[i] -> a[i] mod q in [0, q)
+  static void reduce(std::span<Lane> a)
+  {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + lanes <= a.size(); i += lanes)
+      store(a.data() + i, reduce(load(a.data() + i)));
+#endif
+    for (; i < a.size(); ++i)
+      a[i] = reduce(a[i]);
+  }
+
+  // a[i] -> a[i] * R mod q in (-q, q)
+  static void to_montgomery(std::span<Lane> a)
+  {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + lanes <= a.size(); i += lanes)
+      store(a.data() + i, mul(reduce(load(a.data() + i)), _mm256_set1_epi32(pair(montgomery_r2))));
+#endif
+    for (; i < a.size(); ++i)
+      a[i] = to_montgomery(a[i]);
+  }
+
+  // out[i] = a[i] * b[i] / R mod q in (-q, q), for |a[i]| < q; out may alias a or b
+  static void pointwise_montgomery(std::span<Lane> out, std::span<const Lane> a, std::span<const Lane> b)
+  {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + lanes <= out.size(); i += lanes)
+      store(out.data() + i, mul(load(a.data() + i), load(b.data() + i)));
+#endif
+    for (; i < out.size(); ++i)
+      out[i] = mul(a[i], b[i]);
+  }
+
+  // Inner product of two vectors of k polynomials with out.size() coefficients:
+  //   out[i] = sum_j a[j n + i] * b[j n + i] / R mod q in [0, q),
+  // for |a[.]| < q. Sums of up to lazy_terms products are reduced once.
+  static void pointwise_acc_montgomery(std::span<Lane> out, std::span<const Lane> a, std::span<const Lane> b)
+  {
+    const std::size_t n = out.size();
+    if (n == 0 || a.size() != b.size() || a.size() % n != 0)
+      throw std::runtime_error("polynomial vector lengths do not match");
+    const std::size_t k = a.size() / n;
+
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + lanes <= n; i += lanes)
+    {
+      __m256i acc = _mm256_setzero_si256();
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        acc = add(acc, mul(load(a.data() + j * n + i), load(b.data() + j * n + i)));
+        if ((j + 1) % lazy_terms == 0)
+          acc = reduce(acc);
+      }
+      store(out.data() + i, reduce(acc));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+      Lane acc = 0;
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        acc = static_cast<Lane>(acc + mul(a[j * n + i], b[j * n + i]));
+        if ((j + 1) % lazy_terms == 0)
+          acc = reduce(acc);
+      }
+      out[i] = reduce(acc);
+    }
+  }
+
+  // Matrix-vector product over polynomials of n coefficients: with the
+  // rows x cols matrix A (row by row) and the vector s of cols polynomials,
+  // out[r] = sum_c A[r][c] * s[c] / R (coefficient-wise) in [0, q).
+  static void matrix_vector_montgomery(std::span<Lane> out, std::span<const Lane> matrix, std::span<const Lane> vector,
+                                       std::size_t n)
+  {
+    if (n == 0 || out.size() % n != 0 || vector.size() % n != 0 ||
+        matrix.size() != (out.size() / n) * vector.size())
+      throw std::runtime_error("matrix and vector dimensions do not match");
+    const std::size_t rows = out.size() / n;
+    for (std::size_t r = 0; r < rows; ++r)
+      pointwise_acc_montgomery(out.subspan(r * n, n), matrix.subspan(r * vector.size(), vector.size()), vector);
+  }
+
+  // out[i] = compress<D>(a[i]) for a[i] in [0, q)
+  template<int D>
+  static void compress(std::span<unsigned_type> out, std::span<const Lane> a)
+  {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if constexpr (bits == 16)
+    { // (x 2^D + q/2) / q in 32-bit arithmetic, 8 lanes per half
+      for (; i + lanes <= out.size(); i += lanes)
+      {
+        const __m256i x = load(a.data() + i);
+        const __m256i lo = compress_epi32<D>(_mm256_cvtepi16_epi32(_mm256_castsi256_si128(x)));
+        const __m256i hi = compress_epi32<D>(_mm256_cvtepi16_epi32(_mm256_extracti128_si256(x, 1)));
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i), packed);
+      }
+    }
+#endif
+    for (; i < out.size(); ++i)
+      out[i] = compress<D>(a[i]);
+  }
+
+  template<int D>
+  static void decompress(std::span<Lane> out, std::span<const unsigned_type> a)
+  {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    if constexpr (bits == 16)
+    { // mulhrs(y 2^(15 - D), q) = (y q 2^(15 - D) + 2^14) >> 15, with y 2^(15 - D) < 2^15
+      const __m256i vq = _mm256_set1_epi16(Q);
+      for (; i + lanes <= out.size(); i += lanes)
+      {
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.data() + i));
+        store(out.data() + i, _mm256_mulhrs_epi16(_mm256_slli_epi16(y, 15 - D), vq));
+      }
+    }
+#endif
+    for (; i < out.size(); ++i)
+      out[i] = decompress<D>(a[i]);
+  }
+
+private:
+#if defined(__AVX2__)
+  static constexpr std::size_t lanes = 32 / sizeof(Lane);
+
+  static __m256i load(const Lane* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  static void store(Lane* p, __m256i x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+
+  // a lane value replicated to fill 32 bits, for _mm256_set1_epi32
+  static constexpr std::int32_t pair(Lane x)
+  {
+    if constexpr (bits == 16)
+      return static_cast<std::int32_t>(static_cast<std::uint32_t>(static_cast<std::uint16_t>(x)) * 0x10001u);
+    else
+      return x;
+  }
+
+  static __m256i add(__m256i a, __m256i b)
+  {
+    if constexpr (bits == 16)
+      return _mm256_add_epi16(a, b);
+    else
+      return _mm256_add_epi32(a, b);
+  }
+
+  // lane-wise montgomery_reduce(a * b)
+  static __m256i mul(__m256i a, __m256i b)
+  {
+    const __m256i vq = _mm256_set1_epi32(pair(Q));
+    const __m256i vqinv = _mm256_set1_epi32(pair(qinv));
+    if constexpr (bits == 16)
+    { // the low halves of a b and t q agree, so only the high halves are subtracted
+      const __m256i lo = _mm256_mullo_epi16(a, b);
+      const __m256i hi = _mm256_mulhi_epi16(a, b);
+      const __m256i t = _mm256_mullo_epi16(lo, vqinv);
+      return _mm256_sub_epi16(hi, _mm256_mulhi_epi16(t, vq));
+    }
+    else
+    { // even and odd lanes as 64-bit products; results in the high halves
+      const __m256i a_odd = _mm256_srli_epi64(a, 32);
+      const __m256i b_odd = _mm256_srli_epi64(b, 32);
+      const __m256i p_even = _mm256_mul_epi32(a, b);
+      const __m256i p_odd = _mm256_mul_epi32(a_odd, b_odd);
+      const __m256i t_even = _mm256_mul_epi32(_mm256_mul_epi32(p_even, vqinv), vq);
+      const __m256i t_odd = _mm256_mul_epi32(_mm256_mul_epi32(p_odd, vqinv), vq);
+      const __m256i r_even = _mm256_srli_epi64(_mm256_sub_epi64(p_even, t_even), 32);
+      const __m256i r_odd = _mm256_sub_epi64(p_odd, t_odd);
+      return _mm256_blend_epi32(r_even, r_odd, 0xAA);
+    }
+  }
+
+  // lane-wise reduce
+  static __m256i reduce(__m256i a)
+  {
+    const __m256i vq = _mm256_set1_epi32(pair(Q));
+    const __m256i v = _mm256_set1_epi32(pair(barrett_multiplier));
+    if constexpr (bits == 16)
+    {
+      const __m256i t = _mm256_srai_epi16(_mm256_mulhi_epi16(a, v), barrett_shift - 16);
+      __m256i r = _mm256_sub_epi16(a, _mm256_mullo_epi16(t, vq));
+      r = _mm256_sub_epi16(r, _mm256_and_si256(_mm256_cmpgt_epi16(r, _mm256_set1_epi16(Q - 1)), vq));
+      return _mm256_add_epi16(r, _mm256_and_si256(_mm256_srai_epi16(r, 15), vq));
+    }
+    else
+    { // high halves of the 64-bit products a v
+      const __m256i h_even = _mm256_srli_epi64(_mm256_mul_epi32(a, v), 32);
+      const __m256i h_odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), v);
+      const __m256i h = _mm256_blend_epi32(h_even, h_odd, 0xAA);
+      const __m256i t = _mm256_srai_epi32(h, barrett_shift - 32);
+      __m256i r = _mm256_sub_epi32(a, _mm256_mullo_epi32(t, vq));
+      r = _mm256_sub_epi32(r, _mm256_and_si256(_mm256_cmpgt_epi32(r, _mm256_set1_epi32(Q - 1)), vq));
+      return _mm256_add_epi32(r, _mm256_and_si256(_mm256_srai_epi32(r, 31), vq));
+    }
+  }
+
+  // compress<D> of eight 32-bit lanes holding values below 2^15
+  template<int D>
+  static __m256i compress_epi32(__m256i x)
+  {
+    // n / q = floor(n * m / 2^s) for all n < 2^(D + 15), with m = ceil(2^s / q)
+    constexpr int s = 31 + std::bit_width(static_cast<unsigned_type>(Q));
+    constexpr std::uint64_t m = ((std::uint64_t{1} << s) + Q - 1) / Q;
+    static_assert(m < (std::uint64_t{1} << 32) && (m * Q - (std::uint64_t{1} << s)) << (D + 15) < (std::uint64_t{1} << s));
+    const __m256i n = _mm256_add_epi32(_mm256_slli_epi32(x, D), _mm256_set1_epi32(Q / 2));
+    const __m256i vm = _mm256_set1_epi32(static_cast<std::int32_t>(m));
+    const __m256i h_even = _mm256_srli_epi64(_mm256_mul_epu32(n, vm), 32);
+    const __m256i h_odd = _mm256_mul_epu32(_mm256_srli_epi64(n, 32), vm);
+    const __m256i h = _mm256_blend_epi32(h_even, h_odd, 0xAA);
+    return _mm256_and_si256(_mm256_srli_epi32(h, s - 32), _mm256_set1_epi32((1 << D) - 1));
+  }
+#endif
+};
+
+} // namespace lam::cbn
@@ -18,6 +18,7 @@ import :montgomery;
 import :division;
 import :utility;
 import :bitshift;
+import :slicing;
 
 namespace lam::cbn
 {
@@ -28,8 +29,8 @@ constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp, std::integer_sequen
 {
   constexpr auto N = modulus.size();
   constexpr big_int<N, T> m{Modulus...};
-  constexpr auto R_mod_m = div(detail::unary_encoding<N, N + 1>(), m).remainder;
-  constexpr auto Rsq_mod_m = div(detail::unary_encoding<2 * N, 2 * N + 1>(), m).remainder;
+  constexpr auto R_mod_m = div(detail::unary_encoding<N, N + 1, T>(), m).remainder;
+  constexpr auto Rsq_mod_m = div(detail::unary_encoding<2 * N, 2 * N + 1, T>(), m).remainder;
 
   auto result = R_mod_m;
   auto base = montgomery_mul(a, Rsq_mod_m, modulus);
@@ -90,4 +91,382 @@ constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp, big_int<N, T> m)
   return montgomery_mul(result, big_int<N, T>{1}, m, mprime);
 }
 
+// Montgomery arithmetic modulo a runtime odd modulus m with the constants
+// -m^-1 mod beta, R mod m and R^2 mod m (R = beta^N) computed once, for
+// repeated exponentiations with the same modulus.
+export template<std::size_t N, typename T = std::uint64_t>
+struct montgomery_context
+{
+  big_int<N, T> modulus{};
+  T mprime{};
+  big_int<N, T> one{}; // R mod m, the Montgomery form of 1
+  big_int<N, T> r2{};  // R^2 mod m
+
+  constexpr montgomery_context() = default;
+
+  constexpr explicit montgomery_context(big_int<N, T> m)
+    : modulus(m), mprime(-detail::inverse_mod(m[0])), one(div(detail::unary_encoding<N, N + 1, T>(), m).remainder),
+      r2(div(detail::unary_encoding<2 * N, 2 * N + 1, T>(), m).remainder)
+  {
+    if ((m[0] & 1) == 0)
+      throw std::runtime_error("montgomery_context: the modulus must be odd");
+  }
+
+  // x y R^-1 mod m, for x y < m R
+  constexpr big_int<N, T> mul(big_int<N, T> x, big_int<N, T> y) const { return montgomery_mul(x, y, modulus, mprime); }
+
+  // x^2 R^-1 mod m, for x < m; the dedicated squaring pays off from five limbs
+  constexpr big_int<N, T> sqr(big_int<N, T> x) const
+  {
+    if constexpr (N < 5)
+      return mul(x, x);
+    else
+      return montgomery_sqr(x, modulus, mprime);
+  }
+
+  constexpr big_int<N, T> mul_ct(big_int<N, T> x, big_int<N, T> y) const
+  { return montgomery_mul_ct(x, y, modulus, mprime); }
+
+  // x R mod m, for x < R
+  constexpr big_int<N, T> to_montgomery(big_int<N, T> x) const { return mul(x, r2); }
+
+  constexpr big_int<N, T> from_montgomery(big_int<N, T> x) const { return mul(x, big_int<N, T>{1}); }
+};
+
+namespace detail
+{
+
+// bits [pos, pos + w) of x
+template<std::size_t N, typename T>
+constexpr T extract_bits(const big_int<N, T>& x, std::size_t pos, std::size_t w)
+{
+  constexpr std::size_t digits = std::numeric_limits<T>::digits;
+  const std::size_t limb = pos / digits, offset = pos % digits;
+  T v = x[limb] >> offset;
+  if (offset + w > digits && limb + 1 < N)
+    v |= x[limb + 1] << (digits - offset);
+  return v & ((T{1} << w) - 1);
+}
+
+// table[index], reading every entry
+template<std::size_t N, typename T, std::size_t L>
+constexpr big_int<N, T> lookup_ct(const std::array<big_int<N, T>, L>& table, T index)
+{
+  big_int<N, T> r{};
+  for (std::size_t j = 0; j < L; ++j)
+  {
+    const T mask = -static_cast<T>(j == index);
+    for (std::size_t k = 0; k < N; ++k)
+      r[k] |= table[j][k] & mask;
+  }
+  return r;
+}
+
+// window width of the fixed-window exponentiation for exponents of the given bit length
+constexpr std::size_t exp_window_bits(std::size_t bits)
+{ return bits > 512 ? 5 : (bits > 64 ? 4 : 3); }
+
+// x^exp for x in Montgomery form, in Montgomery form, by fixed windows of w
+// bits from the top: w squarings and one multiplication by a precomputed
+// power of x per window.
+//
+// With ConstantTime, every window multiplies (by one for a zero digit), the
+// table lookup reads every entry, and products are reduced by a mask; the
+// sequence of operations then depends only on the lengths of x and exp.
+template<bool ConstantTime, std::size_t N, std::size_t N2, typename T>
+constexpr big_int<N, T> mod_exp_window(big_int<N, T> x, const big_int<N2, T>& exp, const montgomery_context<N, T>& ctx)
+{
+  constexpr std::size_t bits = N2 * std::numeric_limits<T>::digits;
+  constexpr std::size_t w = exp_window_bits(bits);
+  constexpr std::size_t windows = (bits + w - 1) / w;
+
+  auto mul = [&](const big_int<N, T>& a, const big_int<N, T>& b) {
+    if constexpr (ConstantTime)
+      return ctx.mul_ct(a, b);
+    else
+      return ctx.mul(a, b);
+  };
+
+  std::array<big_int<N, T>, std::size_t{1} << w> table;
+  table[0] = ctx.one;
+  table[1] = x;
+  for (std::size_t i = 2; i < table.size(); ++i)
+    table[i] = mul(table[i - 1], x);
+
+  std::size_t i = windows - 1;
+  if constexpr (!ConstantTime)
+    while (i > 0 && extract_bits(exp, i * w, w) == 0) // skip leading zero windows
+      --i;
+
+  big_int<N, T> result;
+  if constexpr (ConstantTime)
+    result = lookup_ct(table, extract_bits(exp, i * w, w));
+  else
+    result = table[extract_bits(exp, i * w, w)];
+
+  while (i-- > 0)
+  {
+    for (std::size_t j = 0; j < w; ++j)
+      if constexpr (ConstantTime)
+        result = mul(result, result);
+      else
+        result = ctx.sqr(result);
+    const T digit = extract_bits(exp, i * w, w);
+    if constexpr (ConstantTime)
+      result = mul(result, lookup_ct(table, digit));
+    else if (digit != 0)
+      result = mul(result, table[digit]);
+  }
+  return result;
+}
+
+} // namespace detail
+
+// modular exponentiation a^exp mod m with a precomputed Montgomery context,
+// by fixed windows; a must be below R = beta^N
+export template<std::size_t N, std::size_t N2, typename T>
+constexpr auto mod_exp(big_int<N, T> a, big_int<N2, T> exp, const montgomery_context<N, T>& ctx)
+{ return ctx.from_montgomery(detail::mod_exp_window<false>(ctx.to_montgomery(a), exp, ctx)); }
+
+// the same in constant time with respect to a and exp: for secret exponents
+export template<std::size_t N, std::size_t N2, typename T>
+constexpr auto mod_exp_ct(big_int<N, T> a, big_int<N2, T> exp, const montgomery_context<N, T>& ctx)
+{
+  auto x = ctx.mul_ct(a, ctx.r2);
+  return ctx.mul_ct(detail::mod_exp_window<true>(x, exp, ctx), big_int<N, T>{1});
+}
+
+// Exponentiation of a fixed base g modulo an odd modulus m, for exponents of
+// up to ExpBits bits, by a precomputed table of
+//   g^(d 2^(W i)) R mod m,   0 <= i < ExpBits / W,  1 <= d < 2^W.
+// g^e is then the product of one entry per nonzero W-bit digit of e: about
+// ExpBits / W multiplications and no squarings, for a table of
+// (ExpBits / W) (2^W - 1) residues, aligned to cache lines.
+//
+// The table is built at compile time from g and m as integer_sequences, or
+// at runtime from a big_int base and a montgomery_context. It is held by
+// value (a std::array, so that the object can be constexpr) and takes
+// table_bytes: 30 KB for 256 bits and W = 4, but about 1.4 MB for 1024 bits and
+// W = 6, so large runtime tables belong on the heap (std::make_unique), not
+// on the stack.
+export template<std::size_t N, typename T = std::uint64_t, std::size_t ExpBits = N * std::numeric_limits<T>::digits,
+                std::size_t W = 4>
+class fixed_base_exp
+{
+  static_assert(W >= 1 && W < std::numeric_limits<T>::digits, "invalid window width");
+  static constexpr std::size_t windows = (ExpBits + W - 1) / W;
+  static constexpr std::size_t digits = (std::size_t{1} << W) - 1;
+
+public:
+  static constexpr std::size_t table_bytes = windows * digits * sizeof(big_int<N, T>);
+
+  constexpr fixed_base_exp(big_int<N, T> g, const montgomery_context<N, T>& ctx) : ctx_(ctx)
+  {
+    auto power = ctx_.to_montgomery(g); // g^(2^(W i))
+    for (std::size_t i = 0; i < windows; ++i)
+    {
+      table_[i][0] = power;
+      for (std::size_t d = 1; d < digits; ++d)
+        table_[i][d] = ctx_.mul(table_[i][d - 1], power);
+      if (i + 1 < windows)
+        power = ctx_.mul(table_[i][digits - 1], power);
+    }
+  }
+
+  template<T... G, T... Modulus>
+  constexpr fixed_base_exp(std::integer_sequence<T, G...>, std::integer_sequence<T, Modulus...>)
+    : fixed_base_exp(big_int<N, T>{G...}, montgomery_context<N, T>{big_int<N, T>{Modulus...}})
+  {
+    static_assert(sizeof...(Modulus) == N, "the modulus must have N limbs");
+  }
+
+  constexpr const montgomery_context<N, T>& context() const { return ctx_; }
+
+  // g^exp mod m
+  template<std::size_t N2>
+  constexpr big_int<N, T> operator()(const big_int<N2, T>& exp) const
+  {
+    if (detail::bit_length(exp) > ExpBits)
+      throw std::runtime_error("fixed_base_exp: the exponent exceeds the table");
+
+    constexpr std::size_t used = std::min(windows, (N2 * std::numeric_limits<T>::digits + W - 1) / W);
+    auto result = ctx_.one;
+    for (std::size_t i = 0; i < used; ++i)
+      if (const T d = detail::extract_bits(exp, i * W, W); d != 0)
+        result = ctx_.mul(result, table_[i][d - 1]);
+    return ctx_.from_montgomery(result);
+  }
+
+private:
+  montgomery_context<N, T> ctx_;
+  alignas(64) std::array<std::array<big_int<N, T>, digits>, windows> table_{};
+};
+
+namespace detail
+{
+
+// L residues of N limbs, limb-major: v[j][l] is limb j of lane l
+template<std::size_t L, std::size_t N, typename T>
+using lane_int = std::array<std::array<T, L>, N>;
+
+// r = x y R^-1 mod m lane by lane. The lane loops are innermost, so that the
+// carry chains of the L products interleave (and vectorize for narrow limbs)
+// instead of the core waiting on one chain at a time; the final subtraction
+// of m is selected by a mask.
+template<std::size_t L, std::size_t N, typename T>
+constexpr void montgomery_mul_lanes(lane_int<L, N, T>& r, const lane_int<L, N, T>& x, const lane_int<L, N, T>& y,
+                                    const big_int<N, T>& m, T mprime)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  lane_int<L, N + 1, T> A{};
+
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    std::array<T, L> u, k, k2;
+    for (std::size_t l = 0; l < L; ++l)
+    {
+      u[l] = (A[0][l] + x[i][l] * y[0][l]) * mprime;
+      TT z = static_cast<TT>(y[0][l]) * x[i][l] + A[0][l];
+      TT z2 = static_cast<TT>(m[0]) * u[l] + static_cast<T>(z);
+      k[l] = z >> digits;
+      k2[l] = z2 >> digits;
+    }
+    for (std::size_t j = 1; j < N; ++j)
+      for (std::size_t l = 0; l < L; ++l)
+      {
+        TT t = static_cast<TT>(y[j][l]) * x[i][l] + A[j][l] + k[l];
+        TT t2 = static_cast<TT>(m[j]) * u[l] + static_cast<T>(t) + k2[l];
+        A[j - 1][l] = t2;
+        k[l] = t >> digits;
+        k2[l] = t2 >> digits;
+      }
+    for (std::size_t l = 0; l < L; ++l)
+    {
+      TT tmp = static_cast<TT>(A[N][l]) + k[l] + k2[l];
+      A[N - 1][l] = tmp;
+      A[N][l] = tmp >> digits;
+    }
+  }
+
+  // A - m, kept where it does not borrow
+  std::array<T, L> borrow{};
+  for (std::size_t j = 0; j < N; ++j)
+    for (std::size_t l = 0; l < L; ++l)
+    {
+      const T d = A[j][l] - m[j];
+      r[j][l] = d - borrow[l];
+      borrow[l] = (A[j][l] < m[j]) | (d < borrow[l]);
+    }
+  for (std::size_t l = 0; l < L; ++l)
+    borrow[l] = -static_cast<T>(borrow[l] > A[N][l]);
+  for (std::size_t j = 0; j < N; ++j)
+    for (std::size_t l = 0; l < L; ++l)
+      r[j][l] = (r[j][l] & ~borrow[l]) | (A[j][l] & borrow[l]);
+}
+
+// L exponentiations of mod_exp_window in lock step, each multiplication
+// interleaved over the lanes; lanes with a zero digit multiply by one
+template<std::size_t L, std::size_t N, std::size_t N2, typename T>
+constexpr void mod_exp_lanes(lane_int<L, N, T>& r, const lane_int<L, N, T>& a, const std::array<big_int<N2, T>, L>& exp,
+                             const montgomery_context<N, T>& ctx)
+{
+  constexpr std::size_t bits = N2 * std::numeric_limits<T>::digits;
+  constexpr std::size_t w = exp_window_bits(bits);
+  constexpr std::size_t windows = (bits + w - 1) / w;
+  using lanes = lane_int<L, N, T>;
+
+  auto mul = [&](lanes& out, const lanes& x, const lanes& y) {
+    montgomery_mul_lanes(out, x, y, ctx.modulus, ctx.mprime);
+  };
+  auto broadcast = [](lanes& out, const big_int<N, T>& x) {
+    for (std::size_t j = 0; j < N; ++j)
+      out[j].fill(x[j]);
+  };
+  auto digit = [&](std::size_t i, std::size_t l) { return extract_bits(exp[l], i * w, w); };
+
+  lanes operand;
+  broadcast(operand, ctx.r2);
+  std::array<lanes, std::size_t{1} << w> table; // table[d] = a^d lane by lane
+  broadcast(table[0], ctx.one);
+  mul(table[1], a, operand);
+  for (std::size_t d = 2; d < table.size(); ++d)
+    mul(table[d], table[d - 1], table[1]);
+
+  auto gather = [&](lanes& out, std::size_t i) {
+    for (std::size_t l = 0; l < L; ++l)
+    {
+      const auto& entry = table[digit(i, l)];
+      for (std::size_t j = 0; j < N; ++j)
+        out[j][l] = entry[j][l];
+    }
+  };
+
+  std::size_t i = windows - 1;
+  auto zero_window = [&](std::size_t i) {
+    for (std::size_t l = 0; l < L; ++l)
+      if (digit(i, l) != 0)
+        return false;
+    return true;
+  };
+  while (i > 0 && zero_window(i)) // skip leading windows that are zero in every lane
+    --i;
+
+  gather(r, i);
+  while (i-- > 0)
+  {
+    for (std::size_t j = 0; j < w; ++j)
+      mul(r, r, r);
+    gather(operand, i);
+    mul(r, r, operand);
+  }
+
+  broadcast(operand, big_int<N, T>{1});
+  mul(r, r, operand);
+}
+
+} // namespace detail
+
+// out[i] = bases[i]^exps[i] mod m for independent exponentiations with one
+// modulus. Lanes (2, 4 or 8) exponentiations run in lock step, with their
+// Montgomery multiplications interleaved limb by limb; the remaining ones
+// run one at a time. This pays off where one carry chain leaves the
+// multiplier idle: narrow limbs, whose lanes vectorize, and short moduli.
+// The bases must be below R = beta^N; throws std::runtime_error if the
+// spans differ in size.
+export template<std::size_t Lanes = 8, std::size_t N, std::size_t N2, typename T>
+void mod_exp_batch(std::span<std::type_identity_t<big_int<N, T>>> out,
+                   std::span<const std::type_identity_t<big_int<N, T>>> bases, std::span<const big_int<N2, T>> exps,
+                   const montgomery_context<N, T>& ctx)
+{
+  static_assert(Lanes == 2 || Lanes == 4 || Lanes == 8, "mod_exp_batch interleaves 2, 4 or 8 exponentiations");
+  if (bases.size() != out.size() || exps.size() != out.size())
+    throw std::runtime_error("mod_exp_batch: size mismatch");
+
+  std::size_t i = 0;
+  for (; i + Lanes <= out.size(); i += Lanes)
+  {
+    detail::lane_int<Lanes, N, T> a, r;
+    std::array<big_int<N2, T>, Lanes> e;
+    for (std::size_t l = 0; l < Lanes; ++l)
+    {
+      for (std::size_t j = 0; j < N; ++j)
+        a[j][l] = bases[i + l][j];
+      e[l] = exps[i + l];
+    }
+    detail::mod_exp_lanes(r, a, e, ctx);
+    for (std::size_t l = 0; l < Lanes; ++l)
+      for (std::size_t j = 0; j < N; ++j)
+        out[i + l][j] = r[j][l];
+  }
+  for (; i < out.size(); ++i)
+    out[i] = mod_exp(bases[i], exps[i], ctx);
+}
+
+export template<std::size_t Lanes = 8, std::size_t N, std::size_t N2, typename T>
+void mod_exp_batch(std::span<std::type_identity_t<big_int<N, T>>> out,
+                   std::span<const std::type_identity_t<big_int<N, T>>> bases, std::span<const big_int<N2, T>> exps,
+                   big_int<N, T> m)
+{ mod_exp_batch<Lanes>(out, bases, exps, montgomery_context<N, T>{m}); }
+
 } // namespace lam::cbn
@@ -14,59 +14,24 @@ export module lam.ctbignum:mod_inv;
 import std;
 
 import :bigint;
-import :utility;
 import :addition;
-import :bitshift;
+import :relational;
+import :gcd;
 
 namespace lam::cbn
 {
 
-// Niels Moller's inversion algorithm
-// see:
-// "Fast Software Polynomial Multiplication
-// on ARM Processors Using the NEON Engine", Algorithm 5
-// (its exposition contains a typo: v must be initialized to 0 instead of 1)
-//
-// This version is not constant-time;
-// it can be made constant-time using conditional adds/subs/swaps.
+// The inverse of x modulo n > 0 for runtime big_ints, from the Bezout
+// coefficient of x by ext_gcd (Lehmer's algorithm), for odd and even moduli
+// alike. Throws std::runtime_error if x is not invertible. Not constant-time.
 export template<std::size_t N, typename T>
-constexpr auto mod_inv(big_int<N, T> const& x, big_int<N, T> const& n)
+constexpr big_int<N, T> mod_inv(const big_int<N, T>& x, const big_int<N, T>& n)
 {
-  using detail::first;
-  using detail::to_length;
-  using std::tie;
-  using std::tuple;
-
-  big_int<N, T> a{x};
-  big_int<N, T> b{n};
-  big_int<N, T> u{1};
-  big_int<N, T> v{0};
-
-  int ell = detail::bit_length(n);
-
-  for (int i = 0; i < 2 * ell; ++i)
-  {
-
-    T odd = a[0] & 1;
-    T gteq = (a >= b);
-    if (odd && gteq)
-      a = subtract_ignore_carry(a, b);
-    else if (odd && !gteq)
-      tie(a, b, u, v) = tuple(subtract_ignore_carry(b, a), a, v, u);
-    a = shift_right(a, 1);
-
-    T gteq2 = (u >= v);
-
-    if (odd && gteq2)
-      u = subtract_ignore_carry(u, v);
-    else if (odd && !gteq2)
-      u = first<N>(subtract(add_same(u, n), v));
-
-    auto tmp = to_length<N + 1>(u);
-    if (u[0] & 1)
-      tmp = add(u, n);
-    u = detail::first<N>(shift_right(tmp, 1));
-  }
-  return v;
+  const auto [g, coefficient, y] = ext_gcd(x, n);
+  if (g != big_int<N, T>{1})
+    throw std::runtime_error("modular inverse does not exist");
+  const bool negative = coefficient[N - 1] >> (std::numeric_limits<T>::digits - 1);
+  return negative ? add_ignore_carry(coefficient, n) : coefficient;
 }
+
 } // namespace lam::cbn
@@ -14,6 +14,8 @@ export module lam.ctbignum:montgomery;
 import std;
 
 import :bigint;
+import :slicing;
+import :relational;
 import :mod_inv;
 import :gcd;
 import :mult;
@@ -123,6 +125,86 @@ struct Identity
 };
 template<typename T>
 using Identity_t = typename Identity<T>::type;
+
+// A R^-1 mod m, up to one multiple of m (the result lies in [0, 2m))
+template<typename T, std::size_t N1, std::size_t N2>
+constexpr auto montgomery_reduction_unreduced(big_int<N1, T> A, big_int<N2, T> m, T mprime)
+{
+  auto accum = pad<1>(A);
+
+  for (auto i = 0; i < N2; ++i)
+  {
+    auto prod = short_mul(m, accum[i] * mprime);
+    auto prod2 = limbwise_shift_left<N1 + 1>(prod, i);
+    accum = add_ignore_carry(accum, prod2);
+  }
+
+  return skip<N2>(accum);
+}
+
+// x y R^-1 mod m, up to one multiple of m (the result lies in [0, 2m))
+template<typename T, std::size_t N>
+constexpr auto montgomery_mul_unreduced(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m, T mprime)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  big_int<N + 1, T> A{};
+
+  for (auto i = 0; i < N; ++i)
+  {
+    T u_i = (A[0] + x[i] * y[0]) * mprime;
+
+    // A += x[i] * y + u_i * m followed by a 1 limb-shift to the right
+    T k = 0;
+    T k2 = 0;
+
+    TT z = static_cast<TT>(y[0]) * static_cast<TT>(x[i]) + A[0] + k;
+    TT z2 = static_cast<TT>(m[0]) * static_cast<TT>(u_i) + static_cast<T>(z) + k2;
+    k = z >> std::numeric_limits<T>::digits;
+    k2 = z2 >> std::numeric_limits<T>::digits;
+
+    for (auto j = 1; j < N; ++j)
+    {
+      TT t = static_cast<TT>(y[j]) * static_cast<TT>(x[i]) + A[j] + k;
+      TT t2 = static_cast<TT>(m[j]) * static_cast<TT>(u_i) + static_cast<T>(t) + k2;
+      A[j - 1] = t2;
+      k = t >> std::numeric_limits<T>::digits;
+      k2 = t2 >> std::numeric_limits<T>::digits;
+    }
+
+    TT tmp = static_cast<TT>(A[N]) + k + k2;
+    A[N - 1] = tmp;
+    A[N] = tmp >> std::numeric_limits<T>::digits;
+  }
+  return A;
+}
+
+// a if mask is zero, b if mask is all ones
+template<typename T, std::size_t N>
+constexpr big_int<N, T> select_ct(T mask, big_int<N, T> a, big_int<N, T> b)
+{
+  big_int<N, T> r;
+  for (std::size_t i = 0; i < N; ++i)
+    r[i] = (a[i] & ~mask) | (b[i] & mask);
+  return r;
+}
+
+// a mod m for a < 2m (N + 1 limbs), without branches on a
+template<typename T, std::size_t N>
+constexpr big_int<N, T> reduce_once_ct(big_int<N + 1, T> a, big_int<N, T> m)
+{
+  big_int<N + 1, T> d;
+  T borrow = 0;
+  for (std::size_t i = 0; i <= N; ++i)
+  {
+    T mi = i < N ? m[i] : T{0};
+    T diff = a[i] - mi;
+    T b1 = a[i] < mi;
+    d[i] = diff - borrow;
+    borrow = b1 | (diff < borrow);
+  }
+  // no borrow: a >= m, take a - m
+  return select_ct(static_cast<T>(borrow - 1), first<N>(a), first<N>(d));
+}
 } // namespace detail
 
 // Runtime-parameter variants
@@ -143,21 +225,9 @@ export template<typename T, std::size_t N1, std::size_t N2>
 constexpr auto montgomery_reduction(big_int<N1, T> A, big_int<N2, T> m, detail::Identity_t<T> mprime)
 {
   using detail::first;
-  using detail::limbwise_shift_left;
   using detail::pad;
-  using detail::skip;
-  using detail::unary_encoding;
 
-  auto accum = pad<1>(A);
-
-  for (auto i = 0; i < N2; ++i)
-  {
-    auto prod = short_mul(m, accum[i] * mprime);
-    auto prod2 = limbwise_shift_left<N1 + 1>(prod, i);
-    accum = add_ignore_carry(accum, prod2);
-  }
-
-  auto result = skip<N2>(accum);
+  auto result = detail::montgomery_reduction_unreduced(A, m, mprime);
 
   auto padded_mod = pad<1>(m);
   if (result >= padded_mod)
@@ -174,44 +244,90 @@ constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m,
 {
   using detail::first;
   using detail::pad;
-  using detail::skip;
 
+  auto A = detail::montgomery_mul_unreduced(x, y, m, mprime);
+
+  auto padded_mod = pad<1>(m);
+  if (A >= padded_mod)
+    A = subtract_ignore_carry(A, padded_mod);
+  return first<N>(A);
+}
+
+// x^2 R^-1 mod m, for x < m: the square from the products x_i x_j, i < j,
+// doubled, and the diagonal x_i^2 (N (N + 1) / 2 limb products instead of
+// N^2), followed by a separate Montgomery reduction
+export template<typename T, std::size_t N>
+constexpr auto montgomery_sqr(big_int<N, T> x, big_int<N, T> m, detail::Identity_t<T> mprime)
+{
   using TT = typename dbl_bitlen<T>::type;
-  big_int<N + 1, T> A{};
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  big_int<2 * N, T> A{};
 
-  for (auto i = 0; i < N; ++i)
+  for (std::size_t i = 0; i + 1 < N; ++i)
   {
-    T u_i = (A[0] + x[i] * y[0]) * mprime;
-
-    // A += x[i] * y + u_i * m followed by a 1 limb-shift to the right
     T k = 0;
-    T k2 = 0;
+    for (std::size_t j = i + 1; j < N; ++j)
+    {
+      const TT t = static_cast<TT>(x[i]) * x[j] + A[i + j] + k;
+      A[i + j] = static_cast<T>(t);
+      k = static_cast<T>(t >> digits);
+    }
+    A[i + N] = k;
+  }
 
-    TT z = static_cast<TT>(y[0]) * static_cast<TT>(x[i]) + A[0] + k;
-    TT z2 = static_cast<TT>(m[0]) * static_cast<TT>(u_i) + static_cast<T>(z) + k2;
-    k = z >> std::numeric_limits<T>::digits;
-    k2 = z2 >> std::numeric_limits<T>::digits;
+  T carry = 0;
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    // A[2i, 2i + 1] = 2 A[2i, 2i + 1] + x_i^2 + carry
+    const TT sq = static_cast<TT>(x[i]) * x[i];
+    const T lo = A[2 * i], hi = A[2 * i + 1];
+    const TT t0 = (static_cast<TT>(lo) << 1) + static_cast<T>(sq) + carry;
+    const TT t1 = (static_cast<TT>(hi) << 1) + static_cast<T>(sq >> digits) + static_cast<T>(t0 >> digits);
+    A[2 * i] = static_cast<T>(t0);
+    A[2 * i + 1] = static_cast<T>(t1);
+    carry = static_cast<T>(t1 >> digits);
+  }
 
-    for (auto j = 1; j < N; ++j)
+  T top = 0; // the carry above A[2N - 1]
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    const T u = static_cast<T>(A[i] * mprime);
+    T k = 0;
+    for (std::size_t j = 0; j < N; ++j)
     {
-      TT t = static_cast<TT>(y[j]) * static_cast<TT>(x[i]) + A[j] + k;
-      TT t2 = static_cast<TT>(m[j]) * static_cast<TT>(u_i) + static_cast<T>(t) + k2;
-      A[j - 1] = t2;
-      k = t >> std::numeric_limits<T>::digits;
-      k2 = t2 >> std::numeric_limits<T>::digits;
+      const TT t = static_cast<TT>(m[j]) * u + A[i + j] + k;
+      A[i + j] = static_cast<T>(t);
+      k = static_cast<T>(t >> digits);
     }
-
-    TT tmp = static_cast<TT>(A[N]) + k + k2;
-    A[N - 1] = tmp;
-    A[N] = tmp >> std::numeric_limits<T>::digits;
+    const TT t = static_cast<TT>(A[i + N]) + k + top;
+    A[i + N] = static_cast<T>(t);
+    top = static_cast<T>(t >> digits);
   }
 
-  auto padded_mod = pad<1>(m);
-  if (A >= padded_mod)
-    A = subtract_ignore_carry(A, padded_mod);
-  return first<N>(A);
+  big_int<N + 1, T> result{};
+  for (std::size_t i = 0; i < N; ++i)
+    result[i] = A[N + i];
+  result[N] = top;
+  const auto padded_mod = detail::pad<1>(m);
+  if (result >= padded_mod)
+    result = subtract_ignore_carry(result, padded_mod);
+  return detail::first<N>(result);
 }
 
+// Constant-time variants of the above for secret operands (e.g. private
+// keys): the final subtraction of m is selected by a mask rather than a
+// branch, so that the instruction sequence depends only on the lengths.
+export template<typename T, std::size_t N1, std::size_t N2>
+constexpr auto montgomery_reduction_ct(big_int<N1, T> A, big_int<N2, T> m, detail::Identity_t<T> mprime)
+{
+  static_assert(N1 <= 2 * N2, "the input must be below m * R");
+  return detail::reduce_once_ct(detail::to_length<N2 + 1>(detail::montgomery_reduction_unreduced(A, m, mprime)), m);
+}
+
+export template<typename T, std::size_t N>
+constexpr auto montgomery_mul_ct(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m, detail::Identity_t<T> mprime)
+{ return detail::reduce_once_ct(detail::montgomery_mul_unreduced(x, y, m, mprime), m); }
+
 namespace detail
 {
 // inverse modulo 2^(limb-width) (needed for the montgomery representation)
@@ -228,5 +344,145 @@ constexpr T inverse_mod(T a)
     x += x - a * x * x;
   return x;
 }
+
+// inverse of an odd a modulo 2^(limb-width N), by Newton's iteration
+// x <- x (2 - a x) from the single-limb inverse; each step doubles the
+// number of correct limbs
+export template<std::size_t N, typename T>
+constexpr big_int<N, T> inverse_mod(big_int<N, T> a)
+{
+  big_int<N, T> x{};
+  x[0] = inverse_mod(a[0]);
+  for (std::size_t k = 1; k < N; k *= 2)
+  {
+    auto e = partial_mul<N>(a, x); // 1 modulo 2^(limb-width k)
+    e[0] -= 1;
+    x = subtract_ignore_carry(x, partial_mul<N>(x, e));
+  }
+  return x;
+}
+
+// u / v for the odd v < beta, if v divides u: the quotient q = u v^-1 mod
+// beta^M limb by limb from the least significant end (Jebelean, "An
+// algorithm for exact division", 1993), and the borrow c with
+// u = q v - c beta^M, which is zero exactly if v divides u
+template<std::size_t M, typename T>
+constexpr std::pair<big_int<M, T>, T> bdiv_by_limb(const big_int<M, T>& u, T v)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  const T inv = inverse_mod(v);
+  big_int<M, T> q{};
+  T c = 0;
+  for (std::size_t i = 0; i < M; ++i)
+  {
+    const T l = static_cast<T>(u[i] - c);
+    c = u[i] < c;
+    q[i] = static_cast<T>(l * inv);
+    c += static_cast<T>(static_cast<TT>(q[i]) * v >> std::numeric_limits<T>::digits);
+  }
+  return {q, c};
+}
+
+// u / v for the odd n-limb v dividing u, in the same way with a multi-limb v:
+// the quotient has at most M - n + 1 limbs, and only as many limbs of u take
+// part
+template<std::size_t M, typename T>
+constexpr big_int<M, T> bdiv_q(big_int<M, T> u, const T* v, std::size_t n)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  big_int<M, T> q{};
+  if (n > M)
+    return q;
+
+  const T inv = inverse_mod(v[0]);
+  const std::size_t qn = M - n + 1;
+  for (std::size_t i = 0; i < qn; ++i)
+  {
+    q[i] = static_cast<T>(u[i] * inv);
+
+    // u -= q_i v beta^i modulo beta^qn
+    T k = 0;
+    std::size_t j = i;
+    for (; j < qn && j - i < n; ++j)
+    {
+      const TT t = static_cast<TT>(q[i]) * v[j - i] + k;
+      const T lo = static_cast<T>(t);
+      k = static_cast<T>((t >> std::numeric_limits<T>::digits) + (u[j] < lo));
+      u[j] = static_cast<T>(u[j] - lo);
+    }
+    for (; j < qn && k != 0; ++j)
+    {
+      const T t = u[j];
+      u[j] = static_cast<T>(t - k);
+      k = t < k;
+    }
+  }
+  return q;
+}
+
+// u and v without the factors of two of v, in M limbs
+template<std::size_t M, std::size_t N, typename T>
+constexpr std::pair<big_int<M, T>, big_int<M, T>> remove_twos(const big_int<M, T>& u, const big_int<N, T>& v)
+{
+  std::size_t limbs = 0;
+  while (v[limbs] == 0)
+    ++limbs;
+  const auto bits = std::countr_zero(v[limbs]);
+
+  big_int<M + 1, T> us{};
+  big_int<M + 1, T> vs{};
+  for (std::size_t i = limbs; i < M; ++i)
+    us[i - limbs] = u[i];
+  for (std::size_t i = limbs; i < N && i - limbs <= M; ++i)
+    vs[i - limbs] = v[i];
+  return {first<M>(shift_right(us, bits)), first<M>(shift_right(vs, bits))};
+}
 } // namespace detail
+
+// Exact division: u / v for v dividing u, from the least significant limbs
+// by the inverse of v modulo a power of beta (after removing the factors of
+// two of v) in place of the quotient digit estimates of div. The result is
+// unspecified if v does not divide u; 0 for v = 0, as div.
+export template<std::size_t M, std::size_t N, typename T>
+constexpr big_int<M, T> divexact(big_int<M, T> u, big_int<N, T> v)
+{
+  if (v == big_int<N, T>{})
+    return {};
+  const auto [us, vs] = detail::remove_twos(u, v);
+  return detail::bdiv_q(us, vs.data(), detail::tight_length(vs));
+}
+
+// the same with the divisor given as a compile-time constant: the quotient
+// is the product of u with the inverse of v modulo beta^(M - n + 1) for the
+// n-limb v, computed at compile time by Newton's iteration
+export template<std::size_t M, typename T, T... Divisor>
+constexpr big_int<M, T> divexact(big_int<M, T> u, std::integer_sequence<T, Divisor...>)
+{
+  constexpr auto v = big_int<sizeof...(Divisor), T>{Divisor...};
+  static_assert(v != big_int<sizeof...(Divisor), T>{}, "division by zero");
+  constexpr auto vs = detail::remove_twos(big_int<M, T>{}, v).second;
+  constexpr auto n = detail::tight_length(vs);
+  auto us = u;
+  if constexpr (v[0] % 2 == 0)
+    us = detail::remove_twos(u, v).first;
+
+  if constexpr (n == 1)
+    return detail::bdiv_by_limb(us, vs[0]).first;
+  else
+  {
+    constexpr auto inverse = detail::inverse_mod(detail::first<M - n + 1>(vs));
+    return detail::to_length<M>(partial_mul<M - n + 1>(detail::first<M - n + 1>(us), inverse));
+  }
+}
+
+// u / v for a single-limb v dividing u, limb by limb by the inverse of v
+// modulo beta, without divisions
+export template<std::size_t M, typename T>
+constexpr big_int<M, T> divexact_by_limb(big_int<M, T> u, T v)
+{
+  if (v == 0)
+    return {};
+  const auto bits = std::countr_zero(v);
+  return detail::bdiv_by_limb(shift_right(u, bits), static_cast<T>(v >> bits)).first;
+}
 } // namespace lam::cbn
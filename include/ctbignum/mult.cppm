@@ -90,4 +90,164 @@ export template<typename T, std::size_t N1, std::size_t N2>
 constexpr auto operator*(big_int<N1, T> a, big_int<N2, T> b)
 { return mul(a, b); }
 
+namespace detail
+{
+
+// Kernels on limb arrays of runtime length, least significant limb first,
+// for algorithms that recurse on parts of their operands.
+
+// r[0..n) = a + b; returns the carry
+template<typename T>
+constexpr T add_n(T* r, const T* a, const T* b, std::size_t n)
+{
+  T carry = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const T t = static_cast<T>(a[i] + carry);
+    const T c = t < carry;
+    r[i] = static_cast<T>(t + b[i]);
+    carry = c | (r[i] < t);
+  }
+  return carry;
+}
+
+// r[0..n) = a - b; returns the borrow
+template<typename T>
+constexpr T sub_n(T* r, const T* a, const T* b, std::size_t n)
+{
+  T borrow = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const T t = static_cast<T>(a[i] - b[i]);
+    const T c = a[i] < b[i];
+    r[i] = static_cast<T>(t - borrow);
+    borrow = c | (t < borrow);
+  }
+  return borrow;
+}
+
+// r[0..n) += c; returns the carry
+template<typename T>
+constexpr T add_1(T* r, std::size_t n, T c)
+{
+  for (std::size_t i = 0; i < n && c != 0; ++i)
+  {
+    r[i] = static_cast<T>(r[i] + c);
+    c = r[i] < c;
+  }
+  return c;
+}
+
+// r[0..n) -= c; returns the borrow
+template<typename T>
+constexpr T sub_1(T* r, std::size_t n, T c)
+{
+  for (std::size_t i = 0; i < n && c != 0; ++i)
+  {
+    const T t = r[i];
+    r[i] = static_cast<T>(t - c);
+    c = t < c;
+  }
+  return c;
+}
+
+// r[0..n) += a[0..n) b; returns the carry limb
+template<typename T>
+constexpr T addmul_1(T* r, const T* a, std::size_t n, T b)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  T k = 0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const TT t = static_cast<TT>(a[i]) * b + r[i] + k;
+    r[i] = static_cast<T>(t);
+    k = static_cast<T>(t >> std::numeric_limits<T>::digits);
+  }
+  return k;
+}
+
+// r[0..m + n) = a[0..m) b[0..n), as mul
+template<typename T>
+constexpr void mul_basecase(T* r, const T* a, std::size_t m, const T* b, std::size_t n)
+{
+  for (std::size_t i = 0; i < m; ++i)
+    r[i] = 0;
+  for (std::size_t j = 0; j < n; ++j)
+    r[j + m] = addmul_1(r + j, a, m, b[j]);
+}
+
+// below this many limbs, Karatsuba's method calls the schoolbook product
+inline constexpr std::size_t mul_karatsuba_threshold = 24;
+
+// scratch limbs used by mul_karatsuba for n-limb operands
+constexpr std::size_t mul_karatsuba_scratch(std::size_t n)
+{
+  if (n < mul_karatsuba_threshold)
+    return 0;
+  const std::size_t k = n - n / 2 + 1;
+  return 4 * k + mul_karatsuba_scratch(k);
+}
+
+// r[0..2n) = a[0..n) b[0..n) by Karatsuba's method: with a = a1 B^h + a0
+// and b = b1 B^h + b0, three half-size products give
+//   a b = a1 b1 B^2h + ((a0 + a1) (b0 + b1) - a0 b0 - a1 b1) B^h + a0 b0
+template<typename T>
+constexpr void mul_karatsuba(T* r, const T* a, const T* b, std::size_t n, T* scratch)
+{
+  if (n < mul_karatsuba_threshold)
+  {
+    mul_basecase(r, a, n, b, n);
+    return;
+  }
+
+  const std::size_t h = n / 2, k = n - h; // k = h or h + 1
+  T* sa = scratch;
+  T* sb = sa + (k + 1);
+  T* z1 = sb + (k + 1);
+  T* next = z1 + 2 * (k + 1);
+
+  // a0 + a1 and b0 + b1 in k + 1 limbs
+  auto half_sum = [&](T* sum, const T* x) {
+    T c = add_n(sum, x + h, x, h);
+    if (k > h)
+    {
+      sum[h] = static_cast<T>(x[n - 1] + c);
+      c = sum[h] < c;
+    }
+    sum[k] = c;
+  };
+  half_sum(sa, a);
+  half_sum(sb, b);
+
+  mul_karatsuba(r, a, b, h, next);                 // a0 b0
+  mul_karatsuba(r + 2 * h, a + h, b + h, k, next); // a1 b1
+  mul_karatsuba(z1, sa, sb, k + 1, next);
+
+  // the middle term a0 b1 + a1 b0 < 2 B^n, added at B^h
+  sub_1(z1 + 2 * h, 2 * (k + 1) - 2 * h, sub_n(z1, z1, r, 2 * h));
+  sub_1(z1 + 2 * k, std::size_t{2}, sub_n(z1, z1, r + 2 * h, 2 * k));
+  add_1(r + h + 2 * k + 2, h - 2, add_n(r + h, r + h, z1, 2 * k + 2));
+}
+
+// r[0..m + n) = a[0..m) b[0..n), by Karatsuba's method for operands of
+// n and n or n + 1 limbs, and by the schoolbook method otherwise; scratch
+// holds mul_karatsuba_scratch(min(m, n)) limbs
+template<typename T>
+constexpr void mul_limbs(T* r, const T* a, std::size_t m, const T* b, std::size_t n, T* scratch)
+{
+  if (m < n)
+  {
+    std::swap(a, b);
+    std::swap(m, n);
+  }
+  if (n < mul_karatsuba_threshold || m - n > 1)
+    return mul_basecase(r, a, m, b, n);
+
+  mul_karatsuba(r, a, b, n, scratch);
+  if (m > n)
+    r[2 * n] = addmul_1(r + n, b, n, a[n]);
+}
+
+} // namespace detail
+
 } // namespace lam::cbn
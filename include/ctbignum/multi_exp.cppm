@@ -0,0 +1,207 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:multi_exp;
+
+import std;
+
+import :bigint;
+import :division;
+import :utility;
+import :montgomery;
+import :mod_exp;
+import :thread_pool;
+
+namespace lam::cbn
+{
+
+namespace detail
+{
+
+// Montgomery arithmetic modulo a compile-time modulus, with the interface of
+// montgomery_context
+template<typename T, T... Modulus>
+struct static_montgomery
+{
+  static constexpr std::size_t N = sizeof...(Modulus);
+  static constexpr big_int<N, T> modulus{Modulus...};
+  static constexpr big_int<N, T> one = div(unary_encoding<N, N + 1, T>(), modulus).remainder;
+  static constexpr big_int<N, T> r2 = div(unary_encoding<2 * N, 2 * N + 1, T>(), modulus).remainder;
+
+  constexpr big_int<N, T> mul(big_int<N, T> x, big_int<N, T> y) const
+  { return montgomery_mul(x, y, std::integer_sequence<T, Modulus...>{}); }
+};
+
+// Multiplication counts for k exponents of the given bit length, minimized
+// over the window width: Straus (a table of 2^w powers per base, the
+// squarings shared), and Pippenger (per window of c bits, one product per
+// term into 2^c - 1 buckets, which a running product combines)
+inline std::pair<std::size_t, std::size_t> straus_window(std::size_t k, std::size_t bits)
+{
+  std::pair<std::size_t, std::size_t> best{0, std::numeric_limits<std::size_t>::max()};
+  for (std::size_t w = 1; w <= 8; ++w)
+    best = std::min(best, {w, k * ((std::size_t{1} << w) - 2) + bits + k * ((bits + w - 1) / w)},
+                    [](auto a, auto b) { return a.second < b.second; });
+  return best;
+}
+
+inline std::pair<std::size_t, std::size_t> pippenger_window(std::size_t k, std::size_t bits)
+{
+  std::pair<std::size_t, std::size_t> best{0, std::numeric_limits<std::size_t>::max()};
+  for (std::size_t c = 1; c <= 20; ++c)
+    best = std::min(best, {c, bits + (bits + c - 1) / c * (k + (std::size_t{2} << c))},
+                    [](auto a, auto b) { return a.second < b.second; });
+  return best;
+}
+
+// Straus' method: the exponents are scanned together by windows of w bits
+// from the top, with w squarings per window and one multiplication per
+// nonzero digit
+template<typename Ctx, std::size_t N, std::size_t N2, typename T>
+big_int<N, T> straus(const Ctx& ctx, const std::vector<big_int<N, T>>& x, std::span<const big_int<N2, T>> exps,
+                     std::size_t bits, std::size_t w)
+{
+  const std::size_t entries = std::size_t{1} << w;
+  std::vector<big_int<N, T>> table(x.size() * entries); // table[i 2^w + d] = x_i^d
+  for (std::size_t i = 0; i < x.size(); ++i)
+  {
+    auto* row = table.data() + i * entries;
+    row[1] = x[i];
+    for (std::size_t d = 2; d < entries; ++d)
+      row[d] = ctx.mul(row[d - 1], x[i]);
+  }
+
+  auto result = ctx.one;
+  for (std::size_t j = (bits + w - 1) / w; j-- > 0;)
+  {
+    for (std::size_t s = 0; s < w; ++s)
+      result = ctx.mul(result, result);
+    for (std::size_t i = 0; i < x.size(); ++i)
+      if (const T d = extract_bits(exps[i], j * w, w); d != 0)
+        result = ctx.mul(result, table[i * entries + d]);
+  }
+  return result;
+}
+
+// prod_i x_i^d_i for the digits d_i of window j (bits [j c, (j + 1) c)):
+// bucket d collects the x_i with digit d, and the running product of the
+// buckets from the top gives prod_d bucket_d^d in 2^(c + 1) multiplications
+template<typename Ctx, std::size_t N, std::size_t N2, typename T>
+big_int<N, T> pippenger_window_product(const Ctx& ctx, const std::vector<big_int<N, T>>& x,
+                                       std::span<const big_int<N2, T>> exps, std::size_t j, std::size_t c)
+{
+  std::vector<big_int<N, T>> buckets((std::size_t{1} << c) - 1);
+  std::vector<bool> filled(buckets.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+    if (const T d = extract_bits(exps[i], j * c, c); d != 0)
+    {
+      buckets[d - 1] = filled[d - 1] ? ctx.mul(buckets[d - 1], x[i]) : x[i];
+      filled[d - 1] = true;
+    }
+
+  auto running = ctx.one, total = ctx.one;
+  bool started = false;
+  for (std::size_t d = buckets.size(); d-- > 0;)
+  {
+    if (filled[d])
+    {
+      running = started ? ctx.mul(running, buckets[d]) : buckets[d];
+      started = true;
+    }
+    if (started)
+      total = ctx.mul(total, running);
+  }
+  return total;
+}
+
+template<typename Ctx, std::size_t N, std::size_t N2, typename T>
+big_int<N, T> pippenger(const Ctx& ctx, const std::vector<big_int<N, T>>& x, std::span<const big_int<N2, T>> exps,
+                        std::size_t bits, std::size_t c, thread_pool* pool)
+{
+  const std::size_t windows = (bits + c - 1) / c;
+  std::vector<big_int<N, T>> products(windows);
+  auto window = [&](std::size_t j) { products[j] = pippenger_window_product(ctx, x, exps, j, c); };
+  if (pool)
+    pool->parallel_for(windows, window);
+  else
+    for (std::size_t j = 0; j < windows; ++j)
+      window(j);
+
+  auto result = products[windows - 1];
+  for (std::size_t j = windows - 1; j-- > 0;)
+  {
+    for (std::size_t s = 0; s < c; ++s)
+      result = ctx.mul(result, result);
+    result = ctx.mul(result, products[j]);
+  }
+  return result;
+}
+
+template<typename Ctx, std::size_t N, std::size_t N2, typename T>
+big_int<N, T> multi_exp(const Ctx& ctx, std::span<const big_int<N, T>> bases, std::span<const big_int<N2, T>> exps,
+                        thread_pool* pool)
+{
+  if (bases.size() != exps.size())
+    throw std::runtime_error("multi_exp: size mismatch");
+  if (bases.empty())
+    return ctx.mul(ctx.one, big_int<N, T>{1});
+
+  std::size_t bits = 1;
+  for (const auto& e : exps)
+    bits = std::max<std::size_t>(bits, bit_length(e));
+
+  std::vector<big_int<N, T>> x(bases.size());
+  for (std::size_t i = 0; i < x.size(); ++i)
+    x[i] = ctx.mul(bases[i], ctx.r2);
+
+  const auto [w, straus_cost] = straus_window(x.size(), bits);
+  const auto [c, pippenger_cost] = pippenger_window(x.size(), bits);
+  const auto result =
+    straus_cost <= pippenger_cost ? straus(ctx, x, exps, bits, w) : pippenger(ctx, x, exps, bits, c, pool);
+  return ctx.mul(result, big_int<N, T>{1});
+}
+
+} // namespace detail
+
+// prod_i bases[i]^exps[i] mod m for bases below R = beta^N, without the
+// squarings of k separate exponentiations: by Straus' method with
+// interleaved windows for few terms, and by Pippenger's bucket method for
+// many (the choice and the window width minimize the multiplication count).
+// The windows of Pippenger's method are independent and may run on the
+// threads of a thread_pool. Throws std::runtime_error if the spans differ in
+// size; the empty product is 1.
+export template<std::size_t N2, typename T, T... Modulus>
+big_int<sizeof...(Modulus), T> multi_exp(std::span<const std::type_identity_t<big_int<sizeof...(Modulus), T>>> bases,
+                                         std::span<const big_int<N2, T>> exps, std::integer_sequence<T, Modulus...>)
+{ return detail::multi_exp(detail::static_montgomery<T, Modulus...>{}, bases, exps, nullptr); }
+
+export template<std::size_t N2, typename T, T... Modulus>
+big_int<sizeof...(Modulus), T> multi_exp(std::span<const std::type_identity_t<big_int<sizeof...(Modulus), T>>> bases,
+                                         std::span<const big_int<N2, T>> exps, std::integer_sequence<T, Modulus...>,
+                                         thread_pool& pool)
+{ return detail::multi_exp(detail::static_montgomery<T, Modulus...>{}, bases, exps, &pool); }
+
+export template<std::size_t N, std::size_t N2, typename T>
+big_int<N, T> multi_exp(std::span<const std::type_identity_t<big_int<N, T>>> bases,
+                        std::span<const big_int<N2, T>> exps, const montgomery_context<N, T>& ctx)
+{ return detail::multi_exp(ctx, bases, exps, nullptr); }
+
+export template<std::size_t N, std::size_t N2, typename T>
+big_int<N, T> multi_exp(std::span<const std::type_identity_t<big_int<N, T>>> bases,
+                        std::span<const big_int<N2, T>> exps, const montgomery_context<N, T>& ctx, thread_pool& pool)
+{ return detail::multi_exp(ctx, bases, exps, &pool); }
+
+export template<std::size_t N, std::size_t N2, typename T>
+big_int<N, T> multi_exp(std::span<const std::type_identity_t<big_int<N, T>>> bases,
+                        std::span<const big_int<N2, T>> exps, big_int<N, T> m)
+{ return multi_exp(bases, exps, montgomery_context<N, T>{m}); }
+
+} // namespace lam::cbn
@@ -0,0 +1,384 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:ntt;
+
+import std;
+
+import :bigint;
+import :addition;
+import :bitshift;
+import :relational;
+import :mod_exp;
+import :word_field;
+import :field;
+import :precomputed_multiplier;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// The 2-power roots of unity of Z/pZ: p - 1 = q * 2^s with q odd, and
+// g = z^q for a quadratic non-residue z generates the subgroup of order 2^s.
+// A transform of length 2^k exists for k <= two_adicity.
+template<typename T, T... Modulus>
+struct ntt_constants
+{
+  using element_type = ZqElement<T, Modulus...>;
+  static constexpr std::size_t N = sizeof...(Modulus);
+  static constexpr big_int<N, T> p_minus_one = subtract_ignore_carry(big_int<N, T>{Modulus...}, big_int<N, T>{1});
+
+  static constexpr std::size_t s = [] {
+    std::size_t count = 0;
+    for (auto limb : p_minus_one)
+    {
+      if (limb != 0)
+        return count + std::countr_zero(limb);
+      count += std::numeric_limits<T>::digits;
+    }
+    return std::size_t{0}; // p = 1
+  }();
+
+  static constexpr auto q = shift_right(p_minus_one, s);
+  static constexpr auto half_order = shift_right(p_minus_one, 1);
+
+  static constexpr element_type pow(element_type x, big_int<N, T> e)
+  { return element_type{mod_exp(x.data, e, std::integer_sequence<T, Modulus...>{}), skip_reduction{}}; }
+
+  // the smallest quadratic non-residue, or zero if none is found (p composite);
+  // the counter is wider than an 8-bit limb, and stays below p
+  static constexpr T non_residue = [] {
+    constexpr big_int<N, T> p{Modulus...};
+    constexpr std::uint32_t last = std::min<std::uint64_t>(1023, std::numeric_limits<T>::max());
+    for (std::uint32_t z = 2; z <= last && big_int<1, T>{static_cast<T>(z)} < p; ++z)
+      if (pow(element_type{big_int<1, T>{static_cast<T>(z)}}, half_order) == element_type{-1})
+        return static_cast<T>(z);
+    return T{0};
+  }();
+
+  static constexpr std::size_t two_adicity = (non_residue != 0) ? s : 0;
+  static constexpr element_type generator = pow(element_type{big_int<1, T>{non_residue}}, q);
+
+  // a primitive 2^k-th root of unity
+  static constexpr element_type root_of_unity(std::size_t k)
+  {
+    auto w = generator;
+    for (std::size_t i = k; i < two_adicity; ++i)
+      w *= w;
+    return w;
+  }
+};
+
+constexpr std::size_t bit_reverse(std::size_t x, std::size_t bits)
+{
+  std::size_t r = 0;
+  for (std::size_t i = 0; i < bits; ++i, x >>= 1)
+    r = (r << 1) | (x & 1);
+  return r;
+}
+
+// Twiddle table of a length-2^log_n transform, tw[b] = w^bitrev(b), b < 2^(log_n - 1),
+// with w the primitive root of unity of order 2^log_n (or its inverse). A table for
+// length n is a prefix of the table for any larger length.
+template<typename T, T... Modulus, typename Table>
+constexpr void fill_twiddles(Table& tw, std::size_t log_n, bool inverse)
+{
+  using element_type = ZqElement<T, Modulus...>;
+  using constants = ntt_constants<T, Modulus...>;
+
+  auto w = constants::root_of_unity(log_n);
+  if (inverse) // w^-1 = w^(n - 1)
+    w = constants::pow(w, big_int<sizeof...(Modulus), T>{static_cast<T>((std::size_t{1} << log_n) - 1)});
+
+  element_type x{1};
+  for (std::size_t j = 0; j < tw.size(); ++j, x *= w)
+    tw[bit_reverse(j, log_n - 1)] = precomputed_multiplier<element_type>{x};
+}
+
+// n^{-1} = p - (p - 1) / n, for n a power of two dividing p - 1
+template<typename T, T... Modulus>
+constexpr auto size_inverse(std::size_t log_n)
+{
+  using element_type = ZqElement<T, Modulus...>;
+  auto r = shift_right(ntt_constants<T, Modulus...>::p_minus_one, log_n);
+  return precomputed_multiplier<element_type>{-element_type{r}};
+}
+
+// Single-limb moduli p < beta/4 run on raw words with Harvey's lazy
+// butterflies: forward values stay in [0, 4p) and inverse values in [0, 2p),
+// so that a butterfly costs one Shoup multiplication and no full reduction.
+template<typename T, T... Modulus>
+constexpr bool lazy_ntt = [] {
+  if constexpr (sizeof...(Modulus) == 1 && word_field<T, Modulus...>::enabled)
+    return ((Modulus < (T{1} << (std::numeric_limits<T>::digits - 2))) && ...);
+  else
+    return false;
+}();
+
+// Decimation in time (Cooley-Tukey), natural order in, bit-reversed order out.
+// Pairs of stages are fused into radix-4 passes: the two stages for blocks
+// m and 2m load each quadruple once.
+template<typename Element, typename Multiplier, typename Butterfly>
+constexpr void ct_stages(std::span<Element> a, std::span<const Multiplier> tw, Butterfly butterfly)
+{
+  const std::size_t n = a.size();
+  std::size_t m = 1; // number of blocks in the current stage
+  for (; 4 * m <= n; m *= 4)
+  {
+    const std::size_t len = n / (2 * m);
+    const std::size_t h = len / 2;
+    for (std::size_t b = 0; b < m; ++b)
+    {
+      const auto& w1 = tw[b];
+      const auto& w2 = tw[2 * b];
+      const auto& w3 = tw[2 * b + 1];
+      for (std::size_t j = 2 * len * b; j < 2 * len * b + h; ++j)
+      {
+        butterfly(a[j], a[j + len], w1);
+        butterfly(a[j + h], a[j + len + h], w1);
+        butterfly(a[j], a[j + h], w2);
+        butterfly(a[j + len], a[j + len + h], w3);
+      }
+    }
+  }
+  if (2 * m <= n) // odd number of stages: one radix-2 pass remains
+    for (std::size_t b = 0; b < m; ++b)
+      butterfly(a[2 * b], a[2 * b + 1], tw[b]);
+}
+
+// Decimation in frequency (Gentleman-Sande), bit-reversed order in, natural
+// order out; the stages of ct_stages in reverse, with inverse twiddles.
+template<typename Element, typename Multiplier, typename Butterfly>
+constexpr void gs_stages(std::span<Element> a, std::span<const Multiplier> tw, Butterfly butterfly)
+{
+  const std::size_t n = a.size();
+  std::size_t m = n / 4;
+  if (std::countr_zero(n) % 2 == 1)
+  {
+    for (std::size_t b = 0; b < n / 2; ++b)
+      butterfly(a[2 * b], a[2 * b + 1], tw[b]);
+    m = n / 8;
+  }
+  for (; m != 0; m /= 4)
+  {
+    const std::size_t len = n / (2 * m);
+    const std::size_t h = len / 2;
+    for (std::size_t b = 0; b < m; ++b)
+    {
+      const auto& w1 = tw[b];
+      const auto& w2 = tw[2 * b];
+      const auto& w3 = tw[2 * b + 1];
+      for (std::size_t j = 2 * len * b; j < 2 * len * b + h; ++j)
+      {
+        butterfly(a[j], a[j + h], w2);
+        butterfly(a[j + len], a[j + len + h], w3);
+        butterfly(a[j], a[j + len], w1);
+        butterfly(a[j + h], a[j + len + h], w1);
+      }
+    }
+  }
+}
+
+template<typename T, T... Modulus>
+constexpr void ntt_forward(std::span<ZqElement<T, Modulus...>> a,
+                           std::span<const precomputed_multiplier<ZqElement<T, Modulus...>>> tw)
+{
+  using element_type = ZqElement<T, Modulus...>;
+  using multiplier_type = precomputed_multiplier<element_type>;
+
+  if constexpr (lazy_ntt<T, Modulus...>)
+  {
+    using wf = word_field<T, Modulus...>;
+    constexpr T two_p = 2 * T{Modulus...};
+    ct_stages(a, tw, [](element_type& x, element_type& y, const multiplier_type& w) {
+      T u = x.data[0] >= two_p ? static_cast<T>(x.data[0] - two_p) : x.data[0];
+      T t = wf::shoup_mul_lazy(y.data[0], w.w[0], w.w_prime[0]);
+      x.data[0] = static_cast<T>(u + t);
+      y.data[0] = static_cast<T>(u - t + two_p);
+    });
+    for (auto& x : a)
+    {
+      T r = x.data[0] >= two_p ? static_cast<T>(x.data[0] - two_p) : x.data[0];
+      x.data[0] = r >= T{Modulus...} ? static_cast<T>(r - T{Modulus...}) : r;
+    }
+  }
+  else
+    ct_stages(a, tw, [](element_type& x, element_type& y, const multiplier_type& w) {
+      auto t = y * w;
+      y = x - t;
+      x += t;
+    });
+}
+
+template<typename T, T... Modulus>
+constexpr void ntt_inverse(std::span<ZqElement<T, Modulus...>> a,
+                           std::span<const precomputed_multiplier<ZqElement<T, Modulus...>>> tw,
+                           const precomputed_multiplier<ZqElement<T, Modulus...>>& n_inv)
+{
+  using element_type = ZqElement<T, Modulus...>;
+  using multiplier_type = precomputed_multiplier<element_type>;
+
+  if constexpr (lazy_ntt<T, Modulus...>)
+  {
+    using wf = word_field<T, Modulus...>;
+    constexpr T two_p = 2 * T{Modulus...};
+    gs_stages(a, tw, [](element_type& x, element_type& y, const multiplier_type& w) {
+      T u = static_cast<T>(x.data[0] + y.data[0]);
+      y.data[0] = wf::shoup_mul_lazy(static_cast<T>(x.data[0] - y.data[0] + two_p), w.w[0], w.w_prime[0]);
+      x.data[0] = u >= two_p ? static_cast<T>(u - two_p) : u;
+    });
+    for (auto& x : a) // shoup_mul also completes the reduction from [0, 2p)
+      x.data[0] = wf::shoup_mul(x.data[0], n_inv.w[0], n_inv.w_prime[0]);
+  }
+  else
+  {
+    gs_stages(a, tw, [](element_type& x, element_type& y, const multiplier_type& w) {
+      auto t = x - y;
+      x += y;
+      y = t * w;
+    });
+    for (auto& x : a)
+      x *= n_inv;
+  }
+}
+
+} // namespace detail
+
+// Number-theoretic transform of length n = 2^log_size over Z/pZ, for a prime p
+// with 2^log_size dividing p - 1.
+//
+// forward() maps coefficients in natural order to evaluations at the powers
+// of a primitive n-th root of unity in bit-reversed order, and inverse() maps
+// them back; no explicit bit-reversal permutation is performed, so pointwise
+// products between the two yield cyclic convolutions.
+export template<typename Zq>
+struct ntt_plan;
+
+export template<typename T, T... Modulus>
+struct ntt_plan<ZqElement<T, Modulus...>>
+{
+  using element_type = ZqElement<T, Modulus...>;
+  using multiplier_type = precomputed_multiplier<element_type>;
+
+  // largest supported log_size
+  static constexpr std::size_t max_log_size =
+    std::min<std::size_t>(detail::ntt_constants<T, Modulus...>::two_adicity, std::numeric_limits<std::size_t>::digits - 1);
+
+  std::size_t log_size;
+  std::vector<multiplier_type> twiddles;
+  std::vector<multiplier_type> inverse_twiddles;
+  multiplier_type size_inverse;
+
+  explicit ntt_plan(std::size_t log_n)
+    : log_size(log_n)
+  {
+    if (log_n > max_log_size)
+      throw std::runtime_error("transform length does not divide p - 1");
+    twiddles.resize(size() / 2);
+    inverse_twiddles.resize(size() / 2);
+    detail::fill_twiddles<T, Modulus...>(twiddles, log_n, false);
+    detail::fill_twiddles<T, Modulus...>(inverse_twiddles, log_n, true);
+    size_inverse = detail::size_inverse<T, Modulus...>(log_n);
+  }
+
+  std::size_t size() const { return std::size_t{1} << log_size; }
+
+  void forward(std::span<element_type> a) const
+  {
+    if (a.size() != size())
+      throw std::runtime_error("input length does not match the transform length");
+    detail::ntt_forward<T, Modulus...>(a, std::span<const multiplier_type>{twiddles});
+  }
+
+  void inverse(std::span<element_type> a) const
+  {
+    if (a.size() != size())
+      throw std::runtime_error("input length does not match the transform length");
+    detail::ntt_inverse<T, Modulus...>(a, std::span<const multiplier_type>{inverse_twiddles}, size_inverse);
+  }
+};
+
+// Transform of fixed length 2^LogSize whose twiddle tables are computed at
+// compile time; usable in constant expressions.
+export template<typename Zq, std::size_t LogSize>
+struct static_ntt_plan;
+
+export template<typename T, T... Modulus, std::size_t LogSize>
+struct static_ntt_plan<ZqElement<T, Modulus...>, LogSize>
+{
+  using element_type = ZqElement<T, Modulus...>;
+  using multiplier_type = precomputed_multiplier<element_type>;
+
+  static_assert(LogSize <= detail::ntt_constants<T, Modulus...>::two_adicity, "transform length does not divide p - 1");
+
+  static constexpr std::size_t size = std::size_t{1} << LogSize;
+
+  static constexpr auto twiddles = [] {
+    std::array<multiplier_type, size / 2> tw{};
+    detail::fill_twiddles<T, Modulus...>(tw, LogSize, false);
+    return tw;
+  }();
+
+  static constexpr auto inverse_twiddles = [] {
+    std::array<multiplier_type, size / 2> tw{};
+    detail::fill_twiddles<T, Modulus...>(tw, LogSize, true);
+    return tw;
+  }();
+
+  static constexpr multiplier_type size_inverse = detail::size_inverse<T, Modulus...>(LogSize);
+
+  static constexpr void forward(std::span<element_type, size> a)
+  { detail::ntt_forward<T, Modulus...>(std::span<element_type>{a}, std::span<const multiplier_type>{twiddles}); }
+
+  static constexpr void inverse(std::span<element_type, size> a)
+  { detail::ntt_inverse<T, Modulus...>(std::span<element_type>{a}, std::span<const multiplier_type>{inverse_twiddles}, size_inverse); }
+};
+
+namespace detail
+{
+
+// product of the polynomials with coefficients a and b, both nonempty;
+// a + b - 1 coefficients, at most 2^max_log_size
+template<typename T, T... Modulus>
+std::vector<ZqElement<T, Modulus...>> ntt_product(std::span<const std::type_identity_t<ZqElement<T, Modulus...>>> a,
+                                                  std::span<const std::type_identity_t<ZqElement<T, Modulus...>>> b)
+{
+  using element_type = ZqElement<T, Modulus...>;
+  const std::size_t length = a.size() + b.size() - 1;
+  const ntt_plan<element_type> plan(std::bit_width(length - 1));
+
+  std::vector<element_type> fa(plan.size()), fb(plan.size());
+  std::ranges::copy(a, fa.begin());
+  std::ranges::copy(b, fb.begin());
+  plan.forward(fa);
+  plan.forward(fb);
+  for (std::size_t i = 0; i < fa.size(); ++i)
+    fa[i] *= fb[i];
+  plan.inverse(fa);
+
+  fa.resize(length);
+  return fa;
+}
+
+} // namespace detail
+
+// product of the polynomials with coefficients a and b (constant term first)
+export template<typename T, T... Modulus>
+auto ntt_multiply(const std::vector<ZqElement<T, Modulus...>>& a, const std::vector<ZqElement<T, Modulus...>>& b)
+{
+  using element_type = ZqElement<T, Modulus...>;
+  if (a.empty() || b.empty())
+    return std::vector<element_type>{};
+  return detail::ntt_product<T, Modulus...>(a, b);
+}
+
+} // namespace lam::cbn
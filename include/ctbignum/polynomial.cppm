@@ -0,0 +1,519 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:polynomial;
+
+import std;
+
+import :bigint;
+import :division;
+import :word_field;
+import :field;
+import :precomputed_multiplier;
+import :ntt;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// below these sizes the simpler algorithm is faster (see bench-polynomial)
+constexpr std::size_t karatsuba_threshold = 32;      // shorter factor, schoolbook below
+constexpr std::size_t ntt_threshold = 64;            // shorter factor, Karatsuba below
+constexpr std::size_t newton_threshold = 192;        // divisor and quotient length, long division below
+constexpr std::size_t remainder_tree_threshold = 64; // points per subtree, Horner below
+
+// odd moduli whose ntt_plan has max_log_size > 0 admit a transform
+template<typename T, T... Modulus>
+constexpr bool ntt_friendly = [] {
+  if constexpr ((big_int<sizeof...(Modulus), T>{Modulus...}[0] & 1) == 1)
+    return ntt_plan<ZqElement<T, Modulus...>>::max_log_size > 0;
+  else
+    return false;
+}();
+
+// out[i + j] += a[i] * b[j]
+template<typename E>
+void schoolbook_mul_add(std::span<E> out, std::span<const E> a, std::span<const E> b)
+{
+  for (std::size_t i = 0; i < a.size(); ++i)
+    for (std::size_t j = 0; j < b.size(); ++j)
+      out[i + j] += a[i] * b[j];
+}
+
+// scratch space used by karatsuba for factors of length n
+constexpr std::size_t karatsuba_scratch(std::size_t n)
+{
+  if (n <= karatsuba_threshold)
+    return 0;
+  const std::size_t h = n - n / 2;
+  return 4 * h - 1 + karatsuba_scratch(h);
+}
+
+// out = a * b for factors of equal length n, out of length 2n - 1
+template<typename E>
+void karatsuba(std::span<E> out, std::span<const E> a, std::span<const E> b, std::span<E> scratch)
+{
+  const std::size_t n = a.size();
+  if (n <= karatsuba_threshold)
+  {
+    std::ranges::fill(out, E{});
+    schoolbook_mul_add(out, a, b);
+    return;
+  }
+
+  // a = a0 + x^l a1 with |a0| = l, |a1| = h >= l
+  const std::size_t l = n / 2, h = n - l;
+  auto sa = scratch.subspan(0, h), sb = scratch.subspan(h, h), z1 = scratch.subspan(2 * h, 2 * h - 1);
+  auto rest = scratch.subspan(4 * h - 1);
+
+  karatsuba(out.subspan(0, 2 * l - 1), a.first(l), b.first(l), rest);
+  out[2 * l - 1] = E{};
+  karatsuba(out.subspan(2 * l, 2 * h - 1), a.subspan(l), b.subspan(l), rest);
+
+  for (std::size_t i = 0; i < h; ++i)
+  {
+    sa[i] = a[l + i];
+    sb[i] = b[l + i];
+  }
+  for (std::size_t i = 0; i < l; ++i)
+  {
+    sa[i] += a[i];
+    sb[i] += b[i];
+  }
+  karatsuba(z1, std::span<const E>{sa}, std::span<const E>{sb}, rest);
+
+  // out += x^l (z1 - a0 b0 - a1 b1)
+  for (std::size_t i = 0; i < 2 * l - 1; ++i)
+    z1[i] -= out[i];
+  for (std::size_t i = 0; i < 2 * h - 1; ++i)
+    z1[i] -= out[2 * l + i];
+  for (std::size_t i = 0; i < 2 * h - 1; ++i)
+    out[l + i] += z1[i];
+}
+
+// product of two coefficient sequences: schoolbook for short factors, the
+// transform for long factors over NTT-friendly moduli, Karatsuba otherwise
+// (the longer factor cut into pieces of the length of the shorter)
+template<typename T, T... Modulus>
+std::vector<ZqElement<T, Modulus...>> poly_mul(std::span<const std::type_identity_t<ZqElement<T, Modulus...>>> a,
+                                               std::span<const std::type_identity_t<ZqElement<T, Modulus...>>> b)
+{
+  using E = ZqElement<T, Modulus...>;
+  if (a.empty() || b.empty())
+    return {};
+  if (a.size() < b.size())
+    std::swap(a, b);
+
+  const std::size_t n = b.size();
+  std::vector<E> out(a.size() + n - 1);
+  if (n <= karatsuba_threshold)
+  {
+    schoolbook_mul_add(std::span{out}, a, b);
+    return out;
+  }
+
+  if constexpr (ntt_friendly<T, Modulus...>)
+  {
+    if (n >= ntt_threshold && std::bit_width(out.size() - 1) <= ntt_plan<E>::max_log_size)
+      return ntt_product<T, Modulus...>(a, b);
+  }
+
+  std::vector<E> piece(2 * n - 1), padded(n), scratch(karatsuba_scratch(n));
+  for (std::size_t i = 0; i < a.size(); i += n)
+  {
+    auto chunk = a.subspan(i, std::min(n, a.size() - i));
+    if (chunk.size() < n)
+    {
+      std::ranges::fill(padded, E{});
+      std::ranges::copy(chunk, padded.begin());
+      chunk = padded;
+    }
+    karatsuba(std::span{piece}, chunk, b, std::span{scratch});
+    for (std::size_t j = 0; j < piece.size() && i + j < out.size(); ++j)
+      out[i + j] += piece[j];
+  }
+  return out;
+}
+
+// g with f * g = 1 mod x^k, by Newton iteration g <- g (2 - f g); f[0] must be invertible
+template<typename T, T... Modulus>
+std::vector<ZqElement<T, Modulus...>> inverse_series(std::span<const std::type_identity_t<ZqElement<T, Modulus...>>> f,
+                                                     std::size_t k)
+{
+  using E = ZqElement<T, Modulus...>;
+  std::vector<E> g{E{1} / f[0]};
+  for (std::size_t m = 1; m < k;)
+  {
+    const std::size_t m2 = std::min(2 * m, k);
+    // f g = 1 + x^m e mod x^m2, and g (2 - f g) = g - x^m g e
+    auto fg = poly_mul<T, Modulus...>(f.first(std::min(f.size(), m2)), g);
+    fg.resize(m2);
+    auto ge = poly_mul<T, Modulus...>(g, std::span<const E>{fg}.subspan(m));
+    g.resize(m2);
+    for (std::size_t i = m; i < m2; ++i)
+      g[i] = -ge[i - m];
+    m = m2;
+  }
+  return g;
+}
+
+} // namespace detail
+
+// Polynomial with coefficients in Z/pZ, stored contiguously, constant term
+// first and without trailing zeros (the zero polynomial has no coefficients
+// and degree -1).
+//
+// Multiplication picks schoolbook, Karatsuba or the number-theoretic
+// transform by length; division with remainder uses long division, or Newton
+// iteration on the reversed divisor for long operands. Evaluation at many
+// points and interpolation go through a subproduct tree, in O(M(n) log n)
+// operations for M(n) the cost of a product of length n. Division and
+// interpolation require p prime (or at least the leading coefficients and
+// the point differences to be invertible).
+export template<typename Zq>
+class polynomial;
+
+export template<typename T, T... Modulus>
+class polynomial<ZqElement<T, Modulus...>>
+{
+public:
+  using element_type = ZqElement<T, Modulus...>;
+
+  polynomial() = default;
+  polynomial(std::initializer_list<element_type> c) : coefficients_(c) { normalize(); }
+  explicit polynomial(std::vector<element_type> c) : coefficients_(std::move(c)) { normalize(); }
+  explicit polynomial(std::span<const element_type> c) : coefficients_(c.begin(), c.end()) { normalize(); }
+
+  const std::vector<element_type>& coefficients() const { return coefficients_; }
+  std::ptrdiff_t degree() const { return static_cast<std::ptrdiff_t>(coefficients_.size()) - 1; }
+  bool is_zero() const { return coefficients_.empty(); }
+
+  // coefficient of x^i (zero beyond the degree)
+  element_type operator[](std::size_t i) const { return i < coefficients_.size() ? coefficients_[i] : element_type{}; }
+  element_type leading_coefficient() const { return is_zero() ? element_type{} : coefficients_.back(); }
+
+  // Horner's rule with x as a fixed multiplier; for single-limb p < beta/4
+  // the accumulator stays in [0, 3p) and is reduced once at the end
+  element_type operator()(element_type x) const
+  {
+    if constexpr (detail::lazy_ntt<T, Modulus...>)
+    {
+      using wf = detail::word_field<T, Modulus...>;
+      constexpr T p = big_int<1, T>{Modulus...}[0];
+      const T w = x.data[0], w_prime = wf::shoup_precompute(w);
+      T acc = 0;
+      for (std::size_t i = coefficients_.size(); i-- > 0;)
+        acc = static_cast<T>(wf::shoup_mul_lazy(acc, w, w_prime) + coefficients_[i].data[0]);
+      acc = (acc >= 2 * p) ? static_cast<T>(acc - 2 * p) : acc;
+      acc = (acc >= p) ? static_cast<T>(acc - p) : acc;
+      return element_type{big_int<1, T>{acc}, skip_reduction{}};
+    }
+    else
+    {
+      const precomputed_multiplier<element_type> w(x);
+      element_type acc{};
+      for (std::size_t i = coefficients_.size(); i-- > 0;)
+        acc = acc * w + coefficients_[i];
+      return acc;
+    }
+  }
+
+  // values at all points, through the subproduct tree of the points
+  std::vector<element_type> evaluate(std::span<const element_type> points) const
+  {
+    std::vector<element_type> values(points.size());
+    if (points.size() <= detail::remainder_tree_threshold)
+    {
+      for (std::size_t i = 0; i < points.size(); ++i)
+        values[i] = (*this)(points[i]);
+      return values;
+    }
+    const subproduct_tree tree(points);
+    tree.evaluate(*this % tree.root(), points, values);
+    return values;
+  }
+
+  // the polynomial of degree < n through (x[i], y[i]), for n distinct points
+  static polynomial interpolate(std::span<const element_type> x, std::span<const element_type> y)
+  {
+    if (x.size() != y.size())
+      throw std::runtime_error("interpolation needs as many values as points");
+    if (x.empty())
+      return {};
+
+    // Lagrange: f = sum_i y[i] / m'(x[i]) * m / (x - x[i]), m = prod_i (x - x[i])
+    const subproduct_tree tree(x);
+    std::vector<element_type> weights(x.size());
+    tree.root().derivative().evaluate_with(tree, x, weights);
+
+    // batch inversion: one division and three multiplications per point
+    std::vector<element_type> prefix(x.size());
+    element_type running{1};
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+      prefix[i] = running;
+      running *= weights[i];
+    }
+    if (running == element_type{})
+      throw std::runtime_error("interpolation points are not distinct");
+    running = element_type{1} / running;
+    for (std::size_t i = x.size(); i-- > 0;)
+    {
+      const auto inverse = running * prefix[i];
+      running *= weights[i];
+      weights[i] = y[i] * inverse;
+    }
+    return tree.combine(weights);
+  }
+
+  polynomial derivative() const
+  {
+    std::vector<element_type> d(coefficients_.size() > 1 ? coefficients_.size() - 1 : 0);
+    element_type k{};
+    for (std::size_t i = 0; i < d.size(); ++i)
+      d[i] = coefficients_[i + 1] * (k += element_type{1});
+    return polynomial{std::move(d)};
+  }
+
+  polynomial& operator+=(const polynomial& b)
+  {
+    if (coefficients_.size() < b.coefficients_.size())
+      coefficients_.resize(b.coefficients_.size());
+    for (std::size_t i = 0; i < b.coefficients_.size(); ++i)
+      coefficients_[i] += b.coefficients_[i];
+    normalize();
+    return *this;
+  }
+
+  polynomial& operator-=(const polynomial& b)
+  {
+    if (coefficients_.size() < b.coefficients_.size())
+      coefficients_.resize(b.coefficients_.size());
+    for (std::size_t i = 0; i < b.coefficients_.size(); ++i)
+      coefficients_[i] -= b.coefficients_[i];
+    normalize();
+    return *this;
+  }
+
+  polynomial& operator*=(const polynomial& b)
+  {
+    coefficients_ = detail::poly_mul<T, Modulus...>(coefficients_, b.coefficients_);
+    normalize();
+    return *this;
+  }
+
+  polynomial& operator*=(element_type c)
+  {
+    for (auto& x : coefficients_)
+      x *= c;
+    normalize();
+    return *this;
+  }
+
+  friend bool operator==(const polynomial&, const polynomial&) = default;
+
+private:
+  // Levels of products of (x - x[i]): level 0 holds the linear factors, each
+  // further level the products of adjacent pairs (an unpaired last node is
+  // carried up unchanged), so that node j of level l covers the points
+  // [j 2^l, (j + 1) 2^l). The last level holds the single product m.
+  class subproduct_tree
+  {
+  public:
+    explicit subproduct_tree(std::span<const element_type> x)
+    {
+      levels.emplace_back();
+      for (const auto& xi : x)
+        levels.back().push_back(polynomial{-xi, element_type{1}});
+      while (levels.back().size() > 1)
+      {
+        const auto& below = levels.back();
+        std::vector<polynomial> level;
+        for (std::size_t j = 0; j + 1 < below.size(); j += 2)
+          level.push_back(below[j] * below[j + 1]);
+        if (below.size() % 2 == 1)
+          level.push_back(below.back());
+        levels.push_back(std::move(level));
+      }
+    }
+
+    const polynomial& root() const { return levels.back()[0]; }
+
+    // values[i] = f(x[i]) for f reduced modulo the root
+    void evaluate(const polynomial& f, std::span<const element_type> x, std::span<element_type> values) const
+    {
+      evaluate(f, levels.size() - 1, 0, x, values);
+    }
+
+    // sum_i c[i] m / (x - x[i])
+    polynomial combine(std::span<const element_type> c) const
+    {
+      std::vector<polynomial> current;
+      for (const auto& ci : c)
+        current.push_back(polynomial{ci});
+      for (std::size_t l = 1; l < levels.size(); ++l)
+      {
+        const auto& below = levels[l - 1];
+        std::vector<polynomial> next;
+        for (std::size_t j = 0; j + 1 < below.size(); j += 2)
+          next.push_back(current[j] * below[j + 1] + current[j + 1] * below[j]);
+        if (below.size() % 2 == 1)
+          next.push_back(std::move(current.back()));
+        current = std::move(next);
+      }
+      return current[0];
+    }
+
+  private:
+    void evaluate(const polynomial& f, std::size_t l, std::size_t j, std::span<const element_type> x,
+                  std::span<element_type> values) const
+    {
+      const std::size_t begin = j << l, end = std::min((j + 1) << l, x.size());
+      if (end - begin <= detail::remainder_tree_threshold)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+          values[i] = f(x[i]);
+        return;
+      }
+      const auto& below = levels[l - 1];
+      if (2 * j + 1 == below.size()) // carried node
+        evaluate(f, l - 1, 2 * j, x, values);
+      else
+      {
+        evaluate(f % below[2 * j], l - 1, 2 * j, x, values);
+        evaluate(f % below[2 * j + 1], l - 1, 2 * j + 1, x, values);
+      }
+    }
+
+    std::vector<std::vector<polynomial>> levels;
+  };
+
+  void evaluate_with(const subproduct_tree& tree, std::span<const element_type> x, std::span<element_type> values) const
+  {
+    if (x.size() <= detail::remainder_tree_threshold)
+      for (std::size_t i = 0; i < x.size(); ++i)
+        values[i] = (*this)(x[i]);
+    else
+      tree.evaluate(*this, x, values); // deg m' < deg m: no reduction needed
+  }
+
+  void normalize()
+  {
+    while (!coefficients_.empty() && coefficients_.back() == element_type{})
+      coefficients_.pop_back();
+  }
+
+  std::vector<element_type> coefficients_;
+};
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator+(polynomial<ZqElement<T, M...>> a, const polynomial<ZqElement<T, M...>>& b)
+{
+  a += b;
+  return a;
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator-(polynomial<ZqElement<T, M...>> a, const polynomial<ZqElement<T, M...>>& b)
+{
+  a -= b;
+  return a;
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator-(const polynomial<ZqElement<T, M...>>& a)
+{
+  return polynomial<ZqElement<T, M...>>{} - a;
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator*(const polynomial<ZqElement<T, M...>>& a,
+                                         const polynomial<ZqElement<T, M...>>& b)
+{
+  return polynomial<ZqElement<T, M...>>{detail::poly_mul<T, M...>(a.coefficients(), b.coefficients())};
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator*(polynomial<ZqElement<T, M...>> a, ZqElement<T, M...> c)
+{
+  a *= c;
+  return a;
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator*(ZqElement<T, M...> c, polynomial<ZqElement<T, M...>> a)
+{
+  a *= c;
+  return a;
+}
+
+// quotient and remainder of a by b (deg remainder < deg b)
+export template<typename T, T... M>
+DivisionResult<polynomial<ZqElement<T, M...>>, polynomial<ZqElement<T, M...>>>
+div(const polynomial<ZqElement<T, M...>>& a, const polynomial<ZqElement<T, M...>>& b)
+{
+  using E = ZqElement<T, M...>;
+  using P = polynomial<E>;
+  if (b.is_zero())
+    throw std::runtime_error("division by the zero polynomial");
+  if (a.degree() < b.degree())
+    return {P{}, a};
+
+  const auto& u = a.coefficients();
+  const auto& v = b.coefficients();
+  const std::size_t n = u.size(), d = v.size(), k = n - d + 1; // k quotient coefficients
+
+  if (k <= detail::newton_threshold || d <= detail::newton_threshold)
+  { // long division
+    std::vector<E> r(u), q(k);
+    const E lc_inverse = E{1} / v.back();
+    for (std::size_t i = k; i-- > 0;)
+    {
+      const E c = r[i + d - 1] * lc_inverse;
+      q[i] = c;
+      if (c != E{})
+        for (std::size_t j = 0; j + 1 < d; ++j)
+          r[i + j] -= c * v[j];
+    }
+    r.resize(d - 1);
+    return {P{std::move(q)}, P{std::move(r)}};
+  }
+
+  // the reversed quotient is the reversed dividend over the reversed divisor, mod x^k
+  std::vector<E> ru(u.rbegin(), u.rbegin() + static_cast<std::ptrdiff_t>(k)), rv(v.rbegin(), v.rend());
+  const auto inverse = detail::inverse_series<T, M...>(std::span<const E>{rv}.first(std::min(d, k)), k);
+  auto q = detail::poly_mul<T, M...>(ru, inverse);
+  q.resize(k);
+  std::ranges::reverse(q);
+
+  auto vq = detail::poly_mul<T, M...>(v, q);
+  std::vector<E> r(u.begin(), u.begin() + static_cast<std::ptrdiff_t>(d - 1));
+  for (std::size_t i = 0; i < r.size(); ++i)
+    r[i] -= vq[i];
+  return {P{std::move(q)}, P{std::move(r)}};
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator/(const polynomial<ZqElement<T, M...>>& a,
+                                         const polynomial<ZqElement<T, M...>>& b)
+{
+  return div(a, b).quotient;
+}
+
+export template<typename T, T... M>
+polynomial<ZqElement<T, M...>> operator%(const polynomial<ZqElement<T, M...>>& a,
+                                         const polynomial<ZqElement<T, M...>>& b)
+{
+  return div(a, b).remainder;
+}
+
+} // namespace lam::cbn
@@ -0,0 +1,121 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:precomputed_multiplier;
+
+import std;
+
+import :bigint;
+import :slicing;
+import :addition;
+import :mult;
+import :division;
+import :montgomery;
+import :relational;
+import :word_field;
+import :field;
+
+namespace lam::cbn
+{
+
+// Multiplication by a fixed operand w with Shoup's precomputed quotient
+// w' = floor(w * beta^N / p), where beta^N = 2^(N * digits(T)).
+//
+// For any a < beta^N, q = floor(a * w' / beta^N) (the high half of a * w')
+// underestimates floor(a * w / p) by at most one, hence
+//   a * w - q * p   (computed with low halves only)
+// lies in [0, 2p) and a single conditional subtraction completes the
+// reduction. Intended for twiddle factors and other reused coefficients;
+// see V. Shoup, NTL, and D. Harvey, "Faster arithmetic for number-theoretic
+// transforms", J. Symbolic Comput. 60, 2014.
+//
+// For odd moduli of three or more limbs, w' = w * beta^N mod p (w in
+// Montgomery form) instead, and a single Montgomery multiplication of a by w'
+// yields a * w mod p; at these sizes it is about twice as fast.
+export template<typename Zq>
+struct precomputed_multiplier;
+
+export template<typename T, T... Modulus>
+struct precomputed_multiplier<ZqElement<T, Modulus...>>
+{
+  using element_type = ZqElement<T, Modulus...>;
+  static constexpr std::size_t N = sizeof...(Modulus);
+
+  big_int<N, T> w{};       // the fixed operand, w < p
+  big_int<N, T> w_prime{}; // floor(w * beta^N / p), or w * beta^N mod p
+
+  constexpr precomputed_multiplier() = default;
+
+  constexpr explicit precomputed_multiplier(element_type x) : w(x.data)
+  {
+    if constexpr (N == 1 && detail::word_field<T, Modulus...>::enabled)
+      w_prime[0] = detail::word_field<T, Modulus...>::shoup_precompute(w[0]);
+    else if constexpr (detail::montgomery_field<T, Modulus...>)
+      w_prime = montgomery_mul(w, detail::montgomery_r2<T, Modulus...>, std::integer_sequence<T, Modulus...>{});
+    else
+      w_prime = detail::first<N>(div(detail::join(big_int<N, T>{}, w), big_int<N, T>{Modulus...}).quotient);
+  }
+
+  constexpr element_type value() const { return element_type{w, skip_reduction{}}; }
+
+  // a * w mod p, for any a < beta^N
+  constexpr big_int<N, T> mul(big_int<N, T> a) const
+  {
+    using detail::first;
+    using detail::pad;
+    using detail::skip;
+
+    constexpr big_int<N, T> p{Modulus...};
+
+    if constexpr (N == 1 && detail::word_field<T, Modulus...>::enabled)
+      return big_int<1, T>{detail::word_field<T, Modulus...>::shoup_mul(a[0], w[0], w_prime[0])};
+    else if constexpr (detail::montgomery_field<T, Modulus...>)
+      return montgomery_mul(a, w_prime, std::integer_sequence<T, Modulus...>{});
+    else
+    {
+      auto q = skip<N>(cbn::mul(a, w_prime));
+      if constexpr ((p[N - 1] >> (std::numeric_limits<T>::digits - 1)) == 0)
+      { // 2p < beta^N: the low N limbs suffice
+        auto r = subtract_ignore_carry(partial_mul<N>(a, w), partial_mul<N>(q, p));
+        return (r >= p) ? subtract_ignore_carry(r, p) : r;
+      }
+      else
+      {
+        auto r = subtract_ignore_carry(partial_mul<N + 1>(a, w), partial_mul<N + 1>(q, p));
+        auto padded_mod = pad<1>(p);
+        return first<N>((r >= padded_mod) ? subtract_ignore_carry(r, padded_mod) : r);
+      }
+    }
+  }
+};
+
+export template<typename T, T... M>
+constexpr auto& operator*=(ZqElement<T, M...>& a, const precomputed_multiplier<ZqElement<T, M...>>& w)
+{
+  a = ZqElement<T, M...>{w.mul(a.data), skip_reduction{}};
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto operator*(ZqElement<T, M...> a, const precomputed_multiplier<ZqElement<T, M...>>& w)
+{
+  a *= w;
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto operator*(const precomputed_multiplier<ZqElement<T, M...>>& w, ZqElement<T, M...> a)
+{
+  a *= w;
+  return a;
+}
+
+} // namespace lam::cbn
@@ -0,0 +1,360 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:primality;
+
+import std;
+
+import :bigint;
+import :slicing;
+import :utility;
+import :relational;
+import :addition;
+import :bitshift;
+import :reciprocal;
+import :division;
+import :montgomery;
+import :mod_exp;
+
+namespace lam::cbn
+{
+
+namespace detail
+{
+
+// Factor p - 1 = Q * 2^S where Q is odd
+template<std::size_t N, typename T>
+constexpr auto factor_out_twos(big_int<N, T> n)
+{
+  std::size_t S = 0;
+  while ((n[0] & 1) == 0)
+  {
+    n = shift_right(n, 1);
+    ++S;
+  }
+  return std::pair{n, S};
+}
+
+// composite[i] for i < Bound, by the sieve of Eratosthenes
+template<std::size_t Bound>
+constexpr std::array<bool, Bound> composite_table()
+{
+  std::array<bool, Bound> composite{};
+  for (std::size_t i = 2; i * i < Bound; ++i)
+    if (!composite[i])
+      for (std::size_t j = i * i; j < Bound; j += i)
+        composite[j] = true;
+  return composite;
+}
+
+// the odd primes below Bound
+template<std::size_t Bound>
+constexpr auto odd_primes_below()
+{
+  constexpr auto composite = composite_table<Bound>();
+  constexpr auto count = static_cast<std::size_t>(std::count(composite.begin() + 3, composite.end(), false));
+  std::array<std::uint32_t, count> primes{};
+  for (std::size_t i = 3, k = 0; i < Bound; ++i)
+    if (!composite[i])
+      primes[k++] = static_cast<std::uint32_t>(i);
+  return primes;
+}
+
+// the trial divisors of is_probable_prime
+inline constexpr std::size_t trial_division_bound = 1024;
+inline constexpr auto small_primes = odd_primes_below<trial_division_bound>();
+
+// a product of the consecutive primes [begin, end) of a table that fits in a
+// limb, shifted to a normalized divisor with its reciprocal
+template<typename T>
+struct prime_product
+{
+  T divisor;
+  T reciprocal;
+  int shift;
+  std::size_t begin, end;
+};
+
+// the number of leading primes of an ascending table that fit in a limb (all
+// of them but for 8-bit limbs); the products cover only those
+template<typename T, const auto& Primes>
+constexpr std::size_t primes_in_limb()
+{
+  return static_cast<std::size_t>(
+    std::ranges::count_if(Primes, [](auto p) { return p <= std::numeric_limits<T>::max(); }));
+}
+
+template<typename T, const auto& Primes>
+constexpr std::size_t prime_product_count()
+{
+  constexpr auto size = primes_in_limb<T, Primes>();
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < size; ++count)
+    for (T product = 1; i < size && product <= std::numeric_limits<T>::max() / Primes[i]; ++i)
+      product = static_cast<T>(product * Primes[i]);
+  return count;
+}
+
+template<typename T, const auto& Primes>
+constexpr auto prime_products()
+{
+  constexpr auto size = primes_in_limb<T, Primes>();
+  std::array<prime_product<T>, prime_product_count<T, Primes>()> products{};
+  std::size_t i = 0;
+  for (auto& p : products)
+  {
+    T product = 1;
+    p.begin = i;
+    for (; i < size && product <= std::numeric_limits<T>::max() / Primes[i]; ++i)
+      product = static_cast<T>(product * Primes[i]);
+    p.end = i;
+    p.shift = std::countl_zero(product);
+    p.divisor = static_cast<T>(product << p.shift);
+    p.reciprocal = reciprocal_word(p.divisor);
+  }
+  return products;
+}
+
+// u mod d for the normalized d = v 2^s with reciprocal inv: the remainder
+// of u 2^s by d, over the limbs of u 2^s on the fly, shifted back
+template<std::size_t N, typename T>
+constexpr T mod_word(const big_int<N, T>& u, T d, T inv, int s)
+{
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  T r = s > 0 ? static_cast<T>(u[N - 1] >> (digits - s)) : T{0};
+  for (std::size_t i = N; i-- > 0;)
+  {
+    const T low = i > 0 && s > 0 ? static_cast<T>(u[i - 1] >> (digits - s)) : T{0};
+    r = udiv_2by1(r, static_cast<T>((u[i] << s) | low), d, inv).second;
+  }
+  return static_cast<T>(r >> s);
+}
+
+enum class trial_division_result
+{
+  composite,
+  prime,
+  undecided
+};
+
+// trial division of the odd n > 1 by the small primes, one remainder of n
+// per limb-sized product of them
+template<std::size_t N, typename T>
+constexpr trial_division_result trial_division(const big_int<N, T>& n)
+{
+  constexpr auto products = prime_products<T, small_primes>();
+  for (const auto& p : products)
+  {
+    const T r = mod_word(n, p.divisor, p.reciprocal, p.shift);
+    for (std::size_t i = p.begin; i < p.end; ++i)
+      if (r % small_primes[i] == 0)
+        return n == big_int<1, T>{static_cast<T>(small_primes[i])} ? trial_division_result::prime
+                                                                     : trial_division_result::composite;
+  }
+
+  // no prime factor below the bound (the primes of a limb for 8-bit limbs):
+  // prime if below its square
+  constexpr std::size_t digits = std::numeric_limits<T>::digits;
+  constexpr auto bound = digits < 16 ? std::min(trial_division_bound, std::size_t{1} << digits) : trial_division_bound;
+  constexpr auto bound_squared = bound * bound;
+  if (tight_length(n) <= 1 && n[0] < bound_squared)
+    return trial_division_result::prime;
+  return trial_division_result::undecided;
+}
+
+// the Jacobi symbol (a / k) of words, for odd k
+template<typename T>
+constexpr int jacobi_word(T a, T k)
+{
+  int j = 1;
+  a %= k;
+  while (a != 0)
+  {
+    const auto z = std::countr_zero(a);
+    a >>= z;
+    if (z % 2 != 0 && (k % 8 == 3 || k % 8 == 5))
+      j = -j;
+    if (a % 4 == 3 && k % 4 == 3)
+      j = -j;
+    std::swap(a, k);
+    a %= k;
+  }
+  return k == 1 ? j : 0;
+}
+
+// the Jacobi symbol (D / n) of a small D and the odd n
+template<std::size_t N, typename T>
+constexpr int jacobi_small(std::int64_t D, const big_int<N, T>& n)
+{
+  const auto k = static_cast<T>(D < 0 ? -D : D);
+  int j = jacobi_word(short_div(n, k).remainder[0], k); // (n / |D|)
+  if (k % 4 == 3 && n[0] % 4 == 3)                      // reciprocity for the odd |D|
+    j = -j;
+  if (D < 0 && n[0] % 4 == 3) // (-1 / n)
+    j = -j;
+  return j;
+}
+
+// whether n is a perfect square: floor(sqrt(n)) by Newton's iteration from
+// above
+template<std::size_t N, typename T>
+constexpr bool is_square(const big_int<N, T>& n)
+{
+  const auto bits = bit_length(n);
+  if (bits == 0)
+    return true;
+  big_int<N, T> x{};
+  const auto half = (bits + 1) / 2; // x = 2^ceil(bits / 2) > sqrt(n)
+  x[half / std::numeric_limits<T>::digits] = T{1} << (half % std::numeric_limits<T>::digits);
+  while (true)
+  {
+    const auto y = shift_right(add(x, div(n, x).quotient), 1);
+    if (!(y < x))
+      break;
+    x = first<N>(y);
+  }
+  return mul(x, x) == n;
+}
+
+// the strong probable-prime test to base a (Montgomery form) of the odd n,
+// n - 1 = d 2^s, squaring in Montgomery form
+template<std::size_t N, typename T>
+constexpr bool miller_rabin(const montgomery_context<N, T>& ctx, const big_int<N, T>& a, const big_int<N, T>& d,
+                            std::size_t s)
+{
+  const auto minus_one = subtract_ignore_carry(ctx.modulus, ctx.one);
+  auto x = mod_exp_window<false>(a, d, ctx);
+  if (x == ctx.one || x == minus_one)
+    return true;
+  for (std::size_t i = 1; i < s; ++i)
+  {
+    x = ctx.sqr(x);
+    if (x == minus_one)
+      return true;
+    if (x == ctx.one)
+      return false;
+  }
+  return false;
+}
+
+// the strong Lucas probable-prime test of the odd n with
+// Selfridge's parameters: the first D of 5, -7, 9, -11, ... with
+// (D / n) = -1, P = 1 and Q = (1 - D) / 4. For n + 1 = d 2^s, n passes if
+// U_d = 0 or V_(d 2^r) = 0 for some r < s (mod n), with the sequences in
+// Montgomery form by the doubling formulas
+//   U_2k = U_k V_k,  V_2k = V_k^2 - 2 Q^k,
+//   U_k+1 = (U_k + V_k) / 2,  V_k+1 = (D U_k + V_k) / 2
+template<std::size_t N, typename T>
+constexpr bool strong_lucas(const montgomery_context<N, T>& ctx)
+{
+  const auto& n = ctx.modulus;
+  std::int64_t D = 5;
+  for (;; D = D > 0 ? -(D + 2) : 2 - D)
+  {
+    const int j = jacobi_small(D, n);
+    if (j == -1)
+      break;
+    if (j == 0 && !(n == big_int<1, T>{static_cast<T>(D < 0 ? -D : D)}))
+      return false;
+    if (D == 13 && is_square(n)) // no D exists for squares
+      return false;
+  }
+
+  auto residue = [&](std::int64_t v) {
+    const auto x = ctx.to_montgomery(big_int<N, T>{static_cast<T>(v < 0 ? -v : v)});
+    return v < 0 && x != big_int<N, T>{} ? subtract_ignore_carry(n, x) : x;
+  };
+  auto half = [&](const big_int<N, T>& x) {
+    return first<N>(shift_right(x[0] % 2 != 0 ? add(x, n) : pad<1>(x), 1));
+  };
+  const auto d_residue = residue(D), q_residue = residue((1 - D) / 4);
+
+  const auto [d, s] = factor_out_twos(add(n, big_int<1, T>{1})); // n + 1 = d 2^s
+
+  auto u = ctx.one, v = ctx.one, qk = q_residue; // k = 1
+  for (std::size_t i = bit_length(d) - 1; i-- > 0;)
+  {
+    u = ctx.mul(u, v);
+    v = mod_sub(ctx.sqr(v), mod_add(qk, qk, n), n);
+    qk = ctx.sqr(qk);
+    if ((d[i / std::numeric_limits<T>::digits] >> (i % std::numeric_limits<T>::digits)) & 1)
+    {
+      const auto uk = u;
+      u = half(mod_add(u, v, n));
+      v = half(mod_add(ctx.mul(d_residue, uk), v, n));
+      qk = ctx.mul(qk, q_residue);
+    }
+  }
+
+  const big_int<N, T> zero{};
+  if (u == zero || v == zero)
+    return true;
+  for (std::size_t r = 1; r < s; ++r)
+  {
+    v = mod_sub(ctx.sqr(v), mod_add(qk, qk, n), n);
+    if (v == zero)
+      return true;
+    qk = ctx.sqr(qk);
+  }
+  return false;
+}
+
+// the Baillie-PSW test of the odd n without small prime factors, and
+// `rounds` Miller-Rabin tests to the odd prime bases 3, 5, 7, ...
+template<std::size_t N, typename T>
+constexpr bool baillie_psw(const montgomery_context<N, T>& ctx, std::size_t rounds)
+{
+  const auto& n = ctx.modulus;
+  const auto [d, s] = factor_out_twos(subtract_ignore_carry(n, big_int<N, T>{1})); // n - 1 = d 2^s
+  if (!miller_rabin(ctx, mod_add(ctx.one, ctx.one, n), d, s) || !strong_lucas(ctx))
+    return false;
+
+  for (std::size_t i = 0; i < std::min(rounds, primes_in_limb<T, small_primes>()); ++i)
+  {
+    const auto base = ctx.to_montgomery(big_int<N, T>{static_cast<T>(small_primes[i])});
+    if (!miller_rabin(ctx, base, d, s))
+      return false;
+  }
+  return true;
+}
+
+} // namespace detail
+
+// Probable-prime test for runtime big_ints: trial division by the odd primes
+// below 1024, or 256 for 8-bit limbs (one word remainder per product of
+// primes that fits in a limb), then the Baillie-PSW test, a strong
+// probable-prime test to base 2 (Miller-Rabin) and a strong Lucas test with
+// Selfridge's parameters, both in Montgomery form with dedicated squarings.
+// No composite passing Baillie-PSW is known, and none exists below 2^64.
+// Each further round is a Miller-Rabin test to the next odd prime base 3, 5,
+// 7, ...
+export template<std::size_t N, typename T>
+constexpr bool is_probable_prime(const big_int<N, T>& n, std::size_t rounds = 0)
+{
+  if (n < big_int<1, T>{3})
+    return n == big_int<1, T>{2};
+  if (n[0] % 2 == 0)
+    return false;
+
+  switch (detail::trial_division(n))
+  {
+  case detail::trial_division_result::composite:
+    return false;
+  case detail::trial_division_result::prime:
+    return true;
+  case detail::trial_division_result::undecided:
+    break;
+  }
+
+  return detail::baillie_psw(montgomery_context<N, T>(n), rounds);
+}
+
+} // namespace lam::cbn
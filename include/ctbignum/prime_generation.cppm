@@ -0,0 +1,203 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:prime_generation;
+
+import std;
+
+import :bigint;
+import :slicing;
+import :utility;
+import :addition;
+import :montgomery;
+import :mod_exp;
+import :primality;
+import :thread_pool;
+
+namespace lam::cbn
+{
+
+// Options of generate_prime and generate_safe_prime
+export struct prime_options
+{
+  std::size_t rounds = 0;      // Miller-Rabin rounds after Baillie-PSW, as in is_probable_prime
+  bool top_two_bits = false;   // also set the second highest bit, for products of exactly 2 bits bits
+  thread_pool* pool = nullptr; // search on all threads of the pool
+};
+
+namespace detail
+{
+
+// the sieve primes, and the odd candidates per window
+inline constexpr auto sieve_primes = odd_primes_below<std::size_t{1} << 15>();
+inline constexpr std::size_t sieve_length = 4096;
+
+// whether 2^(n-1) = 1 (mod n): left-to-right binary exponentiation, where
+// multiplying by the base is a doubling
+template<std::size_t N, typename T>
+constexpr bool fermat_base2(const montgomery_context<N, T>& ctx)
+{
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  const auto& n = ctx.modulus;
+  const auto e = subtract_ignore_carry(n, big_int<N, T>{1});
+  auto x = mod_add(ctx.one, ctx.one, n);
+  for (std::size_t i = bit_length(e) - 1; i-- > 0;)
+  {
+    x = ctx.sqr(x);
+    if ((e[i / digits] >> (i % digits)) & 1)
+      x = mod_add(x, x, n);
+  }
+  return x == ctx.one;
+}
+
+// Searches the odd x, x + 2, ... of at most `bits` bits for a prime q (with
+// 2 q + 1 prime too, if safe), or until stop is set. The window of
+// candidates x + 2 k, k < sieve_length, is sieved by the residues of x modulo
+// the sieve primes, which follow the window by addition. Survivors go through
+// the Fermat test to base 2 before Baillie-PSW.
+template<std::size_t N, typename T>
+std::optional<big_int<N, T>> sieve_search(big_int<N, T> x, std::size_t bits, bool safe, std::size_t rounds,
+                                          const std::atomic<bool>& stop)
+{
+  static_assert(std::numeric_limits<T>::digits >= 16, "the sieve primes need limbs of at least 16 bits");
+  constexpr auto products = prime_products<T, sieve_primes>();
+  std::vector<std::uint32_t> residues(sieve_primes.size());
+  for (const auto& p : products)
+  {
+    const T r = mod_word(x, p.divisor, p.reciprocal, p.shift);
+    for (std::size_t i = p.begin; i < p.end; ++i)
+      residues[i] = static_cast<std::uint32_t>(r % sieve_primes[i]);
+  }
+
+  std::vector<bool> composite;
+  while (!stop.load(std::memory_order_relaxed))
+  {
+    // x + 2 k = 0 (mod p) for k = -r / 2, and 2 (x + 2 k) + 1 = 0 for k = (-1/2 - r) / 2
+    composite.assign(sieve_length, false);
+    for (std::size_t i = 0; i < sieve_primes.size(); ++i)
+    {
+      const std::uint64_t p = sieve_primes[i], r = residues[i], half = (p + 1) / 2;
+      for (auto k = (p - r) * half % p; k < sieve_length; k += p)
+        composite[k] = true;
+      if (safe)
+        for (auto k = (half - 1 + p - r) * half % p; k < sieve_length; k += p)
+          composite[k] = true;
+    }
+
+    for (std::size_t k = 0; k < sieve_length; ++k)
+    {
+      if (composite[k])
+        continue;
+      if (stop.load(std::memory_order_relaxed))
+        return std::nullopt;
+      const auto y = add(x, big_int<1, T>{static_cast<T>(2 * k)});
+      if (bit_length(y) > bits)
+        return std::nullopt;
+      const montgomery_context<N, T> ctx_q(first<N>(y));
+      if (!fermat_base2(ctx_q))
+        continue;
+      if (!safe && baillie_psw(ctx_q, rounds))
+        return ctx_q.modulus;
+      if (safe)
+      {
+        const montgomery_context<N, T> ctx_p(first<N>(add(add(ctx_q.modulus, ctx_q.modulus), big_int<1, T>{1})));
+        if (fermat_base2(ctx_p) && baillie_psw(ctx_q, rounds) && baillie_psw(ctx_p, rounds))
+          return ctx_q.modulus;
+      }
+    }
+
+    // the next window
+    const auto step = add(x, big_int<1, T>{static_cast<T>(2 * sieve_length)});
+    if (bit_length(step) > bits)
+      return std::nullopt;
+    x = first<N>(step);
+    for (std::size_t i = 0; i < sieve_primes.size(); ++i)
+      residues[i] = static_cast<std::uint32_t>((residues[i] + 2 * sieve_length) % sieve_primes[i]);
+  }
+  return std::nullopt;
+}
+
+template<std::size_t N, typename T, typename Rng>
+big_int<N, T> generate_prime(Rng& rng, std::size_t bits, const prime_options& options, bool safe)
+{
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  // candidates above the sieve primes
+  if (bits < 17 || bits > N * digits)
+    throw std::runtime_error("generate_prime: the bit length is out of range");
+  const auto candidate_bits = safe ? bits - 1 : bits;
+
+  // a random odd x of candidate_bits bits, the top (two) bits set
+  std::uniform_int_distribution<T> distribution;
+  auto random_start = [&] {
+    big_int<N, T> x{};
+    const auto top = candidate_bits - 1;
+    for (std::size_t i = 0; i <= top / digits; ++i)
+      x[i] = distribution(rng);
+    if (top % digits != digits - 1)
+      x[top / digits] &= static_cast<T>((T{1} << (top % digits + 1)) - 1);
+    x[top / digits] |= static_cast<T>(T{1} << (top % digits));
+    if (options.top_two_bits)
+      x[(top - 1) / digits] |= static_cast<T>(T{1} << ((top - 1) % digits));
+    x[0] |= 1;
+    return x;
+  };
+
+  // each thread searches from random starts until any finds a prime
+  std::atomic<bool> found{false};
+  std::mutex mutex;
+  big_int<N, T> result{};
+  auto search = [&](std::size_t) {
+    while (!found.load(std::memory_order_relaxed))
+    {
+      big_int<N, T> x;
+      {
+        std::lock_guard lock(mutex);
+        x = random_start();
+      }
+      if (const auto q = sieve_search(x, candidate_bits, safe, options.rounds, found))
+      {
+        std::lock_guard lock(mutex);
+        if (!found.exchange(true))
+          result = safe ? first<N>(add(add(*q, *q), big_int<1, T>{1})) : *q;
+      }
+    }
+  };
+  if (options.pool)
+    options.pool->parallel_for(options.pool->size(), search);
+  else
+    search(0);
+  return result;
+}
+
+} // namespace detail
+
+// A random probable prime of exactly `bits` bits (with the second highest bit
+// set too, if options.top_two_bits), by an incremental sieve: windows of
+// odd candidates following a random start are sieved by the odd primes below
+// 2^15, their residues carried from window to window by addition, and the
+// survivors tested by a Fermat test to base 2 and then as by
+// is_probable_prime(p, options.rounds). With options.pool, every thread of
+// the pool searches from its own random starts and all stop once one finds a
+// prime; the result then depends on the timing of the threads. Rng is a
+// uniform random bit generator, drawn from under a lock. Throws
+// std::runtime_error unless 17 <= bits <= N digits.
+export template<std::size_t N, typename T = std::uint64_t, typename Rng>
+big_int<N, T> generate_prime(Rng& rng, std::size_t bits, const prime_options& options = {})
+{ return detail::generate_prime<N, T>(rng, bits, options, false); }
+
+// A random safe prime p = 2 q + 1 of exactly `bits` bits, q prime: the same
+// search over q, sieving both q and 2 q + 1. Throws std::runtime_error unless
+// 17 <= bits <= N digits.
+export template<std::size_t N, typename T = std::uint64_t, typename Rng>
+big_int<N, T> generate_safe_prime(Rng& rng, std::size_t bits, const prime_options& options = {})
+{ return detail::generate_prime<N, T>(rng, bits, options, true); }
+
+} // namespace lam::cbn
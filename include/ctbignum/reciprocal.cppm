@@ -0,0 +1,128 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:reciprocal;
+
+import std;
+
+import :type_traits;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// Division by an invariant word (or double word) with a precomputed
+// reciprocal, as described in "Improved division by invariant integers",
+// by Moller and Granlund, IEEE Transactions on Computers 60(2), 2011
+//
+// Throughout, beta = 2^digits(T) and the divisor is normalized, i.e., its most
+// significant bit is set.
+
+// reciprocal v = floor((beta^2 - 1) / d) - beta of a normalized word d
+export template<typename T>
+constexpr T reciprocal_word(T d)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+  TT num = (static_cast<TT>(static_cast<T>(~d)) << w) | static_cast<T>(~T{0});
+  return static_cast<T>(num / d);
+}
+
+// reciprocal v = floor((beta^3 - 1) / <d1, d0>) - beta of a normalized double word
+export template<typename T>
+constexpr T reciprocal_3by2(T d1, T d0)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  T v = reciprocal_word(d1);
+  T p = static_cast<T>(static_cast<TT>(d1) * v);
+  p = static_cast<T>(p + d0);
+  if (p < d0)
+  {
+    --v;
+    if (p >= d1)
+    {
+      --v;
+      p = static_cast<T>(p - d1);
+    }
+    p = static_cast<T>(p - d1);
+  }
+  TT t = static_cast<TT>(v) * d0;
+  T t1 = static_cast<T>(t >> w);
+  T t0 = static_cast<T>(t);
+  p = static_cast<T>(p + t1);
+  if (p < t1)
+  {
+    --v;
+    if (p > d1 || (p == d1 && t0 >= d0))
+      --v;
+  }
+  return v;
+}
+
+// divide <u1, u0> by the normalized word d, where u1 < d and v = reciprocal_word(d)
+// returns the pair (quotient, remainder)
+export template<typename T>
+constexpr auto udiv_2by1(T u1, T u0, T d, T v)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  TT q = static_cast<TT>(v) * u1 + ((static_cast<TT>(u1) << w) | u0);
+  T q1 = static_cast<T>((q >> w) + 1);
+  T q0 = static_cast<T>(q);
+  T r = static_cast<T>(u0 - static_cast<TT>(q1) * d);
+  if (r > q0)
+  {
+    --q1;
+    r = static_cast<T>(r + d);
+  }
+  if (r >= d) // unlikely
+  {
+    ++q1;
+    r = static_cast<T>(r - d);
+  }
+  return std::pair{q1, r};
+}
+
+// divide <u2, u1, u0> by the normalized double word <d1, d0>, where
+// <u2, u1> < <d1, d0> and v = reciprocal_3by2(d1, d0)
+// returns the pair (quotient, remainder), the remainder as a double word
+export template<typename T>
+constexpr auto udiv_3by2(T u2, T u1, T u0, T d1, T d0, T v)
+{
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  const TT d = (static_cast<TT>(d1) << w) | d0;
+  TT q = static_cast<TT>(v) * u2 + ((static_cast<TT>(u2) << w) | u1);
+  T q1 = static_cast<T>(q >> w);
+  T q0 = static_cast<T>(q);
+  T r1 = static_cast<T>(u1 - static_cast<TT>(q1) * d1);
+  TT r = ((static_cast<TT>(r1) << w) | u0) - static_cast<TT>(d0) * q1 - d;
+  ++q1;
+  if (static_cast<T>(r >> w) >= q0)
+  {
+    --q1;
+    r += d;
+  }
+  if (r >= d) // unlikely
+  {
+    ++q1;
+    r -= d;
+  }
+  return std::pair{q1, r};
+}
+
+} // namespace detail
+} // namespace lam::cbn
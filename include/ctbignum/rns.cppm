@@ -0,0 +1,369 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:rns;
+
+import std;
+
+import :bigint;
+import :slicing;
+import :addition;
+import :mult;
+import :gcd;
+import :field;
+import :precomputed_multiplier;
+import :simd_field;
+import :fma_mulmod;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// f(std::integral_constant<std::size_t, I>{}) for I = 0, ..., N - 1, in order
+template<std::size_t N, typename F>
+constexpr void for_each_index(F&& f)
+{
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    (f(std::integral_constant<std::size_t, I>{}), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+// v < From as an element of Z/ToZ
+template<typename T, T From, T To>
+constexpr ZqElement<T, To> lift_residue(T v)
+{
+  if constexpr (From <= To)
+    return ZqElement<T, To>{big_int<1, T>{v}, skip_reduction{}};
+  else
+    return ZqElement<T, To>{big_int<1, T>{static_cast<T>(v % To)}, skip_reduction{}};
+}
+
+// m as a fixed multiplier in Z/pZ (the mixed radices in base extension)
+template<typename T, T P, T M>
+constexpr precomputed_multiplier<ZqElement<T, P>> radix_multiplier{ZqElement<T, P>{big_int<1, T>{M}}};
+
+template<typename T, T... Moduli>
+struct rns_base
+{
+  static constexpr std::size_t size = sizeof...(Moduli);
+  static constexpr std::array<T, size> moduli{Moduli...};
+
+  static_assert(size > 0 && ((Moduli > 1) && ...));
+  static_assert(
+    [] {
+      for (std::size_t i = 0; i < size; ++i)
+        for (std::size_t j = i + 1; j < size; ++j)
+          if (std::gcd(moduli[i], moduli[j]) != 1)
+            return false;
+      return true;
+    }(),
+    "the moduli of a residue number system must be pairwise coprime");
+
+  template<std::size_t K>
+  using element = ZqElement<T, moduli[K]>;
+
+  // Garner's constants m_j^-1 mod m_k for j < k, by the compile-time
+  // extended Euclidean algorithm on integer sequences
+  template<std::size_t J, std::size_t K>
+  static constexpr precomputed_multiplier<element<K>> garner_inverse{element<K>{
+    mod_inv(std::integer_sequence<T, moduli[J] % moduli[K]>{}, std::integer_sequence<T, moduli[K]>{})}};
+
+  // Horner's rule for x = v_0 + m_0 (v_1 + m_1 (v_2 + ...)) mod p,
+  // given the mixed-radix digit v_j of x by get(j)
+  template<T P, typename Get>
+  static constexpr ZqElement<T, P> evaluate_mixed_radix(Get&& get)
+  {
+    auto acc = lift_residue<T, moduli[size - 1], P>(get(size - 1));
+    for_each_index<size - 1>([&](auto i) {
+      constexpr std::size_t j = size - 2 - decltype(i)::value;
+      acc = acc * radix_multiplier<T, P, moduli[j]> + lift_residue<T, moduli[j], P>(get(j));
+    });
+    return acc;
+  }
+};
+
+} // namespace detail
+
+// An integer x in [0, M), M = m_0 * ... * m_{K-1}, represented by its residues
+// x mod m_k for pairwise coprime word-size moduli m_k. Addition, subtraction
+// and multiplication act on each residue independently, without carries
+// between them; the residues are single-limb ZqElements.
+//
+// reconstruct() recovers x as a big_int by Garner's algorithm, and
+// base_extend() computes the residues of x modulo other moduli from its
+// mixed-radix digits, without forming x.
+export template<typename T, T... Moduli>
+struct rns_int
+{
+  using value_type = T;
+  using base = detail::rns_base<T, Moduli...>;
+  static constexpr std::size_t size = base::size;
+
+  std::tuple<ZqElement<T, Moduli>...> residues;
+
+  constexpr rns_int() = default;
+
+  constexpr rns_int(long x) : residues(ZqElement<T, Moduli>{x}...) {}
+
+  template<std::size_t N>
+  constexpr explicit rns_int(big_int<N, T> x) : residues(ZqElement<T, Moduli>{x}...)
+  {}
+
+  constexpr explicit rns_int(ZqElement<T, Moduli>... r) : residues(r...) {}
+
+  template<std::size_t K>
+  constexpr auto& get()
+  { return std::get<K>(residues); }
+
+  template<std::size_t K>
+  constexpr const auto& get() const
+  { return std::get<K>(residues); }
+
+  // the digits v_k < m_k of x = v_0 + v_1 m_0 + v_2 m_0 m_1 + ... (Garner)
+  constexpr std::array<T, size> mixed_radix() const
+  {
+    std::array<T, size> v{};
+    detail::for_each_index<size>([&](auto k) {
+      constexpr std::size_t K = decltype(k)::value;
+      auto t = get<K>();
+      detail::for_each_index<K>([&](auto j) {
+        constexpr std::size_t J = decltype(j)::value;
+        t = (t - detail::lift_residue<T, base::moduli[J], base::moduli[K]>(v[J])) *
+            base::template garner_inverse<J, K>;
+      });
+      v[K] = t.data[0];
+    });
+    return v;
+  }
+
+  // x as an integer in [0, M)
+  constexpr big_int<size, T> reconstruct() const
+  {
+    const auto v = mixed_radix();
+    big_int<size, T> x{};
+    x[0] = v[size - 1];
+    for (std::size_t j = size - 1; j-- > 0;)
+      x = detail::first<size>(add(short_mul(x, base::moduli[j]), big_int<1, T>{v[j]}));
+    return x;
+  }
+
+  // the residues of x modulo Others..., which need not be coprime to Moduli...
+  template<T... Others>
+  constexpr rns_int<T, Others...> base_extend() const
+  {
+    const auto v = mixed_radix();
+    rns_int<T, Others...> r;
+    detail::for_each_index<sizeof...(Others)>([&](auto i) {
+      constexpr T p = std::array<T, sizeof...(Others)>{Others...}[decltype(i)::value];
+      std::get<decltype(i)::value>(r.residues) =
+        base::template evaluate_mixed_radix<p>([&](std::size_t j) { return v[j]; });
+    });
+    return r;
+  }
+};
+
+export template<typename T, T... M>
+constexpr auto& operator+=(rns_int<T, M...>& a, const rns_int<T, M...>& b)
+{
+  detail::for_each_index<sizeof...(M)>([&](auto k) { std::get<k>(a.residues) += std::get<k>(b.residues); });
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto operator+(rns_int<T, M...> a, const rns_int<T, M...>& b)
+{
+  a += b;
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto& operator-=(rns_int<T, M...>& a, const rns_int<T, M...>& b)
+{
+  detail::for_each_index<sizeof...(M)>([&](auto k) { std::get<k>(a.residues) -= std::get<k>(b.residues); });
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto operator-(rns_int<T, M...> a, const rns_int<T, M...>& b)
+{
+  a -= b;
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto operator-(const rns_int<T, M...>& a)
+{ return rns_int<T, M...>{} - a; }
+
+export template<typename T, T... M>
+constexpr auto& operator*=(rns_int<T, M...>& a, const rns_int<T, M...>& b)
+{
+  detail::for_each_index<sizeof...(M)>([&](auto k) { std::get<k>(a.residues) *= std::get<k>(b.residues); });
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr auto operator*(rns_int<T, M...> a, const rns_int<T, M...>& b)
+{
+  a *= b;
+  return a;
+}
+
+export template<typename T, T... M>
+constexpr bool operator==(const rns_int<T, M...>& a, const rns_int<T, M...>& b)
+{ return a.residues == b.residues; }
+
+// A vector of rns_ints in structure-of-arrays layout: one contiguous
+// channel of ZqElements per modulus. Element-wise arithmetic runs channel by
+// channel through the span kernels (mulmod, addmod), and base extension
+// streams over whole channels with the constants of each step hoisted.
+export template<typename T, T... Moduli>
+class rns_vector
+{
+public:
+  using value_type = rns_int<T, Moduli...>;
+  using base = detail::rns_base<T, Moduli...>;
+  static constexpr std::size_t channels = base::size;
+
+  rns_vector() = default;
+
+  explicit rns_vector(std::size_t n) : channels_(std::vector<ZqElement<T, Moduli>>(n)...) {}
+
+  explicit rns_vector(std::span<const value_type> values) : rns_vector(values.size())
+  {
+    for (std::size_t i = 0; i < values.size(); ++i)
+      set(i, values[i]);
+  }
+
+  std::size_t size() const { return std::get<0>(channels_).size(); }
+
+  value_type operator[](std::size_t i) const
+  {
+    value_type x;
+    detail::for_each_index<channels>([&](auto k) { std::get<k>(x.residues) = std::get<k>(channels_)[i]; });
+    return x;
+  }
+
+  void set(std::size_t i, const value_type& x)
+  {
+    detail::for_each_index<channels>([&](auto k) { std::get<k>(channels_)[i] = std::get<k>(x.residues); });
+  }
+
+  // the residues modulo the K-th modulus
+  template<std::size_t K>
+  std::span<typename base::template element<K>> channel()
+  { return std::get<K>(channels_); }
+
+  template<std::size_t K>
+  std::span<const typename base::template element<K>> channel() const
+  { return std::get<K>(channels_); }
+
+  // element-wise arithmetic; throws std::runtime_error if the sizes differ
+  rns_vector& operator+=(const rns_vector& other)
+  {
+    check_size(other);
+    detail::for_each_index<channels>([&](auto k) {
+      auto& a = std::get<k>(channels_);
+      addmod(std::span{a}, a, std::get<k>(other.channels_));
+    });
+    return *this;
+  }
+
+  rns_vector& operator-=(const rns_vector& other)
+  {
+    check_size(other);
+    detail::for_each_index<channels>([&](auto k) {
+      auto& a = std::get<k>(channels_);
+      const auto& b = std::get<k>(other.channels_);
+      for (std::size_t i = 0; i < a.size(); ++i)
+        a[i] -= b[i];
+    });
+    return *this;
+  }
+
+  rns_vector& operator*=(const rns_vector& other)
+  {
+    check_size(other);
+    detail::for_each_index<channels>([&](auto k) {
+      constexpr T m = base::moduli[decltype(k)::value];
+      auto& a = std::get<k>(channels_);
+      const auto& b = std::get<k>(other.channels_);
+      if constexpr (detail::simd_field<T, m> || static_cast<std::uint64_t>(m) < (std::uint64_t{1} << 50))
+        mulmod(std::span{a}, a, b);
+      else
+        for (std::size_t i = 0; i < a.size(); ++i)
+          a[i] *= b[i];
+    });
+    return *this;
+  }
+
+  // channel k holds the k-th mixed-radix digits, see rns_int::mixed_radix
+  std::array<std::vector<T>, channels> mixed_radix() const
+  {
+    const std::size_t n = size();
+    std::array<std::vector<T>, channels> v;
+    detail::for_each_index<channels>([&](auto k) {
+      constexpr std::size_t K = decltype(k)::value;
+      std::vector<typename base::template element<K>> t = std::get<K>(channels_);
+      detail::for_each_index<K>([&](auto j) {
+        constexpr std::size_t J = decltype(j)::value;
+        const auto& c = base::template garner_inverse<J, K>;
+        for (std::size_t i = 0; i < n; ++i)
+          t[i] = (t[i] - detail::lift_residue<T, base::moduli[J], base::moduli[K]>(v[J][i])) * c;
+      });
+      v[K].resize(n);
+      for (std::size_t i = 0; i < n; ++i)
+        v[K][i] = t[i].data[0];
+    });
+    return v;
+  }
+
+  // see rns_int::base_extend
+  template<T... Others>
+  rns_vector<T, Others...> base_extend() const
+  {
+    const std::size_t n = size();
+    const auto v = mixed_radix();
+    rns_vector<T, Others...> r(n);
+    detail::for_each_index<sizeof...(Others)>([&](auto k) {
+      constexpr T p = std::array<T, sizeof...(Others)>{Others...}[decltype(k)::value];
+      auto out = r.template channel<decltype(k)::value>();
+      for (std::size_t i = 0; i < n; ++i)
+        out[i] = base::template evaluate_mixed_radix<p>([&](std::size_t j) { return v[j][i]; });
+    });
+    return r;
+  }
+
+  friend bool operator==(const rns_vector& a, const rns_vector& b) { return a.channels_ == b.channels_; }
+
+private:
+  void check_size(const rns_vector& other) const
+  {
+    if (other.size() != size())
+      throw std::runtime_error("rns_vector: size mismatch");
+  }
+
+  std::tuple<std::vector<ZqElement<T, Moduli>>...> channels_;
+};
+
+export template<typename T, T... M>
+rns_vector<T, M...> operator+(rns_vector<T, M...> a, const rns_vector<T, M...>& b)
+{ return a += b; }
+
+export template<typename T, T... M>
+rns_vector<T, M...> operator-(rns_vector<T, M...> a, const rns_vector<T, M...>& b)
+{ return a -= b; }
+
+export template<typename T, T... M>
+rns_vector<T, M...> operator*(rns_vector<T, M...> a, const rns_vector<T, M...>& b)
+{ return a *= b; }
+
+} // namespace lam::cbn
@@ -18,6 +18,10 @@ import :mod_exp;
 import :addition;
 import :bitshift;
 import :utility;
+import :montgomery;
+import :primality;
+import :division;
+import :gcd;
 
 namespace lam::cbn
 {
@@ -25,20 +29,8 @@ namespace lam::cbn
 namespace detail
 {
 
-// Factor p - 1 = Q * 2^S where Q is odd
-template<std::size_t N, typename T>
-constexpr auto factor_out_twos(big_int<N, T> n)
-{
-  std::size_t S = 0;
-  while ((n[0] & 1) == 0)
-  {
-    n = shift_right(n, 1);
-    ++S;
-  }
-  return std::pair{n, S};
-}
-
-// Factor n = d * val^S
+// Factor n = d * val^S; for odd val, the exact division by val also tells
+// whether val divides n
 template<std::size_t N, typename T>
 constexpr auto factor_out_val(big_int<N, T> n, T val)
 {
@@ -48,6 +40,16 @@ constexpr auto factor_out_val(big_int<N, T> n, T val)
 
   while (true)
   {
+    if (val % 2 != 0)
+    {
+      const auto [quotient, borrow] = bdiv_by_limb(n, val);
+      if (borrow != 0)
+        break;
+      n = quotient;
+      ++S;
+      continue;
+    }
+
     auto division = div(n, val_bi);
     if (division.remainder == zero)
     {
@@ -60,289 +62,393 @@ constexpr auto factor_out_val(big_int<N, T> n, T val)
   return std::pair{n, S};
 }
 
-// Miller-Rabin primality test
-// Returns true if n is (likely) prime, false if composite
+// primality of a compile-time modulus, decided once at compile time by
+// is_probable_prime (Baillie-PSW, exact below 2^64)
 template<typename T, T... Modulus>
 constexpr bool is_prime(std::integer_sequence<T, Modulus...>)
 {
-  constexpr std::size_t N = sizeof...(Modulus);
-  constexpr auto n = big_int<N, T>{Modulus...};
-  constexpr auto one = big_int<N, T>{1};
-  constexpr auto two = big_int<N, T>{2};
-
-  // Small numbers check
-  if (n < two)
-    return false;
-  if (n == two || n == big_int<N, T>{3})
-    return true;
-  if ((n[0] & 1) == 0)
-    return false;
-
-  // Write n-1 = d * 2^r
-  auto n_minus_1 = subtract_ignore_carry(n, one);
-  auto [d, r] = factor_out_twos(n_minus_1);
-
-  // Bases for witness checking (first 12 primes is sufficient for < 2^64)
-  constexpr unsigned bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
-
-  for (auto a_val : bases)
-  {
-    auto a = big_int<N, T>{static_cast<T>(a_val)};
-    if (n <= a)
-      break;
+  constexpr bool prime = is_probable_prime(big_int<sizeof...(Modulus), T>{Modulus...});
+  return prime;
+}
 
-    // Compute x = a^d mod n
-    auto x = mod_exp(a, d, std::integer_sequence<T, Modulus...>{});
+// the least z = 2, 3, ... with z^e != 1 (mod p): a quadratic (cubic)
+// non-residue for e = (p - 1) / 2 ((p - 1) / 3)
+template<typename T, T... Modulus, std::size_t N2>
+constexpr auto least_nonresidue(const big_int<N2, T>& e)
+{
+  constexpr auto one = big_int<sizeof...(Modulus), T>{1};
+  auto z = big_int<sizeof...(Modulus), T>{2};
+  while (mod_exp(z, e, std::integer_sequence<T, Modulus...>{}) == one)
+    z = add_ignore_carry(z, one);
+  return z;
+}
 
-    if (x == one || x == n_minus_1)
-      continue;
+// x^(k^j) for j <= Count, by repeated squares (k = 2) or cubes (k = 3)
+template<std::size_t Count, typename T, T... Modulus>
+constexpr auto repeated_powers(ZqElement<T, Modulus...> x, int k)
+{
+  std::array<ZqElement<T, Modulus...>, Count + 1> powers{};
+  powers[0] = x;
+  for (std::size_t j = 1; j <= Count; ++j)
+    powers[j] = k == 2 ? powers[j - 1] * powers[j - 1] : powers[j - 1] * powers[j - 1] * powers[j - 1];
+  return powers;
+}
 
-    bool witness_found = false;
-    for (std::size_t i = 1; i < r; ++i)
+// The modulus-only constants of sqrt, computed once per field at compile
+// time. For the prime p, p - 1 = Q 2^S: the exponents, and the powers
+// c^(2^j), j <= S, of c = z^Q for the least non-residue z, the generator of
+// the 2-Sylow subgroup. Tonelli-Shanks takes its b = c^(2^(M - i - 1)) from
+// this table instead of squaring c at runtime.
+template<typename T, T... Modulus>
+struct sqrt_traits
+{
+  using field = ZqElement<T, Modulus...>;
+  static constexpr std::size_t N = sizeof...(Modulus);
+  static constexpr big_int<N, T> p{Modulus...};
+  static constexpr bool prime = is_prime(std::integer_sequence<T, Modulus...>{});
+
+  static constexpr auto p_minus_1 = subtract_ignore_carry(p, big_int<N, T>{1});
+  static constexpr auto euler_exp = shift_right(p_minus_1, 1); // (p - 1) / 2
+  static constexpr auto QS = prime ? factor_out_twos(p_minus_1) : std::pair{p_minus_1, std::size_t{0}};
+  static constexpr auto Q = QS.first;
+  static constexpr std::size_t S = QS.second;
+  static constexpr auto half_exp = shift_right(Q, 1); // (Q - 1) / 2
+
+  static constexpr auto z = prime && S > 1 ? least_nonresidue<T, Modulus...>(euler_exp) : big_int<N, T>{};
+  static constexpr auto c_powers =
+    prime && S > 1 ? repeated_powers<S>(field{mod_exp(z, Q, std::integer_sequence<T, Modulus...>{}), skip_reduction{}}, 2)
+                   : std::array<field, S + 1>{};
+};
+
+// The modulus-only constants of cbrt. For p = 2 (mod 3), the exponent
+// (2 p - 1) / 3 of the unique cube root. For p = 1 (mod 3), p - 1 = t 3^S:
+// the exponents of Adleman-Manders-Miller, k = 1 / 3 (mod t) as
+// (1 + m t) / 3 with m = 1 or 2, and the powers g^(3^j), j <= S, of
+// g = z^t for the least cubic non-residue z.
+template<typename T, T... Modulus>
+struct cbrt_traits
+{
+  using field = ZqElement<T, Modulus...>;
+  static constexpr std::size_t N = sizeof...(Modulus);
+  static constexpr big_int<N, T> p{Modulus...};
+  static constexpr bool prime = sqrt_traits<T, Modulus...>::prime;
+  static constexpr T p_mod_3 = short_div(p, T{3}).remainder[0];
+
+  static constexpr auto p_minus_1 = subtract_ignore_carry(p, big_int<N, T>{1});
+  static constexpr auto unique_exp = // (2 p - 1) / 3, for p = 2 (mod 3)
+    p_mod_3 == 2 ? divexact_by_limb(subtract_ignore_carry(add_ignore_carry(p, p), big_int<N, T>{1}), T{3})
+                 : big_int<N, T>{};
+  static constexpr bool amm = prime && p_mod_3 == 1;
+  static constexpr auto residue_exp = amm ? divexact_by_limb(p_minus_1, T{3}) : big_int<N, T>{}; // (p - 1) / 3
+  static constexpr auto tS = amm ? factor_out_val(p_minus_1, T{3}) : std::pair{p_minus_1, std::size_t{0}};
+  static constexpr auto t = tS.first;
+  static constexpr std::size_t S = tS.second;
+  static constexpr T m = short_div(t, T{3}).remainder[0] == 1 ? 2 : 1;
+  static constexpr auto k_minus_1 = // (1 + m t) / 3 - 1
+    amm ? subtract_ignore_carry(divexact_by_limb(add_ignore_carry(first<N>(mul(t, big_int<1, T>{m})), big_int<N, T>{1}),
+                                                 T{3}),
+                                big_int<N, T>{1})
+        : big_int<N, T>{};
+
+  static constexpr auto z = amm ? least_nonresidue<T, Modulus...>(residue_exp) : big_int<N, T>{};
+  static constexpr auto g_powers =
+    amm ? repeated_powers<S>(field{mod_exp(z, t, std::integer_sequence<T, Modulus...>{}), skip_reduction{}}, 3)
+        : std::array<field, S + 1>{};
+};
+
+// all ones if a == b, else zero, without branches
+template<std::size_t N, typename T>
+constexpr T equal_mask_ct(const big_int<N, T>& a, const big_int<N, T>& b)
+{
+  T d = 0;
+  for (std::size_t i = 0; i < N; ++i)
+    d |= a[i] ^ b[i];
+  return static_cast<T>(((d | static_cast<T>(T{0} - d)) >> (std::numeric_limits<T>::digits - 1)) - 1);
+}
+
+// The tables of Sarkar's windowed Tonelli-Shanks, in Montgomery form. For g
+// of order 2^S and the discrete logarithm k = sum_i k_i 2^(W i) of t = g^k
+// in chunks k_i of W bits:
+//   dlog[j] = g^(j 2^(S - W)), the subgroup of order 2^W, which gives k_i,
+//   correct[i][j] = g^(-j 2^(W i)), which clears k_i from t,
+//   root[i][j] = g^(-floor(j 2^(W i) / 2)), whose product is g^(-k / 2).
+template<std::size_t S, std::size_t W, std::size_t N, typename T>
+struct sarkar_tables
+{
+  static constexpr std::size_t chunks = (S + W - 1) / W;
+  using table = std::array<big_int<N, T>, std::size_t{1} << W>;
+
+  table dlog{};
+  std::array<table, chunks> correct{}, root{};
+
+  constexpr sarkar_tables(const montgomery_context<N, T>& ctx, big_int<N, T> g)
+  {
+    auto squarings = [&](big_int<N, T> x, std::size_t count) {
+      for (std::size_t i = 0; i < count; ++i)
+        x = ctx.sqr(x);
+      return x;
+    };
+    auto powers = [&](table& powers, big_int<N, T> x) {
+      powers[0] = ctx.one;
+      for (std::size_t j = 1; j < powers.size(); ++j)
+        powers[j] = ctx.mul(powers[j - 1], x);
+    };
+
+    powers(dlog, squarings(g, S - W));
+    auto g_inv = ctx.one; // g^(2^S - 1)
+    for (std::size_t i = 0; i < S; ++i, g = ctx.sqr(g))
+      g_inv = ctx.mul(g_inv, g);
+    for (std::size_t i = 0; i < chunks; ++i)
     {
-      x = mod_exp(x, two, std::integer_sequence<T, Modulus...>{});
-      if (x == n_minus_1)
-      {
-        witness_found = true;
-        break;
-      }
+      powers(correct[i], squarings(g_inv, W * i));
+      if (i > 0)
+        powers(root[i], squarings(g_inv, W * i - 1));
+      else
+        for (std::size_t j = 0; j < root[0].size(); ++j)
+          root[0][j] = j < 2 ? ctx.one : ctx.mul(root[0][j - 2], g_inv);
     }
+  }
+};
+
+// The constants of sqrt_ct, sqrt_ratio and inv_sqrt for an odd prime field:
+// its Montgomery context, and the Sarkar tables for g = z^Q (-1 for S = 1)
+// with chunks of up to 5 bits
+template<typename T, T... Modulus>
+struct sqrt_ct_traits
+{
+  using base = sqrt_traits<T, Modulus...>;
+  static_assert(base::prime && base::p[0] % 2 == 1, "constant-time roots need an odd prime modulus");
+  static constexpr std::size_t N = base::N, S = base::S;
+  static constexpr std::size_t W = std::min<std::size_t>(S, 5);
+  static constexpr montgomery_context<N, T> ctx{base::p};
+  static constexpr sarkar_tables<S, W, N, T> tables{
+    ctx, ctx.to_montgomery(S > 1 ? base::c_powers[0].data : base::p_minus_1)};
+};
+
+// r with r^2 = a, given x and t = x^2 / a = g^k (Montgomery form): for each
+// chunk from the bottom, t g^(-(k mod 2^(W i))) squared into the subgroup of
+// order 2^W and matched against the dlog table gives k_i; then
+// r = x g^(-k / 2). The operation count is fixed, and tables are read whole.
+// For non-squares k is odd and r^2 != a.
+template<typename T, T... Modulus>
+constexpr auto sarkar_root(big_int<sizeof...(Modulus), T> x, big_int<sizeof...(Modulus), T> t)
+{
+  using traits = sqrt_ct_traits<T, Modulus...>;
+  constexpr auto& ctx = traits::ctx;
+  constexpr auto& tables = traits::tables;
+  constexpr std::size_t S = traits::S, W = traits::W;
 
-    if (!witness_found)
-      return false; // Composite
+  for (std::size_t i = 0; i < tables.chunks; ++i)
+  {
+    const std::size_t width = std::min(W, S - W * i);
+    auto y = t;
+    for (std::size_t j = 0; j < S - W * i - width; ++j)
+      y = ctx.mul_ct(y, y);
+    T index = 0;
+    for (std::size_t j = 0; j < tables.dlog.size(); ++j)
+      index |= static_cast<T>(j) & equal_mask_ct(y, tables.dlog[j]);
+    index >>= W - width; // y = h^(k_i 2^(W - width))
+    t = ctx.mul_ct(t, lookup_ct(tables.correct[i], index));
+    x = ctx.mul_ct(x, lookup_ct(tables.root[i], index));
   }
-  return true; // Likely prime
+  return x;
+}
+
+// r (Montgomery form) if r^2 v = u, else nullopt; the only branch on data
+template<typename T, T... Modulus>
+constexpr auto checked_root(big_int<sizeof...(Modulus), T> r, big_int<sizeof...(Modulus), T> u,
+                            big_int<sizeof...(Modulus), T> v) -> std::optional<ZqElement<T, Modulus...>>
+{
+  constexpr auto& ctx = sqrt_ct_traits<T, Modulus...>::ctx;
+  const T valid = equal_mask_ct(ctx.mul_ct(ctx.mul_ct(r, r), v), u);
+  const ZqElement<T, Modulus...> root{ctx.mul_ct(r, big_int<sizeof...(Modulus), T>{1}), skip_reduction{}};
+  if (valid == 0)
+    return std::nullopt;
+  return root;
 }
 
 } // namespace detail
 
-// Check if n is a quadratic residue mod p using Euler's criterion
-// n^((p - 1) / 2) ≡ 1 (mod p) iff n is a quadratic residue
+// The Legendre symbol (n / p): 1 if n is a non-zero square, -1 if it is not,
+// 0 for n = 0. By the binary Jacobi symbol, cheaper than Euler's criterion
+// n^((p - 1) / 2); for a composite modulus, the Jacobi symbol.
 export template<typename T, T... Modulus>
-constexpr bool is_quadratic_residue(ZqElement<T, Modulus...> n)
-{
-  constexpr auto p = big_int<sizeof...(Modulus), T>{Modulus...};
-  constexpr auto one = big_int<sizeof...(Modulus), T>{1};
-  constexpr auto p_minus_1 = subtract_ignore_carry(p, one);
-  constexpr auto exp = shift_right(p_minus_1, 1); // (p - 1) / 2
+constexpr int legendre(ZqElement<T, Modulus...> n)
+{ return jacobi(n.data, big_int<sizeof...(Modulus), T>{Modulus...}); }
 
-  if (n.data == big_int<sizeof...(Modulus), T>{})
-    return true; // 0 is considered a residue (sqrt(0) = 0)
+// the same in constant time
+export template<typename T, T... Modulus>
+constexpr int legendre_ct(ZqElement<T, Modulus...> n)
+{ return jacobi_ct(n.data, big_int<sizeof...(Modulus), T>{Modulus...}); }
 
-  auto result = mod_exp(n.data, exp, std::integer_sequence<T, Modulus...>{});
-  return result == one;
+// Check if n is a quadratic residue mod p by its Legendre symbol (0 is
+// considered a residue, sqrt(0) = 0). p must be prime: modulo a composite,
+// a Jacobi symbol of 1 does not imply a residue
+export template<typename T, T... Modulus>
+constexpr bool is_quadratic_residue(ZqElement<T, Modulus...> n)
+{
+  constexpr big_int<sizeof...(Modulus), T> p{Modulus...};
+  if constexpr (p == big_int<sizeof...(Modulus), T>{2})
+    return true; // GF(2)
+  else
+  {
+    static_assert(detail::sqrt_traits<T, Modulus...>::prime, "is_quadratic_residue requires a prime modulus");
+    return legendre(n) != -1;
+  }
 }
 
-// Tonelli-Shanks algorithm for computing modular square roots
+// Tonelli-Shanks algorithm for computing modular square roots, with the
+// modulus-only work in detail::sqrt_traits
 // Returns std::optional<ZqElement> - nullopt if n is not a quadratic residue
 export template<typename T, T... Modulus>
 constexpr auto sqrt(ZqElement<T, Modulus...> n) -> std::optional<ZqElement<T, Modulus...>>
 {
-  constexpr std::size_t N = sizeof...(Modulus);
-  constexpr auto p = big_int<N, T>{Modulus...};
-  constexpr auto one = big_int<N, T>{1};
-  constexpr auto two = big_int<N, T>{2};
-  constexpr auto p_minus_1 = subtract_ignore_carry(p, one);
-  // Handle zero
-  if (n.data == big_int<N, T>{})
-    return ZqElement<T, Modulus...>{};
+  using traits = detail::sqrt_traits<T, Modulus...>;
+  using field = ZqElement<T, Modulus...>;
+  constexpr auto power = [](field x, const auto& e) {
+    return field{mod_exp(x.data, e, std::integer_sequence<T, Modulus...>{}), skip_reduction{}};
+  };
+  const field one{1};
 
-  // Check primality to prevent infinite loops (and ensure field properties)
-  if (!detail::is_prime(std::integer_sequence<T, Modulus...>{}))
-    return std::nullopt;
-  // Check if n is a quadratic residue to prevent infinite loops
-  if (!is_quadratic_residue(n))
+  // Handle zero
+  if (n.data == big_int<sizeof...(Modulus), T>{})
+    return field{};
+  // Only fields: the modulus must be prime
+  if constexpr (!traits::prime)
     return std::nullopt;
-  // Factor p - 1 = Q * 2^S
-  constexpr auto QS = detail::factor_out_twos(p_minus_1);
-  constexpr auto Q = QS.first;
-  constexpr std::size_t S = QS.second;
-  // Special case: p ≡ 3 (mod 4), i.e., S == 1
-  // sqrt(n) = n^((p + 1) / 4)
-  if constexpr (S == 1)
-  {
-    constexpr auto exp = shift_right(add_ignore_carry(p, one), 2);
-    auto result = mod_exp(n.data, exp, std::integer_sequence<T, Modulus...>{});
-    return ZqElement<T, Modulus...>{result};
-  }
   else
-  { // Find a quadratic non-residue z
-    constexpr auto neg_one = subtract_ignore_carry(p, one);
-    constexpr auto legendre_exp = shift_right(p_minus_1, 1);
-    big_int<N, T> z{2};
-    while (mod_exp(z, legendre_exp, std::integer_sequence<T, Modulus...>{}) != neg_one)
-      z = add_ignore_carry(z, one);
-    // Initialize
-    std::size_t M = S;
-    auto c = mod_exp(z, Q, std::integer_sequence<T, Modulus...>{});
-    auto t = mod_exp(n.data, Q, std::integer_sequence<T, Modulus...>{});
-    // R = n^((Q + 1) / 2)
-    auto Q_plus_1_div_2 = shift_right(add_ignore_carry(Q, one), 1);
-    auto R = mod_exp(n.data, Q_plus_1_div_2, std::integer_sequence<T, Modulus...>{});
-    while (t != one)
-    { // Find the least i such that t^(2^i) = 1
-      std::size_t i = 1;
-      auto temp = mod_exp(t, two, std::integer_sequence<T, Modulus...>{});
-      while (temp != one && i < M)
-      {
-        temp = mod_exp(temp, two, std::integer_sequence<T, Modulus...>{});
-        ++i;
+  {
+    if (!is_quadratic_residue(n))
+      return std::nullopt;
+
+    // Special case: p ≡ 3 (mod 4), i.e., S == 1
+    // sqrt(n) = n^((Q + 1) / 2) = n^((p + 1) / 4)
+    if constexpr (traits::S <= 1)
+      return power(n, traits::half_exp) * n;
+    else
+    { // R = n^((Q + 1) / 2) and t = n^Q from one exponentiation w = n^((Q - 1) / 2)
+      const auto w = power(n, traits::half_exp);
+      auto R = w * n;
+      auto t = R * w;
+      // invariant: c = z^(Q 2^(S - M)), so b = c^(2^(M - i - 1)) = z^(Q 2^(S - i - 1))
+      std::size_t M = traits::S;
+      while (t != one)
+      { // Find the least i such that t^(2^i) = 1
+        std::size_t i = 0;
+        for (auto y = t; y != one; y = y * y)
+          if (++i == M)
+            return std::nullopt;
+        R *= traits::c_powers[traits::S - i - 1];
+        t *= traits::c_powers[traits::S - i];
+        M = i;
       }
-      // b = c^(2^(M - i - 1))
-      auto b = c;
-      for (std::size_t j = 0; j < M - i - 1; ++j)
-        b = mod_exp(b, two, std::integer_sequence<T, Modulus...>{});
-      M = i;
-      c = mod_exp(b, two, std::integer_sequence<T, Modulus...>{});
-      // t = t * c, R = R * b (using field multiplication via mod)
-      t = mod(mul(t, c), std::integer_sequence<T, Modulus...>{});
-      R = mod(mul(R, b), std::integer_sequence<T, Modulus...>{});
+      return R;
     }
-    return ZqElement<T, Modulus...>{R};
   }
 }
 
-// Cube root in finite field
-// Uses the formula: cbrt(a) = a^((2 * (p - 1)) / 3) when p ≡ 2 (mod 3)
+// Constant-time square root: the exponentiation n^((Q - 1) / 2) by fixed
+// windows, then Sarkar's windowed Tonelli-Shanks with the tables of
+// detail::sqrt_ct_traits, O(S^2 / w) squarings for chunks of w = min(S, 5)
+// bits. The operations and memory accesses depend only on the field, save
+// the final check: nullopt if n is not a square.
+export template<typename T, T... Modulus>
+constexpr auto sqrt_ct(ZqElement<T, Modulus...> n) -> std::optional<ZqElement<T, Modulus...>>
+{
+  using traits = detail::sqrt_ct_traits<T, Modulus...>;
+  constexpr auto& ctx = traits::ctx;
+  const auto a = ctx.mul_ct(n.data, ctx.r2);
+  const auto w = detail::mod_exp_window<true>(a, traits::base::half_exp, ctx);
+  const auto x = ctx.mul_ct(w, a); // n^((Q + 1) / 2), and t = x w = n^Q
+  return detail::checked_root<T, Modulus...>(detail::sarkar_root<T, Modulus...>(x, ctx.mul_ct(x, w)), a, ctx.one);
+}
+
+// sqrt(u / v) in constant time, without an inversion: with
+// w = (u v^(2^(S + 1) - 1))^((Q - 1) / 2) v^(2^S - 1), x = u w satisfies
+// x^2 = (u / v)^(Q + 1) and t = x w v = (u / v)^Q, as in sqrt_ct. nullopt if
+// u / v is not a square; v must not be zero.
+export template<typename T, T... Modulus>
+constexpr auto sqrt_ratio(ZqElement<T, Modulus...> u, ZqElement<T, Modulus...> v)
+  -> std::optional<ZqElement<T, Modulus...>>
+{
+  using traits = detail::sqrt_ct_traits<T, Modulus...>;
+  constexpr auto& ctx = traits::ctx;
+  const auto a = ctx.mul_ct(u.data, ctx.r2), b = ctx.mul_ct(v.data, ctx.r2);
+  auto b1 = b; // v^(2^S - 1)
+  for (std::size_t i = 1; i < traits::S; ++i)
+    b1 = ctx.mul_ct(ctx.mul_ct(b1, b1), b);
+  const auto b2 = ctx.mul_ct(ctx.mul_ct(b1, b1), b); // v^(2^(S + 1) - 1)
+  const auto w = ctx.mul_ct(detail::mod_exp_window<true>(ctx.mul_ct(a, b2), traits::base::half_exp, ctx), b1);
+  const auto x = ctx.mul_ct(w, a);
+  return detail::checked_root<T, Modulus...>(detail::sarkar_root<T, Modulus...>(x, ctx.mul_ct(x, ctx.mul_ct(w, b))), a,
+                                             b);
+}
+
+// 1 / sqrt(v) in constant time, as sqrt_ratio(1, v)
+export template<typename T, T... Modulus>
+constexpr auto inv_sqrt(ZqElement<T, Modulus...> v) -> std::optional<ZqElement<T, Modulus...>>
+{ return sqrt_ratio(ZqElement<T, Modulus...>{1}, v); }
+
+// Cube root in finite field, with the modulus-only work in
+// detail::cbrt_traits
+// Uses the formula: cbrt(a) = a^((2 * p - 1) / 3) when p ≡ 2 (mod 3)
 // Returns nullopt if n is not a cubic residue (when p ≡ 1 mod 3)
 export template<typename T, T... Modulus>
 constexpr auto cbrt(ZqElement<T, Modulus...> n) -> std::optional<ZqElement<T, Modulus...>>
 {
-  constexpr std::size_t N = sizeof...(Modulus);
-  constexpr auto p = big_int<N, T>{Modulus...};
-  constexpr auto one = big_int<N, T>{1};
-  constexpr auto two = big_int<N, T>{2};
-  constexpr auto three = big_int<N, T>{3};
-  constexpr auto p_minus_1 = subtract_ignore_carry(p, one);
+  using traits = detail::cbrt_traits<T, Modulus...>;
+  using field = ZqElement<T, Modulus...>;
+  constexpr auto power = [](field x, const auto& e) {
+    return field{mod_exp(x.data, e, std::integer_sequence<T, Modulus...>{}), skip_reduction{}};
+  };
+  const field one{1};
 
   // Handle zero
-  if (n.data == big_int<N, T>{})
-    return ZqElement<T, Modulus...>{};
-
-  // Check primality
-  if (!detail::is_prime(std::integer_sequence<T, Modulus...>{}))
+  if (n.data == big_int<sizeof...(Modulus), T>{})
+    return field{};
+  if constexpr (!traits::prime)
     return std::nullopt;
-
-  // For prime p, gcd(3, p - 1) is either 1 (p ≡ 2 mod 3) or 3 (p ≡ 1 mod 3)
-  constexpr auto p_mod_3 = p[0] % 3;
-
-  if constexpr (p_mod_3 == 2)
-  { // p ≡ 2 (mod 3): every element is a cubic residue, unique cube root
-    // cbrt(n) = n^((2 * (p - 1)) / 3)
-    constexpr auto exp = div(subtract_ignore_carry(add_ignore_carry(p, p), one), three).quotient;
-    auto result = mod_exp(n.data, exp, std::integer_sequence<T, Modulus...>{});
-    return ZqElement<T, Modulus...>{result};
+  else if constexpr (traits::p_mod_3 != 1)
+  { // p ≡ 2 (mod 3) (or p = 3): every element is a cubic residue, unique cube root
+    if constexpr (traits::p_mod_3 == 0)
+      return n; // x^3 = x in GF(3)
+    else
+      return power(n, traits::unique_exp);
   }
   else
-  {
-    // Case p ≡ 1 (mod 3)
-    // Use Adleman-Manders-Miller algorithm
-
-    // Check if n is a cubic residue
-    constexpr auto residue_exp = div(p_minus_1, three).quotient;
-    if (mod_exp(n.data, residue_exp, std::integer_sequence<T, Modulus...>{}) != one)
-    {
-      return std::nullopt;
-    }
-
-    // 1. Factor p-1 = 3^S * t where 3 does not divide t
-    constexpr auto Qt = detail::factor_out_val(p_minus_1, static_cast<T>(3));
-    constexpr auto t = Qt.first;
-    constexpr std::size_t S = Qt.second;
-
-    // 2. Compute k = 1/3 mod t
-    // Since gcd(3, t) = 1, the inverse exists.
-    // Use manual inversion logic for constant divisor 3 to ensure correctness.
-    // Solve 3k = 1 + qt for integer q (where 1+qt is divisible by 3).
-
-    auto t_rem_3 = div(t, three).remainder;
-    auto k = t; // Placeholder
-    if (t_rem_3 == big_int<sizeof...(Modulus), T>{1})
-    {
-      auto two_t_full = mul(two, t);
-      // Truncate to N limbs (we know it fits since 1+2t < p)
-      constexpr auto N_limbs = sizeof...(Modulus);
-      big_int<N_limbs, T> two_t;
-      for (std::size_t i = 0; i < N_limbs; ++i)
-        two_t[i] = two_t_full[i];
-
-      auto num = add_ignore_carry(one, two_t);
-      k = div(num, three).quotient;
-    }
-    else
-    {
-      // remainder must be 2
-      auto num = add_ignore_carry(one, t); // 1 + t < p. SAFE.
-      k = div(num, three).quotient;
-    }
-    // 3. Find a cubic non-residue z such that z^((p-1)/3) != 1
-    // We can use a deterministic search 2, 3, ...
-    auto z = two;
-    while (true)
-    {
-      if (mod_exp(z, residue_exp, std::integer_sequence<T, Modulus...>{}) != one)
-        break;
-      z = add_ignore_carry(z, one);
-    }
-
-    // 4. Setup parameters
-    auto c = mod_exp(z, t, std::integer_sequence<T, Modulus...>{});
-    auto r = mod_exp(n.data, k, std::integer_sequence<T, Modulus...>{});
-    auto n_inv = mod_inv(n.data, p);
-
-    auto h = r;
-    auto h_cubed = mod_exp(h, three, std::integer_sequence<T, Modulus...>{});
-    auto prod = mul(n_inv, h_cubed);
-    auto b = mod(prod, std::integer_sequence<T, Modulus...>());
-
-    // 5. AMM Correction Loop
-    // Initialize variables:
-    // x: Current root approximation (n^k)
-    // g: Current generator power (starts as c = z^t)
-    // r_val: Current order exponent (starts as S)
-    // b_term: Current error term (initially b)
-
-    auto x = r;
-    auto g = c;
-    auto r_val = S;
-    auto b_term = b;
-    // Loop to reduce the error term b to 1
-    std::size_t safety_counter = 0;
-    while (b_term != one)
-    {
-      if (++safety_counter > S + 10) // Should converge within S steps
-        return std::nullopt;
-
-      // Find m such that b^(3^m) = 1
-      auto temp = b_term;
+  { // Case p ≡ 1 (mod 3): Adleman-Manders-Miller. A non-residue shows in the
+    // first step: b^(3^(S - 1)) = n^(m (p - 1) / 3) != 1, so m reaches r
+    // x = n^k, and the error term b = x^3 / n = w^3 n^2 for w = n^(k - 1)
+    const auto w = power(n, traits::k_minus_1);
+    auto x = w * n;
+    auto b = w * w * w * n * n;
+
+    // the order of b, 3^r, drops at every step
+    std::size_t r = traits::S;
+    while (b != one)
+    { // Find the least m such that b^(3^m) = 1, and y = b^(3^(m - 1))
       std::size_t m = 0;
-      for (; m < r_val; ++m)
+      auto y = b;
+      for (auto c = b; c != one; c = c * c * c)
       {
-        if (temp == one)
-          break;
-        temp = mod_exp(temp, three, std::integer_sequence<T, Modulus...>{});
+        y = c;
+        if (++m == r)
+          return std::nullopt;
       }
-
-      // If m == r_val, no solution (should not happen for valid residues)
-      if (m == r_val)
-        return std::nullopt;
-
-      // Update g = g^(3^(r-m-1))
-      auto g2 = g;
-      for (std::size_t j = 0; j < r_val - m - 1; ++j)
-        g2 = mod_exp(g2, three, std::integer_sequence<T, Modulus...>{});
-
-      g = g2; // New g
-
-      // x = x * g
-      // b = b * g^3
-      x = mod(mul(x, g), std::integer_sequence<T, Modulus...>());
-      g = mod_exp(g, three, std::integer_sequence<T, Modulus...>{});
-      b_term = mod(mul(b_term, g), std::integer_sequence<T, Modulus...>());
-      r_val = m;
+      // c = g^(3^(S - m)) has c^(3^(m - 1)) = ω = g_powers[S - 1], and y is ω or ω^2:
+      // b c^2 (if y = ω) or b c (if y = ω^2) has an order below 3^m
+      auto c = traits::g_powers[traits::S - m];
+      auto d = traits::g_powers[traits::S - m - 1]; // d^3 = c, so x is corrected by d likewise
+      if (y == traits::g_powers[traits::S - 1])
+      {
+        c *= c;
+        d *= d;
+      }
+      x *= d;
+      b *= c;
+      r = m;
     }
-
-    return ZqElement<T, Modulus...>{x};
+    return x;
   }
 }
 
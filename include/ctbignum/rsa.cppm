@@ -0,0 +1,145 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:rsa;
+
+import std;
+
+import :bigint;
+import :slicing;
+import :addition;
+import :mult;
+import :division;
+import :relational;
+import :mod_inv;
+import :montgomery;
+import :mod_exp;
+import :thread_pool;
+
+namespace lam::cbn
+{
+
+// An RSA private key n = p q for primes p, q of N / 2 limbs each, holding the
+// CRT parameters dp = d mod (p - 1), dq = d mod (q - 1), qinv = q^-1 mod p
+// and a Montgomery context per prime.
+//
+// The private-key operation x^d mod n (signing, decryption) runs two
+// exponentiations of half the size, x^dp mod p and x^dq mod q, and
+// recombines them by Garner's formula
+//   x^d = m_q + q ((m_p - m_q) qinv mod p).
+// The halves are independent and may run on two threads of a thread_pool.
+//
+// With ConstantTime (the default), the exponentiations, reductions and the
+// recombination perform the same operations for every x and key of the
+// given size (see mod_exp_ct).
+export template<std::size_t N, typename T = std::uint64_t, bool ConstantTime = true>
+class rsa_private_key
+{
+  static_assert(N % 2 == 0, "the modulus must have an even number of limbs");
+  static constexpr std::size_t H = N / 2;
+
+public:
+  using half_type = big_int<H, T>;
+
+  // from the PKCS #1 parameters; p and q must be odd primes
+  constexpr rsa_private_key(half_type p, half_type q, half_type dp, half_type dq, half_type qinv)
+    : n_(cbn::mul(p, q)), q_(q), dp_(dp), dq_(dq), qinv_(qinv),
+      ctx_{montgomery_context<H, T>{p}, montgomery_context<H, T>{q}}
+  {
+    for (std::size_t i = 0; i < 2; ++i) // R^3, mapping x R^-1 to x R
+      r3_[i] = ctx_[i].mul(ctx_[i].r2, ctx_[i].r2);
+  }
+
+  // from the primes and the private exponent d
+  constexpr rsa_private_key(half_type p, half_type q, big_int<N, T> d)
+    : rsa_private_key(p, q, reduce_exponent(d, p), reduce_exponent(d, q), inverse(q, p))
+  {}
+
+  constexpr const big_int<N, T>& modulus() const { return n_; }
+
+  // x^d mod n for x < n; throws std::runtime_error otherwise
+  constexpr big_int<N, T> apply(big_int<N, T> x) const
+  {
+    check_range(x);
+    return combine(half_power(x, 0), half_power(x, 1));
+  }
+
+  // the same with the two halves on two threads of pool
+  big_int<N, T> apply(big_int<N, T> x, thread_pool& pool) const
+  {
+    check_range(x);
+    std::array<half_type, 2> halves;
+    pool.parallel_for(2, [&](std::size_t i) { halves[i] = half_power(x, i); });
+    return combine(halves[0], halves[1]);
+  }
+
+private:
+  static constexpr half_type reduce_exponent(big_int<N, T> d, half_type prime)
+  {
+    auto prime_minus_one = prime;
+    prime_minus_one[0] -= 1; // prime is odd
+    return detail::first<H>(div(d, prime_minus_one).remainder);
+  }
+
+  static constexpr half_type inverse(half_type q, half_type p)
+  { return mod_inv(detail::first<H>(div(q, p).remainder), p); }
+
+  constexpr void check_range(const big_int<N, T>& x) const
+  {
+    if (!(x < n_))
+      throw std::runtime_error("rsa_private_key: the input must be below the modulus");
+  }
+
+  constexpr half_type mont_mul(const montgomery_context<H, T>& ctx, half_type a, half_type b) const
+  {
+    if constexpr (ConstantTime)
+      return ctx.mul_ct(a, b);
+    else
+      return ctx.mul(a, b);
+  }
+
+  // x R mod p for x < p R, R = beta^(N / 2): x R^-1 by Montgomery reduction, times R^3
+  constexpr half_type to_montgomery(std::size_t i, big_int<N, T> x) const
+  {
+    const auto& ctx = ctx_[i];
+    half_type reduced;
+    if constexpr (ConstantTime)
+      reduced = montgomery_reduction_ct(x, ctx.modulus, ctx.mprime);
+    else
+      reduced = montgomery_reduction(x, ctx.modulus, ctx.mprime);
+    return mont_mul(ctx, reduced, r3_[i]);
+  }
+
+  // x^dp mod p (i = 0) or x^dq mod q (i = 1), in Montgomery form
+  constexpr half_type half_power(const big_int<N, T>& x, std::size_t i) const
+  { return detail::mod_exp_window<ConstantTime>(to_montgomery(i, x), i == 0 ? dp_ : dq_, ctx_[i]); }
+
+  constexpr big_int<N, T> combine(half_type mp, half_type mq) const
+  {
+    const auto& ctx = ctx_[0];
+    mq = mont_mul(ctx_[1], mq, half_type{1});
+    const auto mq_mod_p = to_montgomery(0, detail::to_length<N>(mq)); // m_q may exceed p
+
+    // (m_p - m_q) mod p in Montgomery form, times qinv: the plain h < p
+    const auto difference = subtract(mp, mq_mod_p); // the top limb is all ones on a borrow
+    const auto wrapped = add_ignore_carry(detail::first<H>(difference), ctx.modulus);
+    const auto h = mont_mul(ctx, detail::select_ct(difference[H], detail::first<H>(difference), wrapped), qinv_);
+
+    return detail::first<N>(add(cbn::mul(q_, h), mq));
+  }
+
+  big_int<N, T> n_;
+  half_type q_, dp_, dq_, qinv_;
+  std::array<montgomery_context<H, T>, 2> ctx_;
+  std::array<half_type, 2> r3_{};
+};
+
+} // namespace lam::cbn
@@ -0,0 +1,302 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+module;
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+export module lam.ctbignum:simd_field;
+
+import std;
+
+import :bigint;
+import :field;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// Moduli with a packed AVX2 kernel: the Goldilocks prime 2^64 - 2^32 + 1 in
+// four 64-bit lanes, and odd moduli below 2^31 (Mersenne-31, BabyBear, ...)
+// in eight 32-bit lanes.
+template<typename T, T Modulus>
+constexpr bool simd_goldilocks = std::numeric_limits<T>::digits == 64 && Modulus == static_cast<T>(0xFFFF'FFFF'0000'0001);
+
+template<typename T, T Modulus>
+constexpr bool simd_word31 = std::numeric_limits<T>::digits == 32 && Modulus % 2 == 1 && Modulus < (T{1} << 31);
+
+template<typename T, T Modulus>
+constexpr bool simd_field = simd_goldilocks<T, Modulus> || simd_word31<T, Modulus>;
+
+#if defined(__AVX2__)
+
+// unsigned 64-bit comparison a < b, lane-wise
+inline __m256i cmplt_epu64(__m256i a, __m256i b)
+{
+  const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<std::int64_t>::min());
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign), _mm256_xor_si256(a, sign));
+}
+
+// Goldilocks: r < 2^64 -> r mod p, for one subtraction of p
+inline __m256i goldilocks_canonical(__m256i r)
+{
+  const __m256i p = _mm256_set1_epi64x(static_cast<std::int64_t>(0xFFFF'FFFF'0000'0001));
+  return _mm256_sub_epi64(r, _mm256_andnot_si256(cmplt_epu64(r, p), p));
+}
+
+inline __m256i goldilocks_add(__m256i a, __m256i b)
+{
+  const __m256i epsilon = _mm256_set1_epi64x(0xFFFF'FFFF);
+  const __m256i s = _mm256_add_epi64(a, b);
+  // a + b wrapped around 2^64 = 2^32 - 1 mod p; no second wrap for a, b < p
+  return goldilocks_canonical(_mm256_add_epi64(s, _mm256_and_si256(cmplt_epu64(s, a), epsilon)));
+}
+
+// lane-wise a * b mod p, see word_field::reduce for the reduction
+inline __m256i goldilocks_mul(__m256i a, __m256i b)
+{
+  const __m256i epsilon = _mm256_set1_epi64x(0xFFFF'FFFF);
+
+  // 64 x 64 -> 128-bit products from four 32 x 32-bit ones, without carries
+  const __m256i a_hi = _mm256_srli_epi64(a, 32), b_hi = _mm256_srli_epi64(b, 32);
+  const __m256i ll = _mm256_mul_epu32(a, b);
+  const __m256i lh = _mm256_mul_epu32(a, b_hi);
+  const __m256i hl = _mm256_mul_epu32(a_hi, b);
+  const __m256i hh = _mm256_mul_epu32(a_hi, b_hi);
+  const __m256i t = _mm256_add_epi64(hl, _mm256_srli_epi64(ll, 32));
+  const __m256i w = _mm256_add_epi64(_mm256_and_si256(t, epsilon), lh);
+  const __m256i x0 = _mm256_or_si256(_mm256_slli_epi64(w, 32), _mm256_and_si256(ll, epsilon));
+  const __m256i x_hi = _mm256_add_epi64(_mm256_add_epi64(hh, _mm256_srli_epi64(t, 32)), _mm256_srli_epi64(w, 32));
+
+  const __m256i x1 = _mm256_and_si256(x_hi, epsilon), x2 = _mm256_srli_epi64(x_hi, 32);
+  __m256i r = _mm256_sub_epi64(x0, x2);
+  r = _mm256_sub_epi64(r, _mm256_and_si256(cmplt_epu64(x0, x2), epsilon));
+  const __m256i u = _mm256_sub_epi64(_mm256_slli_epi64(x1, 32), x1); // x1 (2^32 - 1)
+  r = _mm256_add_epi64(r, u);
+  r = _mm256_add_epi64(r, _mm256_and_si256(cmplt_epu64(r, u), epsilon));
+  return goldilocks_canonical(r);
+}
+
+// odd p < 2^31 in 32-bit lanes: r < 2p -> r mod p
+template<std::uint32_t Modulus>
+inline __m256i word31_canonical(__m256i r)
+{ return _mm256_min_epu32(r, _mm256_sub_epi32(r, _mm256_set1_epi32(static_cast<int>(Modulus)))); }
+
+template<std::uint32_t Modulus>
+inline __m256i word31_add(__m256i a, __m256i b)
+{ return word31_canonical<Modulus>(_mm256_add_epi32(a, b)); }
+
+// Montgomery reduction of the 64-bit lanes x < p * 2^32 (even 32-bit lanes
+// of the product), result x / 2^32 mod p in [0, 2p) in the odd 32-bit lanes
+template<std::uint32_t Modulus>
+inline __m256i word31_montgomery(__m256i x)
+{
+  constexpr std::uint32_t neg_inv = [] {
+    std::uint32_t inv = Modulus;
+    for (int i = 0; i < 5; ++i)
+      inv *= 2 - Modulus * inv;
+    return 0 - inv;
+  }();
+  const __m256i q = _mm256_mul_epu32(x, _mm256_set1_epi32(static_cast<int>(neg_inv)));
+  return _mm256_add_epi64(x, _mm256_mul_epu32(q, _mm256_set1_epi32(static_cast<int>(Modulus))));
+}
+
+template<std::uint32_t Modulus>
+inline __m256i word31_mul(__m256i a, __m256i b)
+{
+  const __m256i a_odd = _mm256_srli_epi64(a, 32), b_odd = _mm256_srli_epi64(b, 32);
+  const __m256i x_even = _mm256_mul_epu32(a, b), x_odd = _mm256_mul_epu32(a_odd, b_odd);
+
+  if constexpr (Modulus == 0x7FFF'FFFF)
+  { // 2^31 = 1 mod p: x = (x mod 2^31) + (x >> 31) < 2p for x < p^2
+    const __m256i p = _mm256_set1_epi64x(Modulus);
+    const __m256i r_even = _mm256_add_epi64(_mm256_and_si256(x_even, p), _mm256_srli_epi64(x_even, 31));
+    const __m256i r_odd = _mm256_add_epi64(_mm256_and_si256(x_odd, p), _mm256_srli_epi64(x_odd, 31));
+    return word31_canonical<Modulus>(_mm256_blend_epi32(r_even, _mm256_slli_epi64(r_odd, 32), 0xAA));
+  }
+  else
+  { // a b / 2^32, then times 2^64 mod p and / 2^32 again
+    constexpr std::uint64_t r = (std::uint64_t{1} << 32) % Modulus;
+    constexpr std::uint32_t r2 = static_cast<std::uint32_t>(r * r % Modulus); // 2^64 mod p
+    const __m256i vr2 = _mm256_set1_epi32(static_cast<int>(r2));
+    const __m256i m_even = _mm256_srli_epi64(word31_montgomery<Modulus>(x_even), 32);
+    const __m256i m_odd = _mm256_srli_epi64(word31_montgomery<Modulus>(x_odd), 32);
+    const __m256i y_even = word31_montgomery<Modulus>(_mm256_mul_epu32(m_even, vr2));
+    const __m256i y_odd = word31_montgomery<Modulus>(_mm256_mul_epu32(m_odd, vr2));
+    return word31_canonical<Modulus>(_mm256_blend_epi32(_mm256_srli_epi64(y_even, 32), y_odd, 0xAA));
+  }
+}
+
+template<typename T, T Modulus>
+inline __m256i simd_add(__m256i a, __m256i b)
+{
+  if constexpr (simd_goldilocks<T, Modulus>)
+    return goldilocks_add(a, b);
+  else
+    return word31_add<Modulus>(a, b);
+}
+
+template<typename T, T Modulus>
+inline __m256i simd_mul(__m256i a, __m256i b)
+{
+  if constexpr (simd_goldilocks<T, Modulus>)
+    return goldilocks_mul(a, b);
+  else
+    return word31_mul<Modulus>(a, b);
+}
+
+template<typename T>
+inline __m256i simd_load(const T* p)
+{ return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+
+template<typename T>
+inline void simd_store(T* p, __m256i x)
+{ _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+
+#endif
+
+// out[i] = a[i] * b[i] for the moduli of simd_field
+template<typename T, T Modulus>
+void simd_mulmod(std::span<ZqElement<T, Modulus>> out, std::span<const ZqElement<T, Modulus>> a,
+                 std::span<const ZqElement<T, Modulus>> b)
+{
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  constexpr std::size_t lanes = 32 / sizeof(T);
+  auto pa = reinterpret_cast<const T*>(a.data());
+  auto pb = reinterpret_cast<const T*>(b.data());
+  auto pr = reinterpret_cast<T*>(out.data());
+  for (; i + lanes <= out.size(); i += lanes)
+    simd_store(pr + i, simd_mul<T, Modulus>(simd_load(pa + i), simd_load(pb + i)));
+#endif
+  for (; i < out.size(); ++i)
+    out[i] = a[i] * b[i];
+}
+
+} // namespace detail
+
+// Element-wise modular addition out[i] = a[i] + b[i] over spans of
+// single-limb ZqElements. Packed with AVX2 for the Goldilocks prime (four
+// 64-bit lanes) and for odd moduli below 2^31 with 32-bit limbs (eight lanes).
+// a and b must hold at least out.size() elements; out may alias a or b.
+export template<typename T, T Modulus>
+void addmod(std::span<ZqElement<T, Modulus>> out, std::span<const std::type_identity_t<ZqElement<T, Modulus>>> a,
+            std::span<const std::type_identity_t<ZqElement<T, Modulus>>> b)
+{
+  static_assert(sizeof(ZqElement<T, Modulus>) == sizeof(T));
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  if constexpr (detail::simd_field<T, Modulus>)
+  {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    auto pa = reinterpret_cast<const T*>(a.data());
+    auto pb = reinterpret_cast<const T*>(b.data());
+    auto pr = reinterpret_cast<T*>(out.data());
+    for (; i + lanes <= out.size(); i += lanes)
+      detail::simd_store(pr + i, detail::simd_add<T, Modulus>(detail::simd_load(pa + i), detail::simd_load(pb + i)));
+  }
+#endif
+  for (; i < out.size(); ++i)
+    out[i] = a[i] + b[i];
+}
+
+// out[i] = 1 / a[i] for nonzero a[i], by Montgomery's trick: one modular
+// inversion and three multiplications per element. With a packed kernel
+// (see addmod), each lane accumulates the prefix products of its own stride
+// of elements, so that the running products are vector multiplications.
+// Throws std::runtime_error if an element is zero; out may alias a.
+export template<typename T, T Modulus>
+void batch_inverse(std::span<ZqElement<T, Modulus>> out, std::span<const std::type_identity_t<ZqElement<T, Modulus>>> a)
+{
+  using element_type = ZqElement<T, Modulus>;
+  static_assert(sizeof(element_type) == sizeof(T));
+  const std::size_t n = out.size();
+  std::vector<element_type> prefix(n);
+
+  std::size_t head = 0; // elements [0, head) are handled by the packed lanes
+#if defined(__AVX2__)
+  if constexpr (detail::simd_field<T, Modulus>)
+  {
+    constexpr std::size_t lanes = 32 / sizeof(T);
+    head = n / lanes * lanes;
+    if (head != 0)
+    {
+      auto pa = reinterpret_cast<const T*>(a.data());
+      auto pp = reinterpret_cast<T*>(prefix.data());
+      auto pr = reinterpret_cast<T*>(out.data());
+
+      // prefix[i] = product of a[j] for j < i, j = i mod lanes
+      std::array<element_type, lanes> ones;
+      ones.fill(element_type{1});
+      __m256i acc = detail::simd_load(reinterpret_cast<const T*>(ones.data()));
+      for (std::size_t i = 0; i < head; i += lanes)
+      {
+        detail::simd_store(pp + i, acc);
+        acc = detail::simd_mul<T, Modulus>(acc, detail::simd_load(pa + i));
+      }
+
+      // invert the lane totals together
+      std::array<element_type, lanes> totals;
+      detail::simd_store(reinterpret_cast<T*>(totals.data()), acc);
+      std::array<element_type, lanes> partial;
+      element_type all{1};
+      for (std::size_t j = 0; j < lanes; ++j)
+      {
+        partial[j] = all;
+        all *= totals[j];
+      }
+      if (all == element_type{})
+        throw std::runtime_error("batch_inverse: element is not invertible");
+      all = element_type{1} / all;
+      for (std::size_t j = lanes; j-- > 0;)
+      {
+        const auto inverse = all * partial[j];
+        all *= totals[j];
+        totals[j] = inverse;
+      }
+
+      // walking back: out[i] = prefix[i] / (prefix[i] a[i]), then drop a[i] from the running inverse
+      acc = detail::simd_load(reinterpret_cast<const T*>(totals.data()));
+      for (std::size_t i = head; i != 0;)
+      {
+        i -= lanes;
+        const __m256i x = detail::simd_load(pa + i);
+        detail::simd_store(pr + i, detail::simd_mul<T, Modulus>(acc, detail::simd_load(pp + i)));
+        acc = detail::simd_mul<T, Modulus>(acc, x);
+      }
+    }
+  }
+#endif
+
+  if (head == n)
+    return;
+
+  element_type running{1};
+  for (std::size_t i = head; i < n; ++i)
+  {
+    prefix[i] = running;
+    running *= a[i];
+  }
+  if (running == element_type{})
+    throw std::runtime_error("batch_inverse: element is not invertible");
+  running = element_type{1} / running;
+  for (std::size_t i = n; i-- > head;)
+  {
+    const auto inverse = running * prefix[i];
+    running *= a[i];
+    out[i] = inverse;
+  }
+}
+
+} // namespace lam::cbn
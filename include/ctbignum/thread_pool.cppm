@@ -0,0 +1,144 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:thread_pool;
+
+import std;
+
+namespace lam::cbn
+{
+
+// Fixed set of std::thread workers for data-parallel loops.
+//
+// parallel_for(count, f) calls f(i) for every i in [0, count), spread over the
+// workers and the calling thread, and returns when all calls have finished.
+// The first exception thrown by f is rethrown in the caller (calls for indices
+// not yet started may or may not take place). A pool serves one
+// parallel_for at a time; calls from several threads must be serialized.
+export class thread_pool
+{
+public:
+  // a pool of `threads` threads in total, the caller of parallel_for included
+  explicit thread_pool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+  {
+    for (std::size_t i = 1; i < threads; ++i)
+      workers.emplace_back([this] { work(); });
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool()
+  {
+    {
+      std::lock_guard lock(mutex);
+      stop = true;
+    }
+    wake.notify_all();
+    for (auto& t : workers)
+      t.join();
+  }
+
+  std::size_t size() const { return workers.size() + 1; }
+
+  template<typename F>
+  void parallel_for(std::size_t count, F&& f)
+  {
+    if (workers.empty() || count <= 1)
+    {
+      for (std::size_t i = 0; i < count; ++i)
+        f(i);
+      return;
+    }
+
+    {
+      std::unique_lock lock(mutex);
+      done.wait(lock, [this] { return active == 0; }); // stragglers of the previous loop
+      job = std::ref(f);
+      job_count = count;
+      next.store(0, std::memory_order_relaxed);
+      remaining = count;
+      error = nullptr;
+      ++generation;
+    }
+    wake.notify_all();
+
+    run();
+
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return remaining == 0; });
+    job = nullptr;
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+private:
+  void run()
+  {
+    std::size_t finished = 0;
+    for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < job_count; ++finished)
+    {
+      try
+      {
+        job(i);
+      }
+      catch (...)
+      {
+        std::lock_guard lock(mutex);
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+
+    if (finished != 0)
+    {
+      std::lock_guard lock(mutex);
+      remaining -= finished;
+      if (remaining == 0)
+        done.notify_all();
+    }
+  }
+
+  void work()
+  {
+    std::uint64_t seen = 0;
+    std::unique_lock lock(mutex);
+    while (true)
+    {
+      wake.wait(lock, [&] { return stop || generation != seen; });
+      if (stop)
+        return;
+      seen = generation;
+      ++active;
+      lock.unlock();
+      run();
+      lock.lock();
+      if (--active == 0)
+        done.notify_all();
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  std::function<void(std::size_t)> job;
+  std::size_t job_count = 0;
+  std::atomic<std::size_t> next{0};
+  std::size_t remaining = 0;
+  std::size_t active = 0;
+  std::uint64_t generation = 0;
+  std::exception_ptr error;
+  bool stop = false;
+};
+
+} // namespace lam::cbn
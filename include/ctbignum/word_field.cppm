@@ -0,0 +1,151 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+
+export module lam.ctbignum:word_field;
+
+import std;
+
+import :bigint;
+import :type_traits;
+import :reciprocal;
+import :mult;
+import :bitshift;
+
+namespace lam::cbn
+{
+namespace detail
+{
+
+// Dedicated arithmetic for moduli of one or two limbs, used by ZqElement in
+// place of the generic mul + mod when the double-width type of T exists
+// (unsigned __int128 for 64-bit limbs).
+//
+// Products are reduced by a Moller-Granlund division with a reciprocal of the
+// (normalized) modulus that is precomputed at compile time, i.e., by two
+// multiplications instead of a hardware divide. Two single-limb moduli of
+// special form are recognized and reduced with shifts and additions only:
+// the Goldilocks prime 2^64 - 2^32 + 1 and the Mersenne prime 2^31 - 1.
+// Other 31-bit primes used by proof systems (such as BabyBear, 15 * 2^27 + 1)
+// have no such form and keep the reciprocal.
+export template<typename T, T... Modulus>
+struct word_field
+{
+  static constexpr bool enabled = false;
+};
+
+// single-limb modulus p
+template<typename T, T Modulus>
+  requires(!std::is_void_v<typename dbl_bitlen<T>::type> && Modulus != 0)
+struct word_field<T, Modulus>
+{
+  using TT = typename dbl_bitlen<T>::type;
+
+  static constexpr bool enabled = true;
+  static constexpr auto digits = std::numeric_limits<T>::digits;
+  static constexpr int shift = std::countl_zero(Modulus);
+  static constexpr T d = static_cast<T>(Modulus << shift);
+  static constexpr T v = reciprocal_word(d);
+
+  static constexpr bool goldilocks = digits == 64 && Modulus == static_cast<T>(0xFFFF'FFFF'0000'0001);
+  static constexpr bool mersenne31 = Modulus == 0x7FFF'FFFF;
+
+  // x mod p, for x < p * beta
+  static constexpr T reduce(TT x)
+  {
+    if constexpr (goldilocks)
+    { // with x = x0 + 2^64 x1 + 2^96 x2: 2^64 = 2^32 - 1 and 2^96 = -1 mod p
+      constexpr T epsilon = 0xFFFF'FFFF;
+      const T x0 = static_cast<T>(x), x1 = static_cast<T>(x >> 64) & epsilon, x2 = static_cast<T>(x >> 96);
+      T t = x0 - x2;
+      if (x0 < x2) // the borrow took 2^64 = 2^32 - 1 too many
+        t -= epsilon;
+      const T u = x1 * epsilon;
+      T r = t + u;
+      if (r < u) // wrapped around 2^64
+        r += epsilon;
+      return (r >= Modulus) ? r - Modulus : r;
+    }
+    else if constexpr (mersenne31)
+    { // 2^31 = 1 mod p: fold the high bits onto the low ones
+      x = (x & Modulus) + (x >> 31);
+      x = (x & Modulus) + (x >> 31);
+      if constexpr (digits > 32) // x < p * 2^64 needs a third fold
+        x = (x & Modulus) + (x >> 31);
+      return static_cast<T>(x >= Modulus ? x - Modulus : x);
+    }
+    else if constexpr (std::numeric_limits<TT>::digits <= 64)
+      return static_cast<T>(x % Modulus); // compilers already divide by the constant through a multiplication
+    else
+    {
+      TT xs = x << shift;
+      return static_cast<T>(udiv_2by1(static_cast<T>(xs >> digits), static_cast<T>(xs), d, v).second >> shift);
+    }
+  }
+
+  // a * b mod p, for a < p (b need not be reduced)
+  static constexpr big_int<1, T> mul(big_int<1, T> a, big_int<1, T> b)
+  { return big_int<1, T>{reduce(static_cast<TT>(a[0]) * b[0])}; }
+
+  // Shoup's precomputation w' = floor(w * beta / p) for a fixed operand w < p
+  static constexpr T shoup_precompute(T w)
+  { return udiv_2by1(static_cast<T>(w << shift), T{0}, d, v).first; }
+
+  // a * w mod p, up to one multiple of p (the result lies in [0, 2p)),
+  // for any a < beta, given w' = shoup_precompute(w)
+  static constexpr T shoup_mul_lazy(T a, T w, T w_prime)
+  {
+    T q = static_cast<T>((static_cast<TT>(a) * w_prime) >> digits);
+    if constexpr (Modulus < (T{1} << (digits - 1)))
+      return static_cast<T>(a * w - q * Modulus);
+    else
+    { // 2p does not fit in a word: correct once in double width
+      TT r = static_cast<TT>(a) * w - static_cast<TT>(q) * Modulus;
+      return static_cast<T>(r >= Modulus ? r - Modulus : r);
+    }
+  }
+
+  // a * w mod p, for any a < beta, given w' = shoup_precompute(w)
+  static constexpr T shoup_mul(T a, T w, T w_prime)
+  {
+    T r = shoup_mul_lazy(a, w, w_prime);
+    return static_cast<T>(r >= Modulus ? r - Modulus : r);
+  }
+};
+
+// two-limb modulus p = <M1, M0>, the top limb non-zero
+template<typename T, T M0, T M1>
+  requires(!std::is_void_v<typename dbl_bitlen<T>::type> && M1 != 0)
+struct word_field<T, M0, M1>
+{
+  using TT = typename dbl_bitlen<T>::type;
+
+  static constexpr bool enabled = true;
+  static constexpr auto digits = std::numeric_limits<T>::digits;
+  static constexpr int shift = std::countl_zero(M1);
+  static constexpr TT d = ((static_cast<TT>(M1) << digits) | M0) << shift;
+  static constexpr T d1 = static_cast<T>(d >> digits);
+  static constexpr T d0 = static_cast<T>(d);
+  static constexpr T v = reciprocal_3by2(d1, d0);
+
+  // a * b mod p, for a < p (b need not be reduced)
+  static constexpr big_int<2, T> mul(big_int<2, T> a, big_int<2, T> b)
+  {
+    // a * b * 2^shift < d * beta^2, so it fits in four limbs and the quotient
+    // of its top three limbs by d is a single limb
+    auto u = shift_left(cbn::mul(a, b), shift);
+    TT r = udiv_3by2(u[3], u[2], u[1], d1, d0, v).second;
+    TT r0 = udiv_3by2(static_cast<T>(r >> digits), static_cast<T>(r), u[0], d1, d0, v).second >> shift;
+    return big_int<2, T>{static_cast<T>(r0), static_cast<T>(r0 >> digits)};
+  }
+};
+
+} // namespace detail
+} // namespace lam::cbn
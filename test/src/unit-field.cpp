@@ -133,3 +133,171 @@ TEST_CASE("Finite Field class - output to stream")
 
   REQUIRE(ss.str() == "4387682521574012837928367540");
 }
+
+namespace
+{
+// compare ZqElement multiplication against the generic mul + mod reduction
+template<typename GF, typename T, T... M>
+void check_field_mul(std::integer_sequence<T, M...> modulus)
+{
+  using namespace lam::cbn;
+
+  std::mt19937_64 gen(sizeof...(M));
+  std::uniform_int_distribution<T> distribution(0);
+  auto p_minus_1 = -GF{1};
+  constexpr big_int<sizeof...(M), T> modulus_limbs{M...};
+
+  for (int i = 0; i < 1000; ++i)
+  {
+    big_int<sizeof...(M), T> x, y;
+    for (auto& limb : x)
+      limb = distribution(gen);
+    for (auto& limb : y)
+      limb = distribution(gen);
+    GF a{x};
+    GF b = (i == 0) ? p_minus_1 : GF{y};
+    if (i == 0)
+      a = p_minus_1;
+
+    REQUIRE((a * b).data == mod(mul(a.data, b.data), modulus));
+    if (b != GF{0} && (modulus_limbs[0] & 1)) // b is invertible for prime moduli
+      REQUIRE(((a * b) / b).data == a.data);
+  }
+}
+} // namespace
+
+TEST_CASE("Finite Field class - one- and two-limb moduli")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("single limb")
+  {
+    check_field_mul<decltype(Zq(18446744073709551557_Z))>(18446744073709551557_Z); // 2^64 - 59
+    check_field_mul<decltype(Zq(9223372036854775783_Z))>(9223372036854775783_Z);   // 2^63 - 25
+    check_field_mul<decltype(Zq(3329_Z32))>(3329_Z32);
+    check_field_mul<decltype(Zq(4294967291_Z32))>(4294967291_Z32);                 // 2^32 - 5
+  }
+
+  SECTION("two limbs")
+  {
+    check_field_mul<decltype(Zq(340282366920938463463374607431768211297_Z))>(
+      340282366920938463463374607431768211297_Z); // 2^128 - 159
+    check_field_mul<decltype(Zq(170141183460469231731687303715884105727_Z))>(
+      170141183460469231731687303715884105727_Z); // 2^127 - 1
+    check_field_mul<decltype(Zq(18446744073709551557_Z32))>(18446744073709551557_Z32);
+    check_field_mul<decltype(Zq(1267650600228229401496703205653_Z))>(1267650600228229401496703205653_Z);
+  }
+
+  SECTION("compile time")
+  {
+    using GF = decltype(Zq(340282366920938463463374607431768211297_Z));
+    constexpr GF x(283798123746283746283764872634871623487_Z);
+    constexpr GF y(98237498237498273948729834798237498234_Z);
+    static_assert((x * y).data == to_big_int(332377557213908712364300887677706503597_Z));
+    REQUIRE((x * y).data == to_big_int(332377557213908712364300887677706503597_Z));
+  }
+
+  SECTION("Shoup multiplication by a fixed operand")
+  {
+    auto check = []<typename T, T P>(std::integral_constant<T, P>) {
+      using backend = detail::word_field<T, P>;
+      std::mt19937_64 gen(P);
+      for (int i = 0; i < 1000; ++i)
+      {
+        T w = static_cast<T>(gen() % P);
+        T a = static_cast<T>(gen()); // need not be reduced
+        T w_prime = backend::shoup_precompute(w);
+        T expected = static_cast<T>(static_cast<unsigned __int128>(a) * w % P);
+        REQUIRE(backend::shoup_mul(a, w, w_prime) == expected);
+        REQUIRE(backend::shoup_mul_lazy(a, w, w_prime) < 2 * static_cast<unsigned __int128>(P));
+      }
+    };
+    check(std::integral_constant<std::uint64_t, 18446744073709551557ULL>{});
+    check(std::integral_constant<std::uint64_t, 2305843009213693951ULL>{});
+    check(std::integral_constant<std::uint32_t, 3329U>{});
+    check(std::integral_constant<std::uint32_t, 4294967291U>{});
+  }
+}
+
+TEST_CASE("Finite Field class - three or more limbs")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("odd moduli (Montgomery multiplication)")
+  {
+    check_field_mul<decltype(Zq(6277101735386680763835789423207666416102355444464034512659_Z))>(
+      6277101735386680763835789423207666416102355444464034512659_Z); // 2^192 - 237
+    check_field_mul<decltype(Zq(57896044618658097711785492504343953926634992332820282019728792003956564819949_Z))>(
+      57896044618658097711785492504343953926634992332820282019728792003956564819949_Z); // 2^255 - 19
+    check_field_mul<decltype(Zq(
+      52435875175126190479447740508185965837690552500527637822603658699938581184513_Z))>(
+      52435875175126190479447740508185965837690552500527637822603658699938581184513_Z); // BLS12-381 r
+  }
+
+  SECTION("even modulus (long division)")
+  {
+    check_field_mul<decltype(Zq(6277101735386680763835789423207666416102355444464034512896_Z))>(
+      6277101735386680763835789423207666416102355444464034512896_Z); // 2^192
+  }
+
+  SECTION("compile time")
+  {
+    using GF = decltype(Zq(57896044618658097711785492504343953926634992332820282019728792003956564819949_Z));
+    constexpr GF x(12345678901234567890123456789012345678901234567890_Z);
+    constexpr GF y(98765432109876543210987654321098765432109876543210_Z);
+    static_assert((x * y).data == to_big_int(
+      42308751316228357050463030342897363828253420198089844259636831865148915158042_Z));
+    REQUIRE((x * y) / y == x);
+  }
+}
+
+TEST_CASE("Finite Field class - precomputed multiplier")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  auto check = [](auto modulus) {
+    using GF = decltype(Zq(modulus));
+    using T = typename GF::value_type;
+    constexpr auto N = decltype(modulus)::size();
+
+    std::mt19937_64 gen(N);
+    std::uniform_int_distribution<T> distribution(0);
+    for (int i = 0; i < 200; ++i)
+    {
+      big_int<N, T> x, y;
+      for (auto& limb : x)
+        limb = distribution(gen);
+      for (auto& limb : y)
+        limb = distribution(gen);
+      GF w = (i == 0) ? -GF{1} : GF{x};
+      GF a = (i == 0) ? -GF{1} : GF{y};
+
+      precomputed_multiplier<GF> pw{w};
+      REQUIRE(pw.value() == w);
+      REQUIRE((a * pw) == a * w);
+      REQUIRE((pw * a) == a * w);
+      REQUIRE(GF{pw.mul(y)} == GF{y} * w); // the operand need not be reduced
+    }
+  };
+
+  check(3329_Z32);
+  check(18446744073709551557_Z);                  // 2^64 - 59
+  check(2305843009213693951_Z);                   // 2^61 - 1
+  check(170141183460469231731687303715884105727_Z); // 2^127 - 1
+  check(340282366920938463463374607431768211297_Z); // 2^128 - 159
+  check(57896044618658097711785492504343953926634992332820282019728792003956564819949_Z); // 2^255 - 19
+  check(115792089237316195423570985008687907853269984665640564039457584007908834671663_Z); // secp256k1 p
+
+  SECTION("compile time")
+  {
+    using GF = decltype(Zq(57896044618658097711785492504343953926634992332820282019728792003956564819949_Z));
+    constexpr GF w(9_Z);
+    constexpr precomputed_multiplier<GF> pw{w};
+    constexpr GF a(12345678901234567890123456789_Z);
+    static_assert(a * pw == a * w);
+    REQUIRE(a * pw == a * w);
+  }
+}
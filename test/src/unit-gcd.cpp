@@ -0,0 +1,159 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+// The runtime gcd, ext_gcd and mod_inv checked by their defining identities
+// (unit-modinv.cpp checks them against NTL, where it is available)
+
+namespace
+{
+// the two's complement x of N limbs, sign-extended to M limbs
+template<std::size_t M, std::size_t N, typename T>
+lam::cbn::big_int<M, T> sign_extend(const lam::cbn::big_int<N, T>& x)
+{
+  lam::cbn::big_int<M, T> r;
+  r.fill(static_cast<T>(-static_cast<T>(x[N - 1] >> (std::numeric_limits<T>::digits - 1))));
+  std::copy(x.begin(), x.end(), r.begin());
+  return r;
+}
+
+// the Euclidean algorithm by big_int remainders
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> euclid(lam::cbn::big_int<N, T> a, lam::cbn::big_int<N, T> b)
+{
+  while (!(b == lam::cbn::big_int<N, T>{}))
+    a = std::exchange(b, lam::cbn::detail::first<N>(a % b));
+  return a;
+}
+
+template<std::size_t N, typename T>
+void check_ext_gcd(const lam::cbn::big_int<N, T>& a, const lam::cbn::big_int<N, T>& b)
+{
+  using namespace lam::cbn;
+  const auto [g, x, y] = ext_gcd(a, b);
+  REQUIRE(g == euclid(a, b));
+  REQUIRE(gcd(a, b) == g);
+
+  // a x + b y = g exactly, as |a x|, |b y| <= a b / 2 fit in 2 N limbs
+  const auto ax = mul(detail::to_length<2 * N>(a), sign_extend<2 * N>(x));
+  const auto by = mul(detail::to_length<2 * N>(b), sign_extend<2 * N>(y));
+  REQUIRE(detail::first<2 * N>(add(detail::first<2 * N>(ax), detail::first<2 * N>(by))) ==
+          detail::to_length<2 * N>(g));
+}
+
+template<std::size_t N, typename T>
+void check_mod_inv(const lam::cbn::big_int<N, T>& x, const lam::cbn::big_int<N, T>& n)
+{
+  using namespace lam::cbn;
+  if (!(gcd(x, n) == big_int<N, T>{1}))
+  {
+    REQUIRE_THROWS_AS(mod_inv(x, n), std::runtime_error);
+    return;
+  }
+  const auto inverse = mod_inv(x, n);
+  REQUIRE(inverse < n);
+  REQUIRE(detail::first<N>(mul(x, inverse) % n) == big_int<N, T>{1}); // n > 1
+}
+} // namespace
+
+TEST_CASE("Runtime extended GCD by its identity")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(5);
+
+  SECTION("small operands, and zero operands")
+  {
+    for (std::uint64_t a = 0; a < 100; ++a)
+      for (std::uint64_t b = 0; b < 100; ++b)
+      {
+        check_ext_gcd(big_int<1>{a}, big_int<1>{b});
+        check_ext_gcd(big_int<2, std::uint32_t>{static_cast<std::uint32_t>(a)},
+                      big_int<2, std::uint32_t>{static_cast<std::uint32_t>(b)});
+      }
+
+    const big_int<3> a{gen(), gen(), gen()}, zero{};
+    const auto r = ext_gcd(a, zero);
+    REQUIRE((r.gcd == a && r.x == big_int<3>{1} && r.y == zero));
+    REQUIRE(ext_gcd(zero, a).gcd == a);
+    REQUIRE(ext_gcd(zero, zero).gcd == zero);
+    REQUIRE(gcd(zero, zero) == zero);
+  }
+
+  SECTION("random operands of any lengths")
+  {
+    for (int i = 0; i < 2000; ++i)
+    {
+      big_int<6> a{}, b{};
+      const auto la = 1 + gen() % 6, lb = 1 + gen() % 6;
+      for (std::size_t k = 0; k < la; ++k)
+        a[k] = gen();
+      for (std::size_t k = 0; k < lb; ++k)
+        b[k] = gen();
+      a[la - 1] >>= gen() % 64;
+      if (i % 5 == 0) // a large common factor
+      {
+        const big_int<2> c{gen(), gen() >> 1};
+        a = detail::first<6>(mul(detail::first<4>(a), c));
+        b = detail::first<6>(mul(detail::first<4>(b), c));
+      }
+      check_ext_gcd(a, b);
+      check_ext_gcd(b, a);
+      check_ext_gcd(a, a);
+    }
+  }
+
+  SECTION("consecutive Fibonacci numbers, all quotients 1")
+  {
+    big_int<6> f0{0}, f1{1};
+    for (int i = 0; i < 500; ++i)
+    {
+      f0 = std::exchange(f1, detail::first<6>(add(f0, f1)));
+      if (i % 25 == 0)
+      {
+        check_ext_gcd(f1, f0);
+        REQUIRE(gcd(f1, f0) == big_int<6>{1});
+      }
+    }
+  }
+}
+
+TEST_CASE("Runtime modular inverses modulo any number")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(7);
+
+  SECTION("even, odd and composite moduli")
+  {
+    for (int i = 0; i < 2000; ++i)
+    {
+      big_int<4> n{gen(), gen(), gen(), gen() >> (gen() % 64)}, x{gen(), gen(), gen(), gen()};
+      if (i % 2 == 0)
+        n[0] &= ~std::uint64_t{1} << (gen() % 8);
+      if (i % 3 == 0) // composite with a small factor
+        n = detail::first<4>(mul(detail::first<3>(n), big_int<1>{3 * 5 * 7}));
+      check_mod_inv(x, n);
+    }
+    check_mod_inv(big_int<1>{3}, big_int<1>{1ULL << 63});
+    check_mod_inv(big_int<2>{7, 0}, big_int<2>{0, 1});
+    check_mod_inv(big_int<1>{7}, big_int<1>{15});
+  }
+
+  SECTION("non-invertible residues throw")
+  {
+    REQUIRE_THROWS_AS(mod_inv(big_int<1>{6}, big_int<1>{15}), std::runtime_error);
+    REQUIRE_THROWS_AS(mod_inv(big_int<2>{6, 0}, big_int<2>{0, 2}), std::runtime_error);
+    REQUIRE_THROWS_AS(mod_inv(big_int<1>{0}, big_int<1>{7}), std::runtime_error);
+    REQUIRE(mod_inv(big_int<1>{5}, big_int<1>{1}) == big_int<1>{0});
+  }
+}
@@ -69,3 +69,82 @@ TEST_CASE("Test division invariant integer")
     static_assert(dee2 == n2);
   }
 }
+
+namespace
+{
+template<std::size_t N, typename T>
+void check_divider(const lam::cbn::big_int<N, T>& d, std::mt19937_64& gen)
+{
+  using namespace lam::cbn;
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  const invariant_divider<N, T> divider(d);
+
+  std::vector<big_int<N, T>> numerators{big_int<N, T>{}, d, subtract_ignore_carry(d, big_int<N, T>{1})};
+  big_int<N, T> max;
+  for (auto& limb : max)
+    limb = std::numeric_limits<T>::max();
+  numerators.push_back(max);
+  for (int i = 0; i < 50; ++i)
+  {
+    big_int<N, T> n;
+    for (auto& limb : n)
+      limb = static_cast<T>(distribution(gen));
+    numerators.push_back(shift_right(n, i % std::numeric_limits<T>::digits));
+  }
+
+  std::vector<big_int<N, T>> q(numerators.size()), r(numerators.size());
+  divider.divmod(numerators, q, r);
+  for (std::size_t i = 0; i < numerators.size(); ++i)
+  {
+    const auto expected = div(numerators[i], d);
+    REQUIRE(divider.quotient(numerators[i]) == expected.quotient);
+    REQUIRE(divider.remainder(numerators[i]) == detail::to_length<N>(expected.remainder));
+    REQUIRE(q[i] == expected.quotient);
+    REQUIRE(r[i] == detail::to_length<N>(expected.remainder));
+  }
+}
+} // namespace
+
+TEST_CASE("Division by a runtime invariant divisor")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  static_assert(invariant_divider<4>(detail::to_length<4>(to_big_int(12676500229401496703205653_Z)))
+                  .quotient(detail::to_length<4>(to_big_int(1237940039285380274899124054_Z))) == big_int<4>{97});
+
+  std::mt19937_64 gen(7);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+
+  SECTION("special divisors")
+  {
+    for (std::uint64_t d : {1ULL, 2ULL, 3ULL, 7ULL, 10ULL, 64ULL, 1ULL << 63, ~0ULL})
+      check_divider(big_int<4>{d}, gen);
+    check_divider(big_int<4>{0, 0, 1}, gen); // 2^128
+    check_divider(big_int<4>{1, 0, 1}, gen); // 2^128 + 1
+    check_divider(big_int<4>{~0ULL, ~0ULL, ~0ULL, ~0ULL}, gen); // 2^256 - 1
+    check_divider(big_int<4>{0, 0, 0, 1ULL << 63}, gen); // 2^255
+    check_divider(big_int<3, std::uint32_t>{1, 0, 0x80000000}, gen); // 2^95 + 1
+    REQUIRE_THROWS(invariant_divider<4>(big_int<4>{}));
+  }
+
+  SECTION("random divisors of every length")
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      big_int<4> d{};
+      for (int j = 0; j <= i % 4; ++j) // 1 to 4 limbs
+        d[j] = distribution(gen);
+      d = shift_right(d, i % 64);
+      d[0] |= (d == big_int<4>{});
+      check_divider(d, gen);
+    }
+  }
+
+  SECTION("spans of different sizes")
+  {
+    const invariant_divider<2> divider(big_int<2>{10});
+    std::vector<big_int<2>> n(3), q(2);
+    REQUIRE_THROWS(divider.quotient(n, q));
+  }
+}
@@ -0,0 +1,212 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<typename Packed>
+std::vector<typename Packed::lane_type> random_lanes(std::size_t n, std::mt19937_64& gen)
+{
+  using Lane = typename Packed::lane_type;
+  std::uniform_int_distribution<Lane> distribution(-Packed::q + 1, Packed::q - 1);
+  std::vector<Lane> v(n);
+  for (auto& x : v)
+    x = distribution(gen);
+  return v;
+}
+
+template<typename Packed, typename Zq>
+Zq to_field(typename Packed::lane_type x)
+{
+  using T = typename Zq::value_type;
+  const auto r = Packed::reduce(x);
+  return Zq{lam::cbn::big_int<1, T>{static_cast<T>(r)}};
+}
+
+// plain (non-Montgomery) products against ZqElement arithmetic
+template<typename Packed, typename Zq>
+void check_products(std::size_t n)
+{
+  using Lane = typename Packed::lane_type;
+  std::mt19937_64 gen(n);
+  auto a = random_lanes<Packed>(n, gen);
+  auto b = random_lanes<Packed>(n, gen);
+  if (n >= 3)
+  {
+    a[0] = 0;
+    a[1] = Packed::q - 1;
+    a[2] = -Packed::q + 1;
+    b[1] = std::numeric_limits<Lane>::max();
+    b[2] = std::numeric_limits<Lane>::min();
+  }
+
+  auto r = a;
+  Packed::reduce(std::span{r});
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    REQUIRE(r[i] >= 0);
+    REQUIRE(r[i] < Packed::q);
+    REQUIRE((r[i] - a[i]) % Packed::q == 0);
+  }
+
+  auto bm = b;
+  Packed::to_montgomery(std::span{bm});
+  std::vector<Lane> c(n);
+  Packed::pointwise_montgomery(std::span{c}, a, bm);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    REQUIRE(c[i] > -Packed::q);
+    REQUIRE(c[i] < Packed::q);
+    REQUIRE(to_field<Packed, Zq>(c[i]) == to_field<Packed, Zq>(a[i]) * to_field<Packed, Zq>(b[i]));
+  }
+}
+
+template<typename Packed, typename Zq>
+void check_matrix_vector(std::size_t rows, std::size_t cols, std::size_t n)
+{
+  using Lane = typename Packed::lane_type;
+  std::mt19937_64 gen(rows * cols + n);
+  auto matrix = random_lanes<Packed>(rows * cols * n, gen);
+  auto vector = random_lanes<Packed>(cols * n, gen);
+  Packed::to_montgomery(std::span{vector});
+
+  std::vector<Lane> out(rows * n);
+  Packed::matrix_vector_montgomery(out, matrix, vector, n);
+  for (std::size_t r = 0; r < rows; ++r)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      Zq expected{};
+      for (std::size_t c = 0; c < cols; ++c)
+        expected += to_field<Packed, Zq>(matrix[(r * cols + c) * n + i]) *
+                    to_field<Packed, Zq>(Packed::mul(vector[c * n + i], 1));
+      REQUIRE(out[r * n + i] >= 0);
+      REQUIRE(to_field<Packed, Zq>(out[r * n + i]) == expected);
+    }
+}
+
+template<typename Packed, int D>
+void check_compression(std::size_t n)
+{
+  using Lane = typename Packed::lane_type;
+  using U = typename Packed::unsigned_type;
+  std::vector<Lane> x(n);
+  for (std::size_t i = 0; i < n; ++i)
+    x[i] = static_cast<Lane>(i % Packed::q);
+
+  std::vector<U> y(n);
+  Packed::template compress<D>(y, x);
+  std::vector<Lane> z(n);
+  Packed::template decompress<D>(z, y);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    // round(2^D x / q) mod 2^D, in exact rational arithmetic
+    const auto num = (static_cast<std::uint64_t>(x[i]) << (D + 1)) + Packed::q;
+    REQUIRE(y[i] == (num / (2 * static_cast<std::uint64_t>(Packed::q))) % (std::uint64_t{1} << D));
+    REQUIRE(z[i] == Packed::template decompress<D>(y[i]));
+    // |decompress(compress(x)) - x| mod q is at most round(q / 2^(D+1))
+    const auto diff = std::abs(static_cast<std::int64_t>(z[i]) - x[i]);
+    REQUIRE(std::min<std::int64_t>(diff, Packed::q - diff) <= (Packed::q + (1 << D)) >> (D + 1));
+  }
+}
+} // namespace
+
+TEST_CASE("Packed small-modulus arithmetic, Kyber q = 3329 in 16-bit lanes")
+{
+  using namespace lam::cbn;
+  using Kyber = packed_zq<std::int16_t, 3329>;
+  using GF = ZqElement<std::uint32_t, 3329>;
+
+  static_assert(Kyber::qinv == -3327);
+  static_assert(Kyber::montgomery_one == 2285);
+  static_assert(Kyber::barrett_multiplier == 20158);
+  static_assert(Kyber::reduce(-32768) == 522 && Kyber::reduce(32767) == 2806);
+  static_assert(Kyber::mul(Kyber::to_montgomery(17), 1000) == 17 * 1000 % 3329);
+
+  for (std::size_t n : {0, 1, 5, 15, 16, 17, 256, 1000})
+    check_products<Kyber, GF>(n);
+
+  SECTION("every lane value reduces correctly")
+  {
+    std::vector<std::int16_t> a(65536);
+    std::iota(a.begin(), a.end(), std::int16_t{-32768});
+    auto r = a;
+    Kyber::reduce(std::span{r});
+    for (std::size_t i = 0; i < a.size(); ++i)
+      REQUIRE(r[i] == (a[i] % 3329 + 3329) % 3329);
+  }
+
+  SECTION("Kyber-768 matrix-vector product, and more terms than lazy_terms")
+  {
+    check_matrix_vector<Kyber, GF>(3, 3, 256);
+    check_matrix_vector<Kyber, GF>(2, 19, 21);
+  }
+
+  SECTION("compression")
+  {
+    check_compression<Kyber, 1>(3329 + 7);
+    check_compression<Kyber, 4>(3329 + 7);
+    check_compression<Kyber, 5>(3329);
+    check_compression<Kyber, 10>(3329 + 15);
+    check_compression<Kyber, 11>(3329);
+  }
+
+  SECTION("dimension mismatch")
+  {
+    std::vector<std::int16_t> out(256), matrix(3 * 256), vector(2 * 256);
+    REQUIRE_THROWS(Kyber::matrix_vector_montgomery(out, matrix, vector, 256));
+    REQUIRE_THROWS(Kyber::pointwise_acc_montgomery(out, matrix, vector));
+  }
+}
+
+TEST_CASE("Packed small-modulus arithmetic, Dilithium q = 8380417 in 32-bit lanes")
+{
+  using namespace lam::cbn;
+  using Dilithium = packed_zq<std::int32_t, 8380417>;
+  using GF = ZqElement<std::uint32_t, 8380417>;
+
+  static_assert(Dilithium::qinv == 58728449);
+  static_assert(Dilithium::montgomery_one == 4193792);
+  static_assert(Dilithium::reduce(std::numeric_limits<std::int32_t>::min()) == 8380417 - 2147483648 % 8380417);
+  static_assert(Dilithium::lazy_terms == 255);
+
+  for (std::size_t n : {0, 1, 7, 8, 9, 256, 1001})
+    check_products<Dilithium, GF>(n);
+
+  SECTION("reduction near the ends of the lane range")
+  {
+    std::vector<std::int32_t> a;
+    for (std::int64_t x = -2147483648; x < -2147483648 + 5000; ++x)
+      a.push_back(static_cast<std::int32_t>(x));
+    for (std::int64_t x = 2147483647 - 5000; x <= 2147483647; ++x)
+      a.push_back(static_cast<std::int32_t>(x));
+    for (std::int32_t x = -20000000; x < 20000000; x += 997)
+      a.push_back(x);
+    auto r = a;
+    Dilithium::reduce(std::span{r});
+    for (std::size_t i = 0; i < a.size(); ++i)
+      REQUIRE(r[i] == (a[i] % 8380417 + 8380417) % 8380417);
+  }
+
+  SECTION("Dilithium3 matrix-vector product")
+  {
+    check_matrix_vector<Dilithium, GF>(6, 5, 256);
+    check_matrix_vector<Dilithium, GF>(1, 300, 9);
+  }
+
+  SECTION("compression")
+  {
+    check_compression<Dilithium, 10>(20011);
+    check_compression<Dilithium, 13>(20011);
+  }
+}
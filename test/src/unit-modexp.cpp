@@ -0,0 +1,143 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> random_big_int(std::mt19937_64& gen)
+{
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  lam::cbn::big_int<N, T> x;
+  for (auto& limb : x)
+    limb = static_cast<T>(distribution(gen));
+  return x;
+}
+
+template<std::size_t N, typename T, std::size_t ExpBits, std::size_t W>
+void check_fixed_base(const lam::cbn::big_int<N, T>& m)
+{
+  using namespace lam::cbn;
+  constexpr std::size_t E = (ExpBits + std::numeric_limits<T>::digits - 1) / std::numeric_limits<T>::digits;
+
+  const montgomery_context<N, T> ctx(m);
+  std::mt19937_64 gen(ExpBits + W);
+  for (int k = 0; k < 5; ++k)
+  {
+    const auto g = detail::first<N>(div(random_big_int<N, T>(gen), m).remainder);
+    const fixed_base_exp<N, T, ExpBits, W> power(g, ctx);
+    REQUIRE(power(big_int<1, T>{}) == big_int<N, T>{1});
+    REQUIRE(power(big_int<1, T>{1}) == g);
+    for (int i = 0; i < 20; ++i)
+    {
+      auto e = random_big_int<E, T>(gen);
+      e = shift_right(e, E * std::numeric_limits<T>::digits - ExpBits); // ExpBits bits
+      REQUIRE(power(e) == mod_exp(g, e, ctx));
+    }
+    auto too_long = big_int<E + 1, T>{};
+    too_long[E] = 1;
+    REQUIRE_THROWS(power(too_long));
+  }
+}
+} // namespace
+
+TEST_CASE("Fixed-base exponentiation")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("compile-time table")
+  {
+    constexpr auto m = 14474011154664524427946373126085988481658748083205070504932198000989141205031_Z;
+    constexpr auto g = 1234567890123456789012345678901234567890_Z;
+    static constexpr fixed_base_exp<4, std::uint64_t, 64> power(g, m); // 16 x 15 entries
+    static_assert(decltype(power)::table_bytes == 16 * 15 * 32);
+    constexpr auto g4 = detail::to_length<4>(to_big_int(g));
+    static_assert(power(big_int<1>{65537}) == mod_exp(g4, big_int<1>{65537}, m));
+    REQUIRE(power(big_int<1>{0xfedcba9876543210}) == mod_exp(g4, big_int<1>{0xfedcba9876543210}, m));
+  }
+
+  SECTION("runtime tables")
+  {
+    const auto m256 = to_big_int(14474011154664524427946373126085988481658748083205070504932198000989141205031_Z);
+    check_fixed_base<4, std::uint64_t, 256, 4>(m256);
+    check_fixed_base<4, std::uint64_t, 130, 3>(m256);
+    check_fixed_base<4, std::uint64_t, 64, 1>(m256);
+    check_fixed_base<4, std::uint64_t, 160, 6>(m256);
+    check_fixed_base<3, std::uint32_t, 96, 5>(*big_int_from_string<3, std::uint32_t>("79228162514264337593543950319"));
+  }
+}
+
+TEST_CASE("Multi-exponentiation")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  constexpr auto modulus = 14474011154664524427946373126085988481658748083205070504932198000989141205031_Z;
+  const auto m = to_big_int(modulus);
+  const montgomery_context<4> ctx(m);
+  thread_pool pool(3);
+  std::mt19937_64 gen(3);
+
+  // 1, 2, 5 terms take Straus' method, 40 and 600 Pippenger's
+  for (std::size_t k : {0, 1, 2, 5, 40, 600})
+  {
+    std::vector<big_int<4>> bases, exps;
+    for (std::size_t i = 0; i < k; ++i)
+    {
+      bases.push_back(detail::first<4>(div(random_big_int<4, std::uint64_t>(gen), m).remainder));
+      exps.push_back(random_big_int<4, std::uint64_t>(gen));
+    }
+    if (k > 2)
+    {
+      exps[0] = big_int<4>{};
+      bases[1] = big_int<4>{};
+      exps[2] = big_int<4>{1};
+    }
+
+    auto expected = big_int<4>{1};
+    for (std::size_t i = 0; i < k; ++i)
+      expected = detail::first<4>(div(mul(expected, mod_exp(bases[i], exps[i], ctx)), m).remainder);
+
+    const std::span<const big_int<4>> e{exps};
+    REQUIRE(multi_exp(bases, e, ctx) == expected);
+    REQUIRE(multi_exp(bases, e, ctx, pool) == expected);
+    REQUIRE(multi_exp(bases, e, m) == expected);
+    REQUIRE(multi_exp(bases, e, modulus) == expected);
+    REQUIRE(multi_exp(bases, e, modulus, pool) == expected);
+  }
+
+  SECTION("short exponents, 32-bit limbs, and the size check")
+  {
+    const auto m96 = *big_int_from_string<3, std::uint32_t>("79228162514264337593543950319");
+    const montgomery_context<3, std::uint32_t> ctx96(m96);
+    const auto mulmod = [&](auto a, auto b) { return ctx96.mul(ctx96.mul(a, b), ctx96.r2); };
+    std::vector<big_int<3, std::uint32_t>> bases, prefix_products;
+    std::vector<big_int<1, std::uint32_t>> exps;
+    auto expected = big_int<3, std::uint32_t>{1};
+    for (std::uint32_t i = 0; i < 300; ++i)
+    {
+      bases.push_back(big_int<3, std::uint32_t>{i + 2, i, 7});
+      exps.push_back(big_int<1, std::uint32_t>{i * 2654435761U});
+      expected = mulmod(expected, mod_exp(bases[i], exps[i], ctx96));
+      prefix_products.push_back(expected);
+    }
+    const std::span<const big_int<1, std::uint32_t>> e{exps};
+    REQUIRE(multi_exp(bases, e, ctx96) == expected);
+    REQUIRE(multi_exp(std::span{bases}.first(3), e.first(3), ctx96) == prefix_products[2]);
+
+    exps.pop_back();
+    REQUIRE_THROWS(multi_exp(bases, std::span{std::as_const(exps)}, ctx96));
+  }
+}
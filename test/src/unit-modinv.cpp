@@ -62,3 +62,129 @@ TEST_CASE("New modinv test")
   REQUIRE(lam::cbn::mod_inv(a, p) ==
           lam::cbn::to_big_int(83174505189910067536517124096019359197644205712500122884473429251812128958118_Z));
 }
+
+namespace
+{
+template<std::size_t N, typename T>
+NTL::ZZ to_ZZ(const lam::cbn::big_int<N, T>& x)
+{
+  NTL::ZZ z;
+  for (std::size_t i = N; i-- > 0;)
+    z = (z << std::numeric_limits<T>::digits) + NTL::conv<NTL::ZZ>(static_cast<unsigned long>(x[i]));
+  return z;
+}
+
+// a two's complement big_int as a signed ZZ
+template<std::size_t N, typename T>
+NTL::ZZ signed_ZZ(const lam::cbn::big_int<N, T>& x)
+{
+  constexpr auto digits = std::numeric_limits<T>::digits;
+  const auto z = to_ZZ(x);
+  return x[N - 1] >> (digits - 1) ? z - (NTL::ZZ(1) << (N * digits)) : z;
+}
+
+template<std::size_t N, typename T>
+void check_ext_gcd(const lam::cbn::big_int<N, T>& a, const lam::cbn::big_int<N, T>& b)
+{
+  using namespace lam::cbn;
+  const auto [g, x, y] = ext_gcd(a, b);
+  const auto A = to_ZZ(a), B = to_ZZ(b), G = to_ZZ(g), X = signed_ZZ(x), Y = signed_ZZ(y);
+  REQUIRE(G == NTL::GCD(A, B));
+  REQUIRE(gcd(a, b) == g);
+  REQUIRE(A * X + B * Y == G);
+  if (A != 0 && B != 0 && A != G && B != G)
+  {
+    REQUIRE(2 * G * NTL::abs(X) <= B);
+    REQUIRE(2 * G * NTL::abs(Y) <= A);
+  }
+}
+} // namespace
+
+TEST_CASE("Runtime extended GCD")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(3);
+
+  SECTION("small operands")
+  {
+    for (std::uint64_t a = 0; a < 150; ++a)
+      for (std::uint64_t b = 0; b < 150; ++b)
+      {
+        check_ext_gcd(big_int<1>{a}, big_int<1>{b});
+        check_ext_gcd(big_int<2, std::uint32_t>{static_cast<std::uint32_t>(a)},
+                      big_int<2, std::uint32_t>{static_cast<std::uint32_t>(b)});
+      }
+  }
+
+  SECTION("random operands of any lengths")
+  {
+    for (int i = 0; i < 5000; ++i)
+    {
+      big_int<8> a{}, b{};
+      const auto la = 1 + gen() % 8, lb = 1 + gen() % 8;
+      for (std::size_t k = 0; k < la; ++k)
+        a[k] = gen();
+      for (std::size_t k = 0; k < lb; ++k)
+        b[k] = gen();
+      a[la - 1] >>= gen() % 64;
+      if (i % 5 == 0) // a large common factor
+      {
+        const big_int<2> c{gen(), gen() >> 1};
+        a = detail::first<8>(mul(detail::first<6>(a), c));
+        b = detail::first<8>(mul(detail::first<6>(b), c));
+      }
+      check_ext_gcd(a, b);
+      check_ext_gcd(b, a);
+      check_ext_gcd(a, a);
+
+      big_int<16, std::uint32_t> a32, b32;
+      for (std::size_t k = 0; k < 16; ++k)
+      {
+        a32[k] = static_cast<std::uint32_t>(a[k / 2] >> (32 * (k % 2)));
+        b32[k] = static_cast<std::uint32_t>(b[k / 2] >> (32 * (k % 2)));
+      }
+      check_ext_gcd(a32, b32);
+    }
+  }
+
+  SECTION("consecutive Fibonacci numbers, all quotients 1")
+  {
+    big_int<6> f0{0}, f1{1};
+    for (int i = 0; i < 500; ++i)
+    {
+      f0 = std::exchange(f1, detail::first<6>(add(f0, f1)));
+      if (i % 50 == 0)
+        check_ext_gcd(f1, f0);
+    }
+  }
+
+  SECTION("inverses modulo even and odd moduli")
+  {
+    for (int i = 0; i < 2000; ++i)
+    {
+      big_int<4> n{gen(), gen(), gen(), gen() >> (gen() % 64)}, x{gen(), gen(), gen(), gen()};
+      if (i % 2 == 0)
+        n[0] &= ~std::uint64_t{1} << (gen() % 8);
+      const auto N = to_ZZ(n), X = to_ZZ(x);
+      if (NTL::GCD(X, N) != 1)
+      {
+        REQUIRE_THROWS_AS(mod_inv(x, n), std::runtime_error);
+        continue;
+      }
+      const auto inverse = mod_inv(x, n);
+      REQUIRE(to_ZZ(inverse) < N);
+      REQUIRE(to_ZZ(inverse) == NTL::InvMod(X % N, N));
+    }
+    REQUIRE(mod_inv(big_int<1>{5}, big_int<1>{1}) == big_int<1>{0});
+    REQUIRE_THROWS_AS(mod_inv(big_int<2>{6, 0}, big_int<2>{0, 2}), std::runtime_error);
+  }
+
+  SECTION("Compile-Time Execution (constexpr)")
+  {
+    constexpr auto r = ext_gcd(big_int<2>{240}, big_int<2>{46});
+    static_assert(r.gcd == big_int<2>{2} && r.x == big_int<2>{~std::uint64_t{8}, ~std::uint64_t{0}} &&
+                  r.y == big_int<2>{47});
+    static_assert(mod_inv(big_int<1>{3}, big_int<1>{1ULL << 63}) * big_int<1>{3} % big_int<1>{1ULL << 63} ==
+                  big_int<1>{1});
+  }
+}
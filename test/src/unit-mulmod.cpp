@@ -0,0 +1,185 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<typename Zq>
+std::vector<Zq> random_elements(std::size_t n, std::mt19937_64& gen)
+{
+  using T = typename Zq::value_type;
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<Zq> v;
+  v.reserve(n);
+  for (std::size_t i = 0; i < n; ++i)
+    v.push_back(Zq{lam::cbn::big_int<1, T>{static_cast<T>(distribution(gen))}});
+  return v;
+}
+
+template<typename Zq>
+void check_against_operator_mul(std::size_t n)
+{
+  std::mt19937_64 gen(n);
+  auto a = random_elements<Zq>(n, gen);
+  auto b = random_elements<Zq>(n, gen);
+
+  // include the extreme residues 0, 1 and p - 1
+  if (n >= 3)
+  {
+    a[0] = Zq{0};
+    a[1] = Zq{1};
+    a[2] = -Zq{1};
+    b[2] = -Zq{1};
+  }
+
+  std::vector<Zq> c(n);
+  lam::cbn::mulmod(std::span{c}, a, b);
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(c[i] == a[i] * b[i]);
+}
+} // namespace
+
+TEST_CASE("Vectorized modular multiplication, word-size moduli")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("Kyber q = 3329, 32-bit limbs")
+  {
+    check_against_operator_mul<ZqElement<std::uint32_t, 3329>>(1000);
+  }
+
+  SECTION("2^32 - 5, 32-bit limbs")
+  {
+    check_against_operator_mul<ZqElement<std::uint32_t, 4294967291U>>(1003);
+  }
+
+  SECTION("2^50 - 27, 64-bit limbs (largest supported size)")
+  {
+    check_against_operator_mul<decltype(Zq(1125899906842597_Z))>(1001);
+  }
+
+  SECTION("lengths not divisible by the vector width")
+  {
+    for (std::size_t n = 0; n < 9; ++n)
+      check_against_operator_mul<decltype(Zq(998244353_Z))>(n);
+  }
+
+  SECTION("in-place")
+  {
+    using GF = decltype(Zq(1125899906842597_Z));
+    std::mt19937_64 gen(7);
+    auto a = random_elements<GF>(37, gen);
+    auto expected = a;
+    for (auto& x : expected)
+      x = x * x;
+    mulmod(std::span{a}, a, a);
+    REQUIRE(a == expected);
+  }
+}
+
+TEST_CASE("Goldilocks and 31-bit prime fields")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+  using Goldilocks = decltype(Zq(18446744069414584321_Z)); // 2^64 - 2^32 + 1
+  using M31 = ZqElement<std::uint32_t, 2147483647>;        // 2^31 - 1
+  using BabyBear = ZqElement<std::uint32_t, 2013265921>;   // 15 * 2^27 + 1
+
+  SECTION("scalar reduction")
+  {
+    // (p - 1)^2 = 1, and 2^96 = -1 mod the Goldilocks prime
+    static_assert(-Goldilocks{1} * -Goldilocks{1} == Goldilocks{1});
+    static_assert(Goldilocks{1ULL << 48} * Goldilocks{1ULL << 48} == -Goldilocks{1});
+    static_assert(Goldilocks{big_int<1>{0xFFFF'FFFF'FFFF'FFFFULL}} == Goldilocks{0xFFFF'FFFELL});
+    static_assert(-M31{1} * -M31{1} == M31{1});
+    static_assert(M31{1U << 16} * M31{1U << 16} == M31{2});
+    static_assert(M31{big_int<1, std::uint32_t>{0xFFFF'FFFFU}} == M31{1});
+
+    // against the generic two-limb reduction
+    using Wide = ZqElement<std::uint32_t, 1, 0xFFFF'FFFF>;
+    auto widen = [](Goldilocks x) {
+      return Wide{big_int<2, std::uint32_t>{static_cast<std::uint32_t>(x.data[0]),
+                                            static_cast<std::uint32_t>(x.data[0] >> 32)}};
+    };
+    std::mt19937_64 gen(1);
+    const auto a = random_elements<Goldilocks>(1000, gen), b = random_elements<Goldilocks>(1000, gen);
+    for (std::size_t i = 0; i < a.size(); ++i)
+      REQUIRE(widen(a[i] * b[i]) == widen(a[i]) * widen(b[i]));
+  }
+
+  SECTION("packed multiplication")
+  {
+    for (std::size_t n : {0, 1, 3, 4, 7, 8, 9, 15, 17, 1000})
+    {
+      check_against_operator_mul<Goldilocks>(n);
+      check_against_operator_mul<M31>(n);
+      check_against_operator_mul<BabyBear>(n);
+    }
+  }
+
+  SECTION("packed addition")
+  {
+    auto check = []<typename GF>(std::size_t n) {
+      std::mt19937_64 gen(n);
+      auto a = random_elements<GF>(n, gen), b = random_elements<GF>(n, gen);
+      if (n >= 2)
+        a[0] = b[0] = a[1] = -GF{1};
+      std::vector<GF> c(n);
+      addmod(std::span{c}, a, b);
+      for (std::size_t i = 0; i < n; ++i)
+        REQUIRE(c[i] == a[i] + b[i]);
+      addmod(std::span{a}, a, b);
+      REQUIRE(a == c);
+    };
+    for (std::size_t n : {0, 5, 8, 31, 1001})
+    {
+      check.operator()<Goldilocks>(n);
+      check.operator()<M31>(n);
+      check.operator()<BabyBear>(n);
+      check.operator()<ZqElement<std::uint64_t, 1000000007>>(n); // scalar path
+    }
+  }
+
+  SECTION("batch inversion")
+  {
+    auto check = []<typename GF>(std::size_t n) {
+      std::mt19937_64 gen(n);
+      auto a = random_elements<GF>(n, gen);
+      for (auto& x : a)
+        if (x == GF{})
+          x = GF{1};
+      std::vector<GF> inverses(n);
+      batch_inverse(std::span{inverses}, a);
+      for (std::size_t i = 0; i < n; ++i)
+        REQUIRE(inverses[i] * a[i] == GF{1});
+
+      batch_inverse(std::span{a}, a);
+      REQUIRE(a == inverses);
+      if (n > 0)
+      {
+        a[n / 2] = GF{};
+        REQUIRE_THROWS(batch_inverse(std::span{inverses}, a));
+      }
+    };
+    for (std::size_t n : {0, 1, 3, 8, 33, 100, 1000})
+    {
+      check.operator()<Goldilocks>(n);
+      check.operator()<M31>(n);
+      check.operator()<BabyBear>(n);
+      check.operator()<ZqElement<std::uint32_t, 998244353>>(n);
+      check.operator()<ZqElement<std::uint64_t, 1000000007>>(n);
+    }
+  }
+}
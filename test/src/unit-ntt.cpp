@@ -0,0 +1,256 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<typename Zq>
+std::vector<Zq> random_elements(std::size_t n, std::mt19937_64& gen)
+{
+  using T = typename Zq::value_type;
+  constexpr auto N = sizeof(Zq) / sizeof(T);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<Zq> v(n);
+  for (auto& x : v)
+  {
+    lam::cbn::big_int<N, T> limbs;
+    for (auto& limb : limbs)
+      limb = static_cast<T>(distribution(gen));
+    x = Zq{limbs};
+  }
+  return v;
+}
+
+template<typename Zq>
+std::vector<Zq> schoolbook(const std::vector<Zq>& a, const std::vector<Zq>& b)
+{
+  std::vector<Zq> c(a.size() + b.size() - 1);
+  for (std::size_t i = 0; i < a.size(); ++i)
+    for (std::size_t j = 0; j < b.size(); ++j)
+      c[i + j] += a[i] * b[j];
+  return c;
+}
+
+std::size_t bit_reverse(std::size_t x, std::size_t bits)
+{
+  std::size_t r = 0;
+  for (std::size_t i = 0; i < bits; ++i, x >>= 1)
+    r = (r << 1) | (x & 1);
+  return r;
+}
+
+template<typename Zq>
+void check_transforms(std::size_t max_log_size)
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(max_log_size);
+
+  for (std::size_t k = 0; k <= max_log_size; ++k)
+  {
+    const ntt_plan<Zq> plan(k);
+    const std::size_t n = plan.size();
+    auto a = random_elements<Zq>(n, gen);
+    if (n >= 2)
+      a[1] = -Zq{1};
+
+    // forward: evaluations at the powers of w in bit-reversed order
+    auto fa = a;
+    plan.forward(fa);
+    if (n <= 64)
+    {
+      const Zq w = plan.twiddles.size() > 1 ? plan.twiddles[n / 4].value() : (n == 2 ? -Zq{1} : Zq{1});
+      Zq wi{1};
+      for (std::size_t i = 0; i < n; ++i, wi *= w)
+      {
+        Zq eval{}, x{1};
+        for (std::size_t j = 0; j < n; ++j, x *= wi)
+          eval += a[j] * x;
+        REQUIRE(fa[bit_reverse(i, k)] == eval);
+      }
+    }
+
+    plan.inverse(fa);
+    REQUIRE(fa == a);
+  }
+}
+} // namespace
+
+TEST_CASE("Number-theoretic transform")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("Kyber q = 3329, 32-bit limbs (lazy butterflies)")
+  {
+    using GF = ZqElement<std::uint32_t, 3329>;
+    check_transforms<GF>(8);
+    REQUIRE(ntt_plan<GF>::max_log_size == 8);
+    REQUIRE_THROWS(ntt_plan<GF>(9));
+  }
+
+  SECTION("998244353, 32- and 64-bit limbs")
+  {
+    check_transforms<ZqElement<std::uint32_t, 998244353>>(12);
+    check_transforms<decltype(Zq(998244353_Z))>(12);
+  }
+
+  SECTION("Goldilocks 2^64 - 2^32 + 1 (reduced butterflies)")
+  {
+    check_transforms<decltype(Zq(18446744069414584321_Z))>(10);
+  }
+
+  SECTION("two-limb prime 2^40 * 16777251 + 1")
+  {
+    check_transforms<decltype(Zq(18446782556616523777_Z))>(8);
+  }
+
+  SECTION("BLS12-381 scalar field, four limbs")
+  {
+    using GF = decltype(Zq(52435875175126190479447740508185965837690552500527637822603658699938581184513_Z));
+    REQUIRE(ntt_plan<GF>::max_log_size == 32);
+    check_transforms<GF>(7);
+  }
+
+  SECTION("wrong input length")
+  {
+    using GF = decltype(Zq(998244353_Z));
+    const ntt_plan<GF> plan(4);
+    std::vector<GF> a(8);
+    REQUIRE_THROWS(plan.forward(a));
+  }
+}
+
+TEST_CASE("Number-theoretic transform, compile-time twiddles")
+{
+  using namespace lam::cbn;
+  using GF = ZqElement<std::uint32_t, 3329>;
+  using plan = static_ntt_plan<GF, 8>;
+
+  const ntt_plan<GF> runtime_plan(8);
+  for (std::size_t i = 0; i < plan::twiddles.size(); ++i)
+  {
+    REQUIRE(plan::twiddles[i].value() == runtime_plan.twiddles[i].value());
+    REQUIRE(plan::inverse_twiddles[i].value() == runtime_plan.inverse_twiddles[i].value());
+  }
+
+  // (1 + x) * (1 + x^2) = 1 + x + x^2 + x^3, as a constant expression
+  constexpr auto product = [] {
+    std::array<GF, 4> a{GF{1}, GF{1}, GF{0}, GF{0}}, b{GF{1}, GF{0}, GF{1}, GF{0}};
+    static_ntt_plan<GF, 2>::forward(a);
+    static_ntt_plan<GF, 2>::forward(b);
+    for (std::size_t i = 0; i < a.size(); ++i)
+      a[i] *= b[i];
+    static_ntt_plan<GF, 2>::inverse(a);
+    return a;
+  }();
+  static_assert(product == std::array<GF, 4>{GF{1}, GF{1}, GF{1}, GF{1}});
+
+  std::mt19937_64 gen(3);
+  auto a = random_elements<GF>(plan::size, gen);
+  auto fa = a, fb = a;
+  plan::forward(std::span<GF, plan::size>{fa});
+  runtime_plan.forward(fb);
+  REQUIRE(fa == fb);
+  plan::inverse(std::span<GF, plan::size>{fa});
+  REQUIRE(fa == a);
+
+  // the non-residue search ends for 8-bit limbs, with zero for a composite
+  static_assert(detail::ntt_constants<std::uint8_t, 193>::non_residue == 5);
+  static_assert(detail::ntt_constants<std::uint8_t, 65>::non_residue == 0);
+}
+
+TEST_CASE("Polynomial multiplication via NTT")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("998244353")
+  {
+    using GF = decltype(Zq(998244353_Z));
+    std::mt19937_64 gen(11);
+    for (auto [m, n] : {std::pair{1, 1}, {1, 7}, {5, 3}, {64, 64}, {100, 37}, {257, 300}})
+    {
+      auto a = random_elements<GF>(m, gen);
+      auto b = random_elements<GF>(n, gen);
+      REQUIRE(ntt_multiply(a, b) == schoolbook(a, b));
+    }
+    REQUIRE(ntt_multiply(std::vector<GF>{}, std::vector<GF>{GF{1}}).empty());
+  }
+
+  SECTION("Goldilocks")
+  {
+    using GF = decltype(Zq(18446744069414584321_Z));
+    std::mt19937_64 gen(12);
+    auto a = random_elements<GF>(200, gen);
+    auto b = random_elements<GF>(150, gen);
+    REQUIRE(ntt_multiply(a, b) == schoolbook(a, b));
+  }
+}
+
+TEST_CASE("Four-step number-theoretic transform")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  auto check = []<typename Zq>(std::size_t log_n, thread_pool& pool, std::size_t tile) {
+    std::mt19937_64 gen(log_n);
+    auto a = random_elements<Zq>(std::size_t{1} << log_n, gen);
+    auto expected = a;
+    ntt_plan<Zq>(log_n).forward(expected);
+
+    const four_step_ntt_plan<Zq> plan(log_n, tile);
+    auto fa = a;
+    plan.forward(fa, pool);
+    REQUIRE(fa == expected);
+    plan.inverse(fa, pool);
+    REQUIRE(fa == a);
+  };
+
+  thread_pool pool(3);
+  thread_pool single(1);
+
+  SECTION("998244353, lazy row and column transforms")
+  {
+    using GF = ZqElement<std::uint32_t, 998244353>;
+    for (std::size_t k = 0; k <= 13; ++k)
+    {
+      check.operator()<GF>(k, pool, 64);
+      check.operator()<GF>(k, single, 1);
+    }
+    check.operator()<GF>(11, pool, 5); // rounded down to a power of two
+  }
+
+  SECTION("BLS12-381 scalar field, four limbs")
+  {
+    using GF = decltype(Zq(52435875175126190479447740508185965837690552500527637822603658699938581184513_Z));
+    for (std::size_t k : {1, 6, 9})
+      check.operator()<GF>(k, pool, 8);
+  }
+
+  SECTION("default tiles, without a pool")
+  {
+    using GF = decltype(Zq(18446744069414584321_Z));
+    std::mt19937_64 gen(5);
+    auto a = random_elements<GF>(1024, gen);
+    auto expected = a;
+    ntt_plan<GF>(10).forward(expected);
+    const four_step_ntt_plan<GF> plan(10);
+    auto fa = a;
+    plan.forward(fa);
+    REQUIRE(fa == expected);
+    plan.inverse(fa);
+    REQUIRE(fa == a);
+    REQUIRE_THROWS(plan.forward(std::span{fa}.first(512)));
+  }
+}
@@ -0,0 +1,207 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<typename Zq>
+std::vector<Zq> random_elements(std::size_t n, std::mt19937_64& gen)
+{
+  using T = typename Zq::value_type;
+  constexpr auto N = sizeof(Zq) / sizeof(T);
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  std::vector<Zq> v(n);
+  for (auto& x : v)
+  {
+    lam::cbn::big_int<N, T> limbs;
+    for (auto& limb : limbs)
+      limb = static_cast<T>(distribution(gen));
+    x = Zq{limbs};
+  }
+  return v;
+}
+
+template<typename Zq>
+lam::cbn::polynomial<Zq> random_polynomial(std::size_t n, std::mt19937_64& gen)
+{
+  auto c = random_elements<Zq>(n, gen);
+  if (n > 0 && c.back() == Zq{})
+    c.back() = Zq{1};
+  return lam::cbn::polynomial<Zq>{c};
+}
+
+template<typename Zq>
+lam::cbn::polynomial<Zq> schoolbook(const lam::cbn::polynomial<Zq>& a, const lam::cbn::polynomial<Zq>& b)
+{
+  if (a.is_zero() || b.is_zero())
+    return {};
+  std::vector<Zq> c(a.coefficients().size() + b.coefficients().size() - 1);
+  for (std::size_t i = 0; i < a.coefficients().size(); ++i)
+    for (std::size_t j = 0; j < b.coefficients().size(); ++j)
+      c[i + j] += a[i] * b[j];
+  return lam::cbn::polynomial<Zq>{c};
+}
+
+template<typename Zq>
+void check_arithmetic(std::initializer_list<std::pair<std::size_t, std::size_t>> sizes)
+{
+  std::mt19937_64 gen(sizes.size());
+  for (auto [m, n] : sizes)
+  {
+    const auto a = random_polynomial<Zq>(m, gen);
+    const auto b = random_polynomial<Zq>(n, gen);
+    const auto c = a * b;
+    REQUIRE(c == schoolbook(a, b));
+    REQUIRE(c.degree() == (m && n ? static_cast<std::ptrdiff_t>(m + n - 2) : -1));
+
+    if (!b.is_zero())
+    {
+      const auto [q, r] = div(a, b);
+      REQUIRE(r.degree() < b.degree());
+      REQUIRE(q * b + r == a);
+      REQUIRE((c + r) / b == a);
+      REQUIRE((c + r) % b == r);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Polynomials, basic operations")
+{
+  using namespace lam::cbn;
+  using GF = ZqElement<std::uint32_t, 998244353>;
+  using P = polynomial<GF>;
+
+  const P zero, one{GF{1}};
+  REQUIRE(zero.degree() == -1);
+  REQUIRE(P{GF{0}, GF{0}} == zero);
+  REQUIRE(P{GF{1}, GF{2}, GF{0}}.degree() == 1);
+
+  const P f{GF{1}, GF{2}, GF{3}}; // 1 + 2x + 3x^2
+  const P g{GF{-1}, GF{1}};       // x - 1
+  REQUIRE(f + g == P{GF{0}, GF{3}, GF{3}});
+  REQUIRE(f - f == zero);
+  REQUIRE(-g == P{GF{1}, GF{-1}});
+  REQUIRE(f * g == P{GF{-1}, GF{-1}, GF{-1}, GF{3}});
+  REQUIRE(GF{2} * f == f + f);
+  REQUIRE(f * zero == zero);
+  REQUIRE(f[2] == GF{3});
+  REQUIRE(f[7] == GF{0});
+  REQUIRE(f.leading_coefficient() == GF{3});
+  REQUIRE(f.derivative() == P{GF{2}, GF{6}});
+  REQUIRE(one.derivative() == zero);
+
+  REQUIRE(f(GF{2}) == GF{17});
+  REQUIRE(f / g == P{GF{5}, GF{3}});
+  REQUIRE(f % g == P{GF{6}});
+  REQUIRE(g / f == zero);
+  REQUIRE(g % f == g);
+  REQUIRE_THROWS(f / zero);
+}
+
+TEST_CASE("Polynomials, multiplication and division across algorithms")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  // schoolbook (<= 32), Karatsuba or NTT, long and Newton division (> 64)
+  const auto sizes = {std::pair<std::size_t, std::size_t>{0, 5}, {1, 1}, {7, 3}, {33, 33}, {40, 100},
+                      {65, 65},                                  {200, 70}, {300, 129}, {513, 257}};
+
+  SECTION("998244353 (NTT)") { check_arithmetic<ZqElement<std::uint32_t, 998244353>>(sizes); }
+
+  SECTION("Goldilocks (NTT)") { check_arithmetic<decltype(Zq(18446744069414584321_Z))>(sizes); }
+
+  SECTION("1000000007 (Karatsuba, two-adicity 1)") { check_arithmetic<ZqElement<std::uint32_t, 1000000007>>(sizes); }
+
+  SECTION("2^127 - 1, two limbs (Karatsuba)")
+  {
+    check_arithmetic<decltype(Zq(170141183460469231731687303715884105727_Z))>({{100, 100}, {300, 129}});
+  }
+
+  SECTION("BLS12-381 scalar field, four limbs (NTT)")
+  {
+    using GF = decltype(Zq(52435875175126190479447740508185965837690552500527637822603658699938581184513_Z));
+    check_arithmetic<GF>({{70, 70}, {150, 66}});
+  }
+
+  SECTION("even modulus (multiplication only)")
+  {
+    using GF = ZqElement<std::uint32_t, 4096>;
+    std::mt19937_64 gen(1);
+    for (std::size_t n : {10, 50, 130})
+    {
+      auto a = random_polynomial<GF>(n, gen), b = random_polynomial<GF>(n + 3, gen);
+      REQUIRE(a * b == schoolbook(a, b));
+    }
+  }
+}
+
+TEST_CASE("Polynomials, evaluation and interpolation")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  auto check = []<typename GF>(std::size_t degree, std::size_t points) {
+    std::mt19937_64 gen(degree + points);
+    const auto f = random_polynomial<GF>(degree + 1, gen);
+    const auto x = random_elements<GF>(points, gen);
+
+    const auto values = f.evaluate(x);
+    for (std::size_t i = 0; i < points; ++i)
+    {
+      GF expected{}, xi{1};
+      for (auto c : f.coefficients())
+      {
+        expected += c * xi;
+        xi *= x[i];
+      }
+      REQUIRE(f(x[i]) == expected);
+      REQUIRE(values[i] == expected);
+    }
+
+    // degree + 1 points determine f
+    const auto xs = random_elements<GF>(degree + 1, gen);
+    REQUIRE(polynomial<GF>::interpolate(xs, f.evaluate(xs)) == f);
+  };
+
+  SECTION("998244353, lazy Horner")
+  {
+    using GF = ZqElement<std::uint32_t, 998244353>;
+    for (auto [d, n] : {std::pair<std::size_t, std::size_t>{0, 3}, {5, 40}, {100, 33}, {300, 200}, {64, 1000}})
+      check.operator()<GF>(d, n);
+  }
+
+  SECTION("Goldilocks")
+  {
+    using GF = decltype(Zq(18446744069414584321_Z));
+    check.operator()<GF>(150, 300);
+  }
+
+  SECTION("1000000007")
+  {
+    using GF = ZqElement<std::uint32_t, 1000000007>;
+    check.operator()<GF>(130, 77);
+  }
+
+  SECTION("errors")
+  {
+    using GF = ZqElement<std::uint32_t, 998244353>;
+    using P = polynomial<GF>;
+    std::vector<GF> x{GF{1}, GF{2}, GF{1}}, y{GF{3}, GF{4}, GF{5}};
+    REQUIRE_THROWS(P::interpolate(x, y));
+    REQUIRE_THROWS(P::interpolate(x, std::span{y}.first(2)));
+    REQUIRE(P::interpolate(std::span{x}.first(2), std::span{y}.first(2)) == P{GF{2}, GF{1}});
+  }
+}
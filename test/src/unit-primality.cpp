@@ -0,0 +1,226 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+std::vector<bool> sieve(std::size_t bound)
+{
+  std::vector<bool> prime(bound, true);
+  prime[0] = prime[1] = false;
+  for (std::size_t i = 2; i * i < bound; ++i)
+    if (prime[i])
+      for (std::size_t j = i * i; j < bound; j += i)
+        prime[j] = false;
+  return prime;
+}
+
+// Miller-Rabin to the prime bases up to 37, exact below 3.3 10^24
+template<std::size_t N, typename T>
+bool miller_rabin_reference(const lam::cbn::big_int<N, T>& n)
+{
+  using namespace lam::cbn;
+  const auto minus_one = subtract_ignore_carry(n, big_int<N, T>{1});
+  auto d = minus_one;
+  std::size_t s = 0;
+  while (d[0] % 2 == 0)
+  {
+    d = shift_right(d, 1);
+    ++s;
+  }
+  for (T a : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+  {
+    auto x = mod_exp(big_int<N, T>{a}, d, n);
+    bool pass = x == big_int<N, T>{1} || x == minus_one;
+    for (std::size_t i = 1; i < s && !pass; ++i)
+    {
+      x = detail::first<N>(div(mul(x, x), n).remainder);
+      pass = x == minus_one;
+    }
+    if (!pass)
+      return false;
+  }
+  return true;
+}
+
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> parse(std::string_view s)
+{ return *lam::cbn::big_int_from_string<N, T>(s); }
+} // namespace
+
+TEST_CASE("Probable primes agree with a sieve")
+{
+  using namespace lam::cbn;
+  const auto prime = sieve(1 << 16);
+  for (std::uint64_t n = 0; n < prime.size(); ++n)
+  {
+    REQUIRE(is_probable_prime(big_int<1>{n}) == prime[n]);
+    REQUIRE(is_probable_prime(big_int<2, std::uint32_t>{static_cast<std::uint32_t>(n)}) == prime[n]);
+  }
+}
+
+TEST_CASE("Baillie-PSW")
+{
+  using namespace lam::cbn;
+
+  SECTION("pseudoprimes of either half")
+  {
+    // strong pseudoprimes to base 2, Carmichael numbers, and the least
+    // strong pseudoprimes to all prime bases up to 37 and up to 41
+    for (std::uint64_t n : {2047ULL, 3277ULL, 4033ULL, 3215031751ULL, 3825123056546413051ULL, 561ULL, 41041ULL,
+                            825265ULL, 321197185ULL})
+      REQUIRE(!is_probable_prime(big_int<1>{n}));
+    REQUIRE(!is_probable_prime(parse<2, std::uint64_t>("318665857834031151167461")));
+    REQUIRE(!is_probable_prime(parse<2, std::uint64_t>("3317044064679887385961981")));
+
+    // the strong Lucas pseudoprimes below 10^5 pass the Lucas half alone
+    const std::set<std::uint64_t> lucas_pseudoprimes{5459,  5777,  10877, 16109, 18971, 22499,
+                                                     24569, 25199, 40309, 58519, 75077, 97439};
+    const auto prime = sieve(100000);
+    for (std::uint64_t n = 1031; n < prime.size(); n += 2)
+    {
+      if (detail::is_square(big_int<1>{n}))
+        continue;
+      const montgomery_context<1> ctx(big_int<1>{n});
+      REQUIRE(detail::strong_lucas(ctx) == (prime[n] || lucas_pseudoprimes.contains(n)));
+    }
+  }
+
+  SECTION("large primes and composites")
+  {
+    const auto m127 = parse<2, std::uint64_t>("170141183460469231731687303715884105727"); // 2^127 - 1
+    const auto m521 = parse<9, std::uint64_t>(
+      "68647976601306097149819007990813932172694353001433054093944634591855431833976560521225596406614545549772963113"
+      "91480858037121987999716643812574028291115057151"); // 2^521 - 1
+    const auto p25519 = parse<4, std::uint64_t>(
+      "57896044618658097711785492504343953926634992332820282019728792003956564819949"); // 2^255 - 19
+    REQUIRE(is_probable_prime(m127));
+    REQUIRE(is_probable_prime(m127, 20));
+    REQUIRE(is_probable_prime(m521));
+    REQUIRE(is_probable_prime(p25519));
+    REQUIRE(is_probable_prime(parse<4, std::uint32_t>("170141183460469231731687303715884105727")));
+
+    REQUIRE(!is_probable_prime(mul(m127, big_int<1>{2305843009213693951})));    // (2^127 - 1)(2^61 - 1)
+    REQUIRE(!is_probable_prime(mul(m127, m127), 5));                             // a square
+    REQUIRE(!is_probable_prime(detail::first<4>(add(p25519, big_int<1>{2})))); // 2^255 - 17
+    REQUIRE(detail::is_square(mul(p25519, p25519)));
+    REQUIRE(!detail::is_square(add(mul(p25519, p25519), big_int<1>{1})));
+  }
+
+  SECTION("random odd numbers against Miller-Rabin to 12 bases")
+  {
+    std::mt19937_64 gen(15);
+    for (int i = 0; i < 20000; ++i)
+    {
+      big_int<2> n{gen() | 1, gen() % (1 << 16)};
+      REQUIRE(is_probable_prime(n) == miller_rabin_reference(n));
+    }
+  }
+
+  SECTION("compile-time moduli")
+  {
+    static_assert(is_probable_prime(big_int<4>{0xffffffffffffffed, 0xffffffffffffffff, 0xffffffffffffffff,
+                                               0x7fffffffffffffff})); // 2^255 - 19
+    static_assert(!is_probable_prime(big_int<1>{3215031751}));
+  }
+}
+
+TEST_CASE("Prime generation")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(42);
+
+  SECTION("the sieve skips no prime")
+  {
+    const auto prime = sieve(1 << 18);
+    const std::atomic<bool> stop{false};
+    for (std::uint64_t x = (1 << 16) + 1; x < (1 << 17); x += 2 * 997)
+    {
+      auto next = x;
+      while (!prime[next])
+        next += 2;
+      REQUIRE(detail::sieve_search(big_int<1>{x}, 17, false, 0, stop) == big_int<1>{next});
+
+      auto next_safe = x;
+      while (!(prime[next_safe] && prime[2 * next_safe + 1]))
+        next_safe += 2;
+      const auto q = detail::sieve_search(big_int<1>{x}, 17, true, 0, stop);
+      if (next_safe < (1 << 17))
+        REQUIRE(q == big_int<1>{next_safe});
+      else
+        REQUIRE(!q);
+    }
+  }
+
+  SECTION("primes of the given length")
+  {
+    const auto prime = sieve(1 << 18);
+    std::set<std::uint64_t> seen;
+    for (int i = 0; i < 200; ++i)
+    {
+      const auto p = generate_prime<1>(gen, 18);
+      REQUIRE(detail::bit_length(p) == 18);
+      REQUIRE(prime[p[0]]);
+      seen.insert(p[0]);
+    }
+    REQUIRE(seen.size() > 150);
+
+    const auto p = generate_prime<4>(gen, 250, {.top_two_bits = true});
+    REQUIRE(detail::bit_length(p) == 250);
+    REQUIRE(p[3] >> 56 == 3);
+    REQUIRE(is_probable_prime(p, 20));
+
+    const auto q = generate_prime<3, std::uint32_t>(gen, 80);
+    REQUIRE(detail::bit_length(q) == 80);
+    REQUIRE(miller_rabin_reference(q));
+
+    // the same generator state gives the same prime without a pool
+    std::mt19937_64 a(7), b(7);
+    REQUIRE(generate_prime<8>(a, 512) == generate_prime<8>(b, 512));
+
+    REQUIRE_THROWS_AS(generate_prime<1>(gen, 16), std::runtime_error);
+    REQUIRE_THROWS_AS(generate_prime<1>(gen, 65), std::runtime_error);
+  }
+
+  SECTION("safe primes")
+  {
+    const auto prime = sieve(1 << 20);
+    for (int i = 0; i < 50; ++i)
+    {
+      const auto p = generate_safe_prime<1>(gen, 20);
+      REQUIRE(detail::bit_length(p) == 20);
+      REQUIRE(prime[p[0]]);
+      REQUIRE(prime[p[0] / 2]);
+    }
+
+    const auto p = generate_safe_prime<4>(gen, 256);
+    REQUIRE(detail::bit_length(p) == 256);
+    REQUIRE(is_probable_prime(p, 10));
+    REQUIRE(is_probable_prime(shift_right(p, 1), 10));
+  }
+
+  SECTION("on a thread pool")
+  {
+    thread_pool pool(3);
+    for (int i = 0; i < 4; ++i)
+    {
+      const auto p = generate_prime<8>(gen, 500, {.rounds = 2, .pool = &pool});
+      REQUIRE(detail::bit_length(p) == 500);
+      REQUIRE(is_probable_prime(p, 10));
+    }
+    const auto p = generate_safe_prime<2>(gen, 128, {.pool = &pool});
+    REQUIRE(detail::bit_length(p) == 128);
+    REQUIRE(is_probable_prime(shift_right(p, 1)));
+  }
+}
@@ -0,0 +1,120 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> random_big_int(std::mt19937_64& gen)
+{
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  lam::cbn::big_int<N, T> x;
+  for (auto& limb : x)
+    limb = static_cast<T>(distribution(gen));
+  return x;
+}
+
+// x mod M for the product M of the moduli
+template<typename T, T... Moduli, std::size_t N>
+lam::cbn::big_int<sizeof...(Moduli), T> reduce(lam::cbn::big_int<N, T> x)
+{
+  constexpr std::size_t K = sizeof...(Moduli);
+  lam::cbn::big_int<K, T> m{};
+  m[0] = 1;
+  for (T mk : {Moduli...})
+    m = lam::cbn::detail::first<K>(lam::cbn::short_mul(m, mk));
+  return lam::cbn::detail::first<K>(lam::cbn::div(x, m).remainder);
+}
+
+template<typename T, T... Moduli, T... Others>
+void check_rns(std::integer_sequence<T, Others...>)
+{
+  using namespace lam::cbn;
+  using R = rns_int<T, Moduli...>;
+  constexpr std::size_t K = sizeof...(Moduli);
+
+  std::mt19937_64 gen(K);
+  std::vector<R> xs, ys;
+  for (int i = 0; i < 300; ++i)
+  {
+    const auto a = random_big_int<K, T>(gen), b = random_big_int<K, T>(gen);
+    const R x{a}, y{b};
+    REQUIRE(x.reconstruct() == reduce<T, Moduli...>(a));
+    REQUIRE((x + y).reconstruct() == reduce<T, Moduli...>(add(a, b)));
+    REQUIRE((x * y).reconstruct() == reduce<T, Moduli...>(mul(a, b)));
+    REQUIRE(((x - y) + y) == x);
+    REQUIRE(R{(x * y).reconstruct()} == x * y);
+    REQUIRE(x.template base_extend<Others...>() == rns_int<T, Others...>{x.reconstruct()});
+    xs.push_back(x);
+    ys.push_back(y);
+  }
+
+  // the extreme values 0 and M - 1
+  REQUIRE(R{}.reconstruct() == big_int<K, T>{});
+  REQUIRE((-R{1}).mixed_radix() == std::array<T, K>{(Moduli - 1)...});
+  REQUIRE(R{(-R{1}).reconstruct()} + R{1} == R{});
+
+  // structure-of-arrays vectors agree with the element-wise operations
+  rns_vector<T, Moduli...> u{std::span<const R>{xs}}, v{std::span<const R>{ys}};
+  const auto sum = u + v, difference = u - v, product = u * v;
+  const auto extended = u.template base_extend<Others...>();
+  REQUIRE(u.template channel<0>().size() == xs.size());
+  for (std::size_t i = 0; i < xs.size(); ++i)
+  {
+    REQUIRE(u[i] == xs[i]);
+    REQUIRE(sum[i] == xs[i] + ys[i]);
+    REQUIRE(difference[i] == xs[i] - ys[i]);
+    REQUIRE(product[i] == xs[i] * ys[i]);
+    REQUIRE(extended[i] == xs[i].template base_extend<Others...>());
+  }
+  REQUIRE_THROWS(u += rns_vector<T, Moduli...>(xs.size() + 1));
+}
+} // namespace
+
+TEST_CASE("Residue number system, compile time")
+{
+  using namespace lam::cbn;
+  using R = rns_int<std::uint32_t, 3, 5, 7>; // M = 105
+
+  static_assert(R{23}.get<0>() == ZqElement<std::uint32_t, 3>{2});
+  static_assert(R{23}.reconstruct() == big_int<3, std::uint32_t>{23});
+  static_assert((R{23} * R{4}).reconstruct() == big_int<3, std::uint32_t>{92});
+  static_assert((R{23} * R{5}).reconstruct() == big_int<3, std::uint32_t>{10}); // 115 mod 105
+  static_assert((R{2} - R{3}).reconstruct() == big_int<3, std::uint32_t>{104});
+  static_assert(R{104}.mixed_radix() == std::array<std::uint32_t, 3>{2, 4, 6}); // 2 + 3 * 4 + 15 * 6
+  static_assert(R{23}.base_extend<11, 2, 3>() == rns_int<std::uint32_t, 11, 2, 3>{1, 1, 2});
+}
+
+TEST_CASE("Residue number system, arithmetic, reconstruction and base extension")
+{
+  using namespace lam::cbn;
+
+  SECTION("three 30-bit NTT primes (packed kernels)")
+  {
+    check_rns<std::uint32_t, 998244353, 469762049, 167772161>(
+      std::integer_sequence<std::uint32_t, 754974721, 2147483647, 3>{});
+  }
+
+  SECTION("64-bit moduli: Goldilocks, 2^61 - 1, 2^50 - 27, 2^64 - 59")
+  {
+    check_rns<std::uint64_t, 18446744069414584321ULL, 2305843009213693951ULL, 1125899906842597ULL,
+              18446744073709551557ULL>(std::integer_sequence<std::uint64_t, 4611686018427387847ULL, 65537>{});
+  }
+
+  SECTION("a single modulus, and composite moduli")
+  {
+    check_rns<std::uint64_t, 1000000007>(std::integer_sequence<std::uint64_t, 998244353, 12>{});
+    check_rns<std::uint32_t, 4096, 3125, 2187, 4294967291U>(std::integer_sequence<std::uint32_t, 1000000007>{});
+  }
+}
@@ -178,6 +178,31 @@ TEST_CASE("Modular square root - Tonelli-Shanks")
     auto result = sqrt(four);
     REQUIRE_FALSE(result.has_value());
   }
+
+  SECTION("8-bit limbs")
+  {
+    // 251 and 65521 are found prime by trial division, 2^24 - 17 by Baillie-PSW
+    auto check = [](auto field, long p) {
+      using GF = decltype(field);
+      for (long i = 1; i < 251; ++i) // GF{i} takes a single limb
+      {
+        const GF x{i};
+        const auto root = sqrt(x * x);
+        REQUIRE(root.has_value());
+        REQUIRE(*root * *root == x * x);
+
+        GF euler{1}, base = x; // x^((p - 1) / 2)
+        for (long e = (p - 1) / 2; e > 0; e >>= 1, base = base * base)
+          if (e & 1)
+            euler = euler * base;
+        REQUIRE(sqrt(x).has_value() == (euler == GF{1}));
+      }
+    };
+    check(ZqElement<std::uint8_t, 251>{}, 251);
+    check(ZqElement<std::uint8_t, 0xf1, 0xff>{}, 65521);
+    check(ZqElement<std::uint8_t, 0xef, 0xff, 0xff>{}, 16777199);
+    REQUIRE_FALSE(sqrt(ZqElement<std::uint8_t, 0xfb, 0xff, 0xff>{4}).has_value()); // 2^24 - 5 = 11 101 15101
+  }
 }
 
 // Helper for fuzzing
@@ -351,6 +376,13 @@ TEST_CASE("is_quadratic_residue")
     REQUIRE_FALSE(sqrt(GF17{5}).has_value());
     REQUIRE_FALSE(sqrt(GF17{6}).has_value());
   }
+
+  SECTION("GF(2)")
+  {
+    using GF2 = decltype(Zq(2_Z));
+    REQUIRE(is_quadratic_residue(GF2{0}));
+    REQUIRE(is_quadratic_residue(GF2{1}));
+  }
 }
 
 TEST_CASE("Cube root")
@@ -419,6 +451,28 @@ TEST_CASE("Cube root")
     static_assert(res_amm.has_value());
     static_assert(res_amm->data == six.data);
   }
+
+  SECTION("Exhaustive for 9 | p - 1")
+  {
+    // p = 19, 37 (S = 2) and 109 (S = 3): the AMM steps meet both cube roots of unity
+    auto check = [](auto field, long p) {
+      using GF = decltype(field);
+      std::set<long> cubes;
+      for (long i = 0; i < p; ++i)
+        cubes.insert(i * i * i % p);
+      for (long i = 0; i < p; ++i)
+      {
+        const GF n{i};
+        const auto root = cbrt(n);
+        REQUIRE(root.has_value() == cubes.contains(i));
+        if (root)
+          REQUIRE(*root * *root * *root == n);
+      }
+    };
+    check(Zq(19_Z), 19);
+    check(Zq(37_Z), 37);
+    check(Zq(109_Z), 109);
+  }
 }
 
 TEST_CASE("Comprehensive Primes Matrix (Sqrt + Cbrt)", "[roots]")
@@ -566,3 +620,253 @@ TEST_CASE("Comprehensive Primes Matrix (Sqrt + Cbrt)", "[roots]")
     static_assert(c_cbrt->data == to_big_int(1_Z));
   }
 }
+
+TEST_CASE("Precomputed field constants")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("Tonelli-Shanks constants")
+  {
+    using traits = detail::sqrt_traits<std::uint64_t, 65537>;
+    static_assert(traits::prime && traits::S == 16 && traits::Q == big_int<1>{1});
+    static_assert(traits::z == big_int<1>{3});
+    static_assert(traits::c_powers[16] == ZqElement<std::uint64_t, 65537>{1});
+    static_assert(traits::c_powers[15] == ZqElement<std::uint64_t, 65537>{-1});
+
+    static_assert(!detail::sqrt_traits<std::uint64_t, 1729>::prime);
+    static_assert(detail::sqrt_traits<std::uint64_t, 7>::S == 1);
+  }
+
+  SECTION("BLS12-381 scalar field: S = 32")
+  {
+    constexpr auto r_seq = 52435875175126190479447740508185965837690552500527637822603658699938581184513_Z;
+    using GF = decltype(Zq(r_seq));
+    static_assert(detail::sqrt_traits<std::uint64_t, 0xffffffff00000001, 0x53bda402fffe5bfe, 0x3339d80809a1d805,
+                                      0x73eda753299d7d48>::S == 32);
+
+    std::mt19937_64 gen(3);
+    std::size_t residues = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+      const GF x{big_int<4>{gen(), gen(), gen(), gen() >> 2}};
+      const auto square = x * x;
+      const auto root = sqrt(square);
+      REQUIRE(root.has_value());
+      REQUIRE((*root == x || *root == -x));
+
+      const GF y{big_int<4>{gen(), gen(), gen(), gen() >> 2}};
+      const auto y_root = sqrt(y);
+      REQUIRE(y_root.has_value() == is_quadratic_residue(y));
+      if (y_root)
+        REQUIRE(*y_root * *y_root == y);
+      residues += y_root.has_value();
+
+      const auto cube = x * x * x;
+      const auto cube_root = cbrt(cube);
+      REQUIRE(cube_root.has_value());
+      REQUIRE(*cube_root * *cube_root * *cube_root == cube);
+    }
+    REQUIRE(residues > 30);
+    REQUIRE(residues < 70);
+  }
+
+  SECTION("p mod 3 of a two-limb modulus")
+  {
+    // p = 2^64 + 13 = 2 (mod 3), while its low limb is 1 (mod 3)
+    using GF = decltype(Zq(18446744073709551629_Z));
+    static_assert(detail::cbrt_traits<std::uint64_t, 13, 1>::p_mod_3 == 2);
+
+    for (long v : {2, 3, 1000, 123456789})
+    {
+      const GF x{v};
+      const auto root = cbrt(x * x * x);
+      REQUIRE(root.has_value());
+      REQUIRE(*root == x); // the unique cube root
+    }
+  }
+}
+
+TEST_CASE("Constant-time square roots")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  SECTION("all elements of small fields")
+  {
+    auto check = [](auto field) {
+      using GF = decltype(field);
+      const auto p = to_big_int(extract_modulus(GF{}))[0];
+      for (std::uint64_t n = 0; n < p; ++n)
+      {
+        const GF x{static_cast<long>(n)};
+        const auto root = sqrt_ct(x);
+        REQUIRE(root.has_value() == is_quadratic_residue(x));
+        if (root)
+          REQUIRE(*root * *root == x);
+
+        const GF v{static_cast<long>(n % (p - 1) + 1)}; // nonzero
+        const auto ratio = sqrt_ratio(x, v);
+        REQUIRE(ratio.has_value() == is_quadratic_residue(x * v));
+        if (ratio)
+          REQUIRE(*ratio * *ratio * v == x);
+        if (n > 0)
+          REQUIRE(inv_sqrt(x).has_value() == root.has_value());
+      }
+    };
+    check(Zq(3_Z));
+    check(Zq(7_Z));     // S = 1
+    check(Zq(13_Z));    // S = 2
+    check(Zq(17_Z));    // S = 4
+    check(Zq(97_Z));    // S = 5
+    check(Zq(193_Z));   // S = 6: a short last chunk
+    check(Zq(7681_Z));  // S = 9
+    check(Zq(65537_Z)); // S = 16
+  }
+
+  SECTION("large fields")
+  {
+    auto check = [](auto field, int count) {
+      using GF = decltype(field);
+      std::mt19937_64 gen(5);
+      auto random = [&] { return GF{big_int<4>{gen(), gen(), gen(), gen() >> 2}}; };
+      for (int i = 0; i < count; ++i)
+      {
+        const auto x = random(), v = random();
+        const auto root = sqrt_ct(x * x);
+        REQUIRE(root.has_value());
+        REQUIRE((*root == x || *root == -x));
+        REQUIRE(sqrt_ct(v).has_value() == is_quadratic_residue(v));
+
+        const auto ratio = sqrt_ratio(x * x * v, v * v * v); // x / v
+        REQUIRE(ratio.has_value());
+        REQUIRE(*ratio * *ratio * v * v == x * x);
+        REQUIRE(sqrt_ratio(x, v).has_value() == is_quadratic_residue(x * v));
+
+        const auto inverse = inv_sqrt(v * v);
+        REQUIRE(inverse.has_value());
+        REQUIRE(*inverse * *inverse * v * v == GF{1});
+      }
+    };
+    check(Zq(115792089237316195423570985008687907853269984665640564039457584007908834671663_Z), 20); // S = 1
+    check(Zq(57896044618658097711785492504343953926634992332820282019728792003956564819949_Z), 20);  // S = 2
+    check(Zq(52435875175126190479447740508185965837690552500527637822603658699938581184513_Z), 50);  // S = 32
+  }
+
+  SECTION("Goldilocks: p = 2^64 - 2^32 + 1, S = 32")
+  {
+    using GF = ZqElement<std::uint64_t, 0xffffffff00000001>;
+    std::mt19937_64 gen(6);
+    for (int i = 0; i < 1000; ++i)
+    {
+      const GF x{big_int<1>{gen() >> 1}};
+      const auto root = sqrt_ct(x * x);
+      REQUIRE(root.has_value());
+      REQUIRE((*root == x || *root == -x));
+      REQUIRE(sqrt_ct(x).has_value() == is_quadratic_residue(x));
+    }
+  }
+
+  SECTION("Compile-Time Execution (constexpr)")
+  {
+    using GF = decltype(Zq(65537_Z));
+    constexpr auto root = sqrt_ct(GF{9});
+    static_assert(root.has_value() && (*root == GF{3} || *root == GF{-3}));
+    static_assert(!sqrt_ct(GF{3}).has_value());
+    static_assert(*inv_sqrt(GF{4}) * *inv_sqrt(GF{4}) * GF{4} == GF{1});
+  }
+}
+
+TEST_CASE("Legendre and Jacobi symbols")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+  std::mt19937_64 gen(7);
+
+  SECTION("small values against the word algorithm")
+  {
+    for (std::uint64_t k = 1; k < 300; k += 2)
+      for (std::uint64_t a = 0; a < 700; ++a)
+      {
+        const int j = detail::jacobi_word(a, k);
+        REQUIRE(jacobi(big_int<1>{a}, big_int<1>{k}) == j);
+        REQUIRE(jacobi_ct(big_int<1>{a}, big_int<1>{k}) == j);
+        REQUIRE(jacobi(big_int<2, std::uint32_t>{static_cast<std::uint32_t>(a)},
+                       big_int<1, std::uint32_t>{static_cast<std::uint32_t>(k)}) == j);
+      }
+    for (int i = 0; i < 100000; ++i)
+    {
+      const std::uint64_t k = (gen() >> (gen() % 64)) | 1;
+      const std::uint64_t a = i % 3 == 0 ? k + gen() % 5 - 2 : gen() >> (gen() % 64);
+      REQUIRE(jacobi(big_int<1>{a}, big_int<1>{k}) == detail::jacobi_word(a, k));
+      REQUIRE(jacobi_ct(big_int<1>{a}, big_int<1>{k}) == detail::jacobi_word(a, k));
+    }
+    REQUIRE_THROWS_AS(jacobi(big_int<1>{3}, big_int<1>{4}), std::runtime_error);
+  }
+
+  SECTION("multi-limb values")
+  {
+    for (int i = 0; i < 5000; ++i)
+    {
+      big_int<4> n{gen(), gen(), gen(), gen() >> (gen() % 64)};
+      n[0] |= 1;
+      const auto D = static_cast<std::int64_t>(2 * (gen() % 500) + 1);
+      REQUIRE(jacobi(big_int<1>{static_cast<std::uint64_t>(D)}, n) == detail::jacobi_small(D, n));
+
+      // multiplicative in the numerator, and constant time alike for
+      // numerators near the denominator or far below it
+      const big_int<4> a{gen(), gen(), gen(), gen()}, b{gen(), gen() >> (gen() % 64), 0, 0};
+      REQUIRE(jacobi(div(mul(a, b), n).remainder, n) == jacobi(a, n) * jacobi(b, n));
+      const auto near = detail::first<4>(add(n, big_int<1>{gen() % 8}));
+      for (const auto& x : {a, b, near, shift_right(n, 1 + gen() % 8)})
+        REQUIRE(jacobi_ct(x, n) == jacobi(x, n));
+
+      // 32-, 16- and 8-bit limbs
+      auto narrow = [&]<typename U>(U) {
+        constexpr std::size_t ratio = 64 / std::numeric_limits<U>::digits;
+        big_int<4 * ratio, U> a_narrow, n_narrow;
+        for (std::size_t k = 0; k < 4 * ratio; ++k)
+        {
+          a_narrow[k] = static_cast<U>(a[k / ratio] >> (64 / ratio * (k % ratio)));
+          n_narrow[k] = static_cast<U>(n[k / ratio] >> (64 / ratio * (k % ratio)));
+        }
+        REQUIRE(jacobi(a_narrow, n_narrow) == jacobi(a, n));
+        REQUIRE(jacobi_ct(a_narrow, n_narrow) == jacobi(a, n));
+      };
+      narrow(std::uint32_t{});
+      narrow(std::uint16_t{});
+      narrow(std::uint8_t{});
+    }
+  }
+
+  SECTION("Legendre symbols against Euler's criterion")
+  {
+    auto check = [&](auto field, int count) {
+      using GF = decltype(field);
+      const auto p = to_big_int(extract_modulus(GF{}));
+      const auto euler_exp = shift_right(subtract_ignore_carry(p, big_int<p.size()>{1}), 1);
+      for (int i = 0; i < count; ++i)
+      {
+        const GF x{big_int<4>{gen(), gen(), gen(), gen() >> 2}};
+        const auto euler = mod_exp(x.data, euler_exp, extract_modulus(GF{}));
+        const int expected = euler == big_int<p.size()>{1} ? 1 : -1;
+        REQUIRE(legendre(x) == expected);
+        REQUIRE(legendre_ct(x) == expected);
+        REQUIRE(legendre(x * x) == 1);
+        REQUIRE(is_quadratic_residue(x) == (expected == 1));
+      }
+      REQUIRE(legendre(GF{}) == 0);
+      REQUIRE(legendre_ct(GF{}) == 0);
+    };
+    check(Zq(115792089237316195423570985008687907853269984665640564039457584007908834671663_Z), 500);
+    check(Zq(52435875175126190479447740508185965837690552500527637822603658699938581184513_Z), 500);
+    check(Zq(18446744069414584321_Z), 500);
+  }
+
+  SECTION("Compile-Time Execution (constexpr)")
+  {
+    using GF = decltype(Zq(65537_Z));
+    static_assert(legendre(GF{9}) == 1 && legendre(GF{3}) == -1 && legendre_ct(GF{3}) == -1);
+    static_assert(jacobi(big_int<1>{2}, big_int<1>{15}) == 1 && jacobi(big_int<1>{6}, big_int<1>{15}) == 0);
+  }
+}
@@ -0,0 +1,165 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+namespace
+{
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> parse(std::string_view s)
+{ return *lam::cbn::big_int_from_string<N, T>(s); }
+
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> random_below(const lam::cbn::big_int<N, T>& n, std::mt19937_64& gen)
+{
+  std::uniform_int_distribution<std::uint64_t> distribution(0);
+  lam::cbn::big_int<N, T> x;
+  for (auto& limb : x)
+    limb = static_cast<T>(distribution(gen));
+  return lam::cbn::detail::first<N>(lam::cbn::div(x, n).remainder);
+}
+
+// the private-key operation against the full-size mod_exp, and the public exponent 65537
+template<std::size_t N, typename T, bool ConstantTime>
+void check_key(std::string_view p, std::string_view q, std::string_view d)
+{
+  using namespace lam::cbn;
+  const rsa_private_key<N, T, ConstantTime> key(parse<N / 2, T>(p), parse<N / 2, T>(q), parse<N, T>(d));
+  const auto n = key.modulus();
+  const auto e = big_int<1, T>{65537};
+  thread_pool pool(2);
+
+  std::mt19937_64 gen(N);
+  std::vector<big_int<N, T>> inputs{big_int<N, T>{}, big_int<N, T>{1},
+                                    subtract_ignore_carry(n, big_int<N, T>{1})}; // 0, 1, n - 1
+  for (int i = 0; i < 20; ++i)
+    inputs.push_back(random_below(n, gen));
+
+  for (const auto& x : inputs)
+  {
+    const auto signature = key.apply(x);
+    REQUIRE(signature == mod_exp(x, parse<N, T>(d), n));
+    REQUIRE(mod_exp(signature, e, n) == x);
+    REQUIRE(key.apply(x, pool) == signature);
+  }
+
+  REQUIRE_THROWS(key.apply(n));
+}
+} // namespace
+
+TEST_CASE("RSA-CRT private-key operation")
+{
+  // 1024-bit modulus (p > q), and with the primes swapped (q > p)
+  constexpr std::string_view p1024 = "1143543852453795101909637078384006189629583053213590981060824676156594274159350417928"
+                                     "8090366002493861875126480243846442187280153012768926450005471941929939";
+  constexpr std::string_view q1024 = "1048427921592354695680065373471565384756658861891806428682591465514579507136904415461"
+                                     "7485059050437605429232664457492049838759381485539716831300394419517759";
+  constexpr std::string_view d1024 =
+    "463950042340398105108450038272238477195050226920652765906439248659918510254740201491233753595872668978319681104203"
+    "577919085655824970150727458632625618693345842714299932795014497546215411542460177316034623740426843245361204467046"
+    "54281896470602695195435003878280171337304959873433996155322309877058499531235485";
+
+  SECTION("constant time")
+  {
+    check_key<16, std::uint64_t, true>(p1024, q1024, d1024);
+    check_key<16, std::uint64_t, true>(q1024, p1024, d1024);
+  }
+
+  SECTION("variable time") { check_key<16, std::uint64_t, false>(p1024, q1024, d1024); }
+
+  SECTION("128-bit modulus, 32-bit limbs")
+  {
+    check_key<4, std::uint32_t, true>("15750464385269855119", "13864264761931335673",
+                                      "24287983518892180511619098717102125121");
+    check_key<4, std::uint32_t, false>("13864264761931335673", "15750464385269855119",
+                                       "24287983518892180511619098717102125121");
+  }
+}
+
+TEST_CASE("Exponentiation with a Montgomery context")
+{
+  using namespace lam::cbn;
+  using namespace lam::cbn::literals;
+
+  const auto m = to_big_int(14474011154664524427946373126085988481658748083205070504932198000989141205031_Z);
+  const montgomery_context<4> ctx(m);
+  std::mt19937_64 gen(1);
+  for (int i = 0; i < 50; ++i)
+  {
+    const auto a = random_below(m, gen);
+    const auto e = random_below(m, gen);
+    const auto expected = mod_exp(a, e, m);
+    REQUIRE(mod_exp(a, e, ctx) == expected);
+    REQUIRE(mod_exp_ct(a, e, ctx) == expected);
+    const auto small = big_int<1>{static_cast<std::uint64_t>(i)};
+    REQUIRE(mod_exp(a, small, ctx) == mod_exp(a, small, m));
+  }
+  REQUIRE(mod_exp(big_int<4>{5}, big_int<4>{}, ctx) == big_int<4>{1});
+  REQUIRE(mod_exp_ct(big_int<4>{}, big_int<4>{}, ctx) == big_int<4>{1});
+  REQUIRE_THROWS(montgomery_context<4>(big_int<4>{6}));
+}
+
+TEST_CASE("Interleaved batch exponentiation")
+{
+  using namespace lam::cbn;
+
+  const auto check = []<std::size_t Lanes, std::size_t N, typename T>(const big_int<N, T>& m, std::size_t count) {
+    const montgomery_context<N, T> ctx(m);
+    std::mt19937_64 gen(count);
+    std::vector<big_int<N, T>> bases, exps, out(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      bases.push_back(random_below(m, gen));
+      exps.push_back(random_below(m, gen));
+    }
+    if (count > 2)
+    {
+      exps[0] = big_int<N, T>{}; // x^0, and a short exponent among full-size ones
+      exps[1] = big_int<N, T>{3};
+      bases[2] = big_int<N, T>{};
+    }
+
+    mod_exp_batch<Lanes>(out, bases, std::span<const big_int<N, T>>{exps}, ctx);
+    for (std::size_t i = 0; i < count; ++i)
+      REQUIRE(out[i] == mod_exp(bases[i], exps[i], ctx));
+    mod_exp_batch<Lanes>(out, bases, std::span<const big_int<N, T>>{exps}, m);
+    for (std::size_t i = 0; i < count; ++i)
+      REQUIRE(out[i] == mod_exp(bases[i], exps[i], m));
+  };
+
+  const auto m256 = parse<4, std::uint64_t>(
+    "14474011154664524427946373126085988481658748083205070504932198000989141205031");
+  const auto m96 = parse<3, std::uint32_t>("79228162514264337593543950319");
+
+  SECTION("2, 4 and 8 lanes, with a remainder")
+  {
+    check.operator()<2>(m256, 7);
+    check.operator()<4>(m256, 11);
+    check.operator()<8>(m256, 19);
+    check.operator()<4>(m96, 13);
+    check.operator()<8>(m96, 3);
+  }
+
+  SECTION("short exponents, and the size check")
+  {
+    const montgomery_context<4> ctx(m256);
+    std::vector<big_int<4>> bases(5, big_int<4>{2}), out(5);
+    const std::vector<big_int<1>> exps{big_int<1>{0}, big_int<1>{1}, big_int<1>{10}, big_int<1>{64}, big_int<1>{255}};
+    mod_exp_batch<4>(out, bases, std::span{exps}, ctx);
+    for (std::size_t i = 0; i < out.size(); ++i)
+      REQUIRE(out[i] == mod_exp(bases[i], exps[i], ctx));
+
+    out.pop_back();
+    REQUIRE_THROWS(mod_exp_batch<4>(out, bases, std::span{exps}, ctx));
+  }
+}
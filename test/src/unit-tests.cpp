@@ -293,6 +293,178 @@ TEST_CASE("short div")
   REQUIRE(quotrem.remainder[0] == 936917791);
 }
 
+namespace
+{
+// limbs biased towards the corner cases of the quotient estimates
+template<std::size_t N, typename T>
+lam::cbn::big_int<N, T> random_limbs(std::mt19937_64& gen, std::size_t length)
+{
+  const T special[] = {0, 1, std::numeric_limits<T>::max(), static_cast<T>(T{1} << (std::numeric_limits<T>::digits - 1)),
+                       static_cast<T>(std::numeric_limits<T>::max() - 1)};
+  lam::cbn::big_int<N, T> x{};
+  for (std::size_t i = 0; i < length; ++i)
+    x[i] = gen() % 2 ? special[gen() % 5] : static_cast<T>(gen());
+  return x;
+}
+
+template<std::size_t M, std::size_t N, typename T>
+void check_division(std::mt19937_64& gen)
+{
+  using namespace lam::cbn;
+  for (int trial = 0; trial < 2000; ++trial)
+  {
+    const auto u = random_limbs<M, T>(gen, 1 + gen() % M);
+    auto v = random_limbs<N, T>(gen, 1 + gen() % N);
+    v[0] |= (v == big_int<N, T>{});
+
+    const auto [q, r] = div(u, v);
+    REQUIRE(r < v);
+    REQUIRE(add(mul(q, v), r) == detail::to_length<M + N + 1>(u));
+    const auto expected = detail::div_hw(u, v);
+    REQUIRE(q == expected.quotient);
+    REQUIRE(r == expected.remainder);
+    if (v[0] != 0)
+    {
+      const auto [qs, rs] = short_div(u, v[0]);
+      REQUIRE(rs[0] < v[0]);
+      REQUIRE(add(mul(qs, big_int<1, T>{v[0]}), rs) == detail::to_length<M + 2>(u));
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Division at runtime agrees with constant evaluation")
+{
+  std::mt19937_64 gen(11);
+  check_division<6, 3, std::uint64_t>(gen);
+  check_division<8, 8, std::uint64_t>(gen);
+  check_division<5, 2, std::uint32_t>(gen);
+  check_division<9, 4, std::uint32_t>(gen);
+}
+
+TEST_CASE("Karatsuba multiplication")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(12);
+  const auto check = [&]<std::size_t N>() {
+    for (int trial = 0; trial < 20; ++trial)
+    {
+      const auto a = random_limbs<N + 1, std::uint64_t>(gen, N + 1), b = random_limbs<N, std::uint64_t>(gen, N);
+      const auto expected = mul(a, b);
+      big_int<2 * N + 1, std::uint64_t> r;
+      std::array<std::uint64_t, detail::mul_karatsuba_scratch(N)> scratch;
+      detail::mul_limbs(&r[0], &a[0], N, &b[0], N, scratch.data());
+      REQUIRE(detail::first<2 * N>(r) == mul(detail::first<N>(a), b));
+      detail::mul_limbs(&r[0], &b[0], N, &a[0], N + 1, scratch.data());
+      REQUIRE(r == expected);
+    }
+  };
+  check.operator()<24>();
+  check.operator()<47>();
+  check.operator()<100>();
+}
+
+TEST_CASE("Burnikel-Ziegler division")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(13);
+  const auto check = [&]<std::size_t M, std::size_t N, typename T>() {
+    for (int trial = 0; trial < 50; ++trial)
+    {
+      const auto u = random_limbs<M, T>(gen, M - gen() % 8);
+      auto v = random_limbs<N, T>(gen, N - gen() % (N - detail::burnikel_ziegler_threshold + 1));
+      v[0] |= 1;
+
+      const auto [q, r] = div(u, v);
+      REQUIRE(r < v);
+      REQUIRE(add(mul(q, v), r) == detail::to_length<M + N + 1>(u));
+      const auto expected = detail::div_hw(u, v);
+      REQUIRE(q == expected.quotient);
+      REQUIRE(r == expected.remainder);
+    }
+  };
+  check.operator()<96, 48, std::uint64_t>();
+  check.operator()<200, 64, std::uint64_t>();
+  check.operator()<256, 100, std::uint32_t>();
+
+  // the base case with {u + n, n} > v, where a lower limb of u is below that of v
+  {
+    constexpr std::uint64_t top = std::uint64_t{1} << 63;
+    big_int<8> u{5, 6, 7, 8, 0, 1, 4, top};
+    const big_int<4> v{1, 2, 3, top};
+    const auto expected = detail::div_hw(u, v);
+    big_int<4> q{};
+    std::array<std::uint64_t, 4 + detail::mul_karatsuba_scratch(4)> tp{};
+    const auto inv = detail::reciprocal_3by2(v[3], v[2]);
+    const auto qh = detail::div_burnikel_ziegler(&q[0], &u[0], &v[0], 4, inv, tp.data());
+    REQUIRE(qh == expected.quotient[4]);
+    REQUIRE(q == detail::first<4>(expected.quotient));
+    REQUIRE(detail::first<4>(u) == expected.remainder);
+  }
+
+  // the recursion under constant evaluation (div itself takes div_hw there):
+  // u = B^100 - 1 by v = B^48 - 3
+  static constexpr auto u = [] {
+    big_int<100> x;
+    x.fill(std::numeric_limits<std::uint64_t>::max());
+    return x;
+  }();
+  static constexpr auto v = [] {
+    big_int<48> x;
+    x.fill(std::numeric_limits<std::uint64_t>::max());
+    x[0] -= 2;
+    return x;
+  }();
+  static constexpr auto qr = detail::div_reciprocal(u, v);
+  static_assert(qr.quotient == div(u, v).quotient && qr.remainder == div(u, v).remainder);
+  static_assert(add(mul(qr.quotient, v), qr.remainder) == detail::to_length<149>(u));
+}
+
+TEST_CASE("Exact division")
+{
+  using namespace lam::cbn;
+  std::mt19937_64 gen(14);
+  const auto check = [&]<std::size_t M, std::size_t N, typename T>() {
+    for (int trial = 0; trial < 500; ++trial)
+    {
+      auto v = random_limbs<N, T>(gen, 1 + gen() % N);
+      v[0] |= (v == big_int<N, T>{});
+      const auto q = random_limbs<M - N, T>(gen, 1 + gen() % (M - N));
+      const auto u = detail::first<M>(mul(q, v));
+
+      const auto inverse = detail::inverse_mod(detail::first<M>(detail::to_length<M + N>(v)));
+      if (v[0] % 2 != 0)
+        REQUIRE(partial_mul<M>(inverse, v) == detail::to_length<M>(big_int<1, T>{1}));
+      REQUIRE(divexact(u, v) == detail::to_length<M>(q));
+
+      const T d = v[0];
+      const auto ud = detail::first<M>(mul(detail::first<M - 1>(detail::to_length<M>(q)), big_int<1, T>{d}));
+      REQUIRE(divexact_by_limb(ud, d) == div(ud, big_int<1, T>{d}).quotient);
+    }
+  };
+  check.operator()<4, 2, std::uint64_t>();
+  check.operator()<9, 4, std::uint64_t>();
+  check.operator()<7, 3, std::uint32_t>();
+
+  // the borrow tells divisibility, and a divisor known at compile time
+  using namespace lam::cbn::literals;
+  const auto u = to_big_int(
+    2546193657439406857145703733197100653115821362759049094285169490950072104599327444985080274250381382002767612954309419020468048131511471554113629756428140_Z);
+  REQUIRE(divexact(u, 3_Z) == div(u, big_int<1>{3}).quotient);
+  REQUIRE(divexact(u, 6_Z) == div(u, big_int<1>{6}).quotient);
+  constexpr auto v = 1361129467683753853853498429727072845823_Z;
+  const auto uv = mul(u, to_big_int(v));
+  REQUIRE(divexact(uv, v) == detail::to_length<11>(u));
+  REQUIRE(divexact(detail::first<11>(shift_left(uv, 5)), 43556142965880123323311949751266331066336_Z) ==
+          detail::to_length<11>(u));
+  REQUIRE(detail::factor_out_val(u, std::uint64_t{3}).second == 1);
+  const auto [d, s] = detail::factor_out_val(mul(u, big_int<1>{81}), std::uint64_t{3});
+  REQUIRE(d == div(u, big_int<1>{3}).quotient);
+  REQUIRE(s == 5);
+  REQUIRE(detail::factor_out_val(big_int<2>{96, 0}, std::uint64_t{2}) == std::pair{big_int<2>{3, 0}, std::size_t{5}});
+  REQUIRE(divexact_by_limb(big_int<2>{96, 1}, std::uint64_t{0}) == big_int<2>{});
+}
+
 TEST_CASE("gcd")
 {
   using namespace lam::cbn;
@@ -350,6 +522,44 @@ TEST_CASE("modular inverse")
   static_assert(lam::cbn::mod_inv(x, m) == ans, "fail");
 }
 
+TEST_CASE("modular inverse on integer sequences")
+{
+  using lam::cbn::big_int;
+  using std::integer_sequence;
+
+  // canonical residues, also where the Bezout coefficient is negative
+  static_assert(lam::cbn::mod_inv(integer_sequence<std::uint32_t, 3>{}, integer_sequence<std::uint32_t, 5>{}) ==
+                big_int<1, std::uint32_t>{2});
+  static_assert(lam::cbn::mod_inv(integer_sequence<std::uint32_t, 3>{}, integer_sequence<std::uint32_t, 7>{}) ==
+                big_int<1, std::uint32_t>{5});
+  static_assert(lam::cbn::mod_inv(integer_sequence<std::uint64_t, 2>{},
+                                  integer_sequence<std::uint64_t, 18446744073709551557ULL>{}) ==
+                big_int<1>{9223372036854775779ULL});
+  static_assert(lam::cbn::mod_inv(integer_sequence<std::uint64_t, 18446744073709551556ULL>{},
+                                  integer_sequence<std::uint64_t, 18446744073709551557ULL>{}) ==
+                big_int<1>{18446744073709551556ULL});
+
+  // the inverse modulo 2^64 of Montgomery multiplication
+  static_assert(lam::cbn::mod_inv(integer_sequence<std::uint64_t, 7>{}, integer_sequence<std::uint64_t, 0, 1>{})[0] *
+                  7 ==
+                1);
+
+  // full-length operands of 4 limbs: 2^256 - 189 and a residue
+  using p = integer_sequence<std::uint64_t, 0xffffffffffffff43, 0xffffffffffffffff, 0xffffffffffffffff,
+                             0xffffffffffffffff>;
+  using x = integer_sequence<std::uint64_t, 0x04177d4c76273644, 0x52049c1114cf98e8, 0x898cc51701b839a2,
+                             0x121fb54442d18469>;
+  constexpr auto inverse = lam::cbn::mod_inv(x{}, p{});
+  static_assert(lam::cbn::div(lam::cbn::mul(inverse, lam::cbn::to_big_int(x{})), lam::cbn::to_big_int(p{})).remainder ==
+                big_int<1>{1});
+
+  // the gcd and the coefficients x and y of a x + b y = gcd, also for a = b
+  static_assert(lam::cbn::ext_gcd(integer_sequence<std::uint32_t, 240>{}, integer_sequence<std::uint32_t, 46>{}) ==
+                big_int<3, std::uint32_t>{2, static_cast<std::uint32_t>(-9), 47});
+  static_assert(lam::cbn::ext_gcd(integer_sequence<std::uint32_t, 6>{}, integer_sequence<std::uint32_t, 6>{}) ==
+                big_int<3, std::uint32_t>{6, 1, 0});
+}
+
 TEST_CASE("arrayconv")
 {
 
@@ -0,0 +1,48 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#include "catch.hpp"
+
+import std;
+import lam.ctbignum;
+
+TEST_CASE("Thread pool")
+{
+  using namespace lam::cbn;
+
+  for (std::size_t threads : {1, 2, 5})
+  {
+    thread_pool pool(threads);
+    REQUIRE(pool.size() == threads);
+
+    // repeated loops of varying length on the same pool
+    for (std::size_t count : {0, 1, 3, 100, 1000})
+    {
+      std::vector<int> hits(count);
+      pool.parallel_for(count, [&](std::size_t i) { ++hits[i]; });
+      REQUIRE(std::ranges::all_of(hits, [](int h) { return h == 1; }));
+    }
+
+    std::atomic<std::size_t> calls{0};
+    REQUIRE_THROWS_AS(pool.parallel_for(64,
+                                        [&](std::size_t i) {
+                                          ++calls;
+                                          if (i == 7)
+                                            throw std::runtime_error("task failed");
+                                        }),
+                      std::runtime_error);
+    REQUIRE(calls >= 8); // later calls may be skipped
+
+    // the pool stays usable after an exception
+    std::atomic<std::size_t> sum{0};
+    pool.parallel_for(10, [&](std::size_t i) { sum += i; });
+    REQUIRE(sum == 45);
+  }
+}